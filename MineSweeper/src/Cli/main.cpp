@@ -0,0 +1,287 @@
+/*
+minesweeper-cli是不依赖Qt的命令行工具，直接使用核心规则引擎Board
+它没有窗口、事件循环和信号/槽，可以在没有显示器的服务器上批量生成棋盘、模拟对局和测量性能
+
+用法：
+  minesweeper-cli play     <rows> <cols> <mines> [--seed N] [--safe-area | --no-guess]
+  minesweeper-cli generate <rows> <cols> <mines> [--seed N] [--safe-area | --no-guess] [--first ROW COL] [--count N]
+  minesweeper-cli bench    <rows> <cols> <mines> [--seed N] [--safe-area | --no-guess] [--games N]
+  minesweeper-cli resume   <file>
+
+play中输入s FILE保存当前这一局，之后可以用resume继续；只有输入s时才会写文件，继续玩读出的一局不会改变存档
+generate指定--count时不再打印棋盘，而是连续生成N个棋盘（种子依次加一）并统计生成速度，可用于测量不需要猜的棋盘的生成吞吐量
+任何命令都可以加上--trace FILE：执行期间记录布雷、连锁翻开等热点路径的跟踪事件，结束时写成Chrome的trace-event JSON
+*/
+
+#include <chrono>  //包含计时工具，用于bench命令
+#include <cstdio>  //包含printf等格式化输出函数
+#include <cstdlib>  //包含strtoll等字符串转换函数
+#include <cstring>  //包含strcmp
+#include <iostream>  //包含标准输入，用于play命令读取玩家的操作
+#include <random>  //包含std::random_device，用于在未指定种子时生成随机种子
+#include <sstream>  //包含字符串流，用于解析玩家输入的一行命令
+#include <string>
+#include "../Core/Board.h"
+#include "../Core/Profiler.h"  //--trace使用的跟踪事件记录
+
+namespace {
+
+//命令行中解析出的所有参数
+struct Options {
+    int rows = 0;
+    int cols = 0;
+    int mines = 0;
+    std::uint64_t seed = 0;
+    bool hasSeed = false;  //是否通过--seed指定了种子，未指定时使用随机种子
+    FirstClickPolicy policy = FirstClickPolicy::SafeCell;
+    int firstRow = -1;  //generate命令的首次点击位置，未指定时点击棋盘中央
+    int firstCol = -1;
+    long long games = 1000;  //bench命令模拟的对局数
+    long long count = 0;  //generate命令连续生成的棋盘数，0表示只生成一个并打印出来
+    std::string tracePath;  //--trace指定的跟踪文件路径，为空表示不记录
+};
+
+void printUsage() {
+    std::fprintf(stderr,
+                 "usage:\n"
+                 "  minesweeper-cli play     <rows> <cols> <mines> [--seed N] [--safe-area | --no-guess]\n"
+                 "  minesweeper-cli generate <rows> <cols> <mines> [--seed N] [--safe-area | --no-guess] [--first ROW COL] [--count N]\n"
+                 "  minesweeper-cli bench    <rows> <cols> <mines> [--seed N] [--safe-area | --no-guess] [--games N]\n"
+                 "  minesweeper-cli resume   <file>\n"
+                 "any command also accepts --trace FILE\n");
+}
+
+//解析命令名之后的所有参数，参数不合法时返回false
+bool parseOptions(int argc, char *argv[], Options &options) {
+    if (argc < 5) return false;
+    options.rows = std::atoi(argv[2]);
+    options.cols = std::atoi(argv[3]);
+    options.mines = std::atoi(argv[4]);
+    if (options.rows <= 0 || options.cols <= 0 || options.mines < 0) return false;
+
+    for (int i = 5; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            options.seed = std::strtoull(argv[++i], nullptr, 10);
+            options.hasSeed = true;
+        } else if (std::strcmp(argv[i], "--safe-area") == 0) {
+            options.policy = FirstClickPolicy::SafeArea;
+        } else if (std::strcmp(argv[i], "--no-guess") == 0) {
+            options.policy = FirstClickPolicy::NoGuess;
+        } else if (std::strcmp(argv[i], "--first") == 0 && i + 2 < argc) {
+            options.firstRow = std::atoi(argv[++i]);
+            options.firstCol = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--games") == 0 && i + 1 < argc) {
+            options.games = std::strtoll(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--count") == 0 && i + 1 < argc) {
+            options.count = std::strtoll(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            options.tracePath = argv[++i];
+        } else {
+            return false;
+        }
+    }
+    if (!options.hasSeed) {
+        std::random_device device;
+        options.seed = (std::uint64_t(device()) << 32) | device();
+    }
+    return true;
+}
+
+//把一个格子转换成显示用的字符；revealAll为true时显示所有地雷和数字（用于generate命令和游戏结束后）
+char cellChar(const Cell &cell, bool revealAll) {
+    if (cell.isFlagged && !revealAll) return 'F';
+    if (!cell.isRevealed && !revealAll) return '#';
+    if (cell.isMine) return '*';
+    return cell.adjacentMines == 0 ? '.' : char('0' + cell.adjacentMines);
+}
+
+void printBoard(const Board &board, bool revealAll) {
+    std::string line;
+    for (int r = 0; r < board.getRows(); ++r) {
+        line.clear();
+        for (int c = 0; c < board.getCols(); ++c) {
+            line += cellChar(board.getCell(r, c), revealAll);
+        }
+        std::puts(line.c_str());
+    }
+}
+
+//在终端中交互地玩board上的这一局，直到分出胜负或者玩家退出
+int playLoop(Board &board) {
+    std::printf("commands: r ROW COL (reveal), f ROW COL (flag), c ROW COL (chord), s FILE (save), q (quit)\n");
+
+    std::string line;
+    while (board.getGameState() == GameState::Ready || board.getGameState() == GameState::Playing) {
+        printBoard(board, false);
+        std::printf("mines left: %d> ", board.getMineCount() - board.getFlagCount());
+        std::fflush(stdout);
+        if (!std::getline(std::cin, line)) break;
+
+        std::istringstream input(line);
+        char command = 0;
+        input >> command;
+        if (command == 's') {
+            //保存的是此刻的这一局，之后的操作不会写进文件，直到再次保存
+            std::string path;
+            input >> path;
+            std::printf(board.saveToFile(path) ? "saved to %s\n" : "cannot save to %s\n", path.c_str());
+            continue;
+        }
+        int row = -1, col = -1;
+        input >> row >> col;
+        switch (command) {
+            case 'r': board.revealCell(row, col); break;
+            case 'f': board.flagCell(row, col); break;
+            case 'c': board.chordCell(row, col); break;
+            case 'q': return 0;
+            default: std::printf("unknown command\n"); break;
+        }
+    }
+
+    if (board.getGameState() == GameState::Won || board.getGameState() == GameState::Lost) {
+        printBoard(board, true);
+        std::printf(board.getGameState() == GameState::Won ? "You Win! :)\n" : "You Lost! :(\n");
+    }
+    return 0;
+}
+
+//要求了--no-guess、Board却因为棋盘太大或太密退回了SafeArea时提示一次（见NoGuessGenerator::canGenerate）
+void noteNoGuessFallback(const Options &options, const Board &board) {
+    if (options.policy == FirstClickPolicy::NoGuess && board.getFirstClickPolicy() != FirstClickPolicy::NoGuess) {
+        std::fprintf(stderr, "--no-guess is not available for %dx%d with %d mines, using --safe-area\n", options.rows,
+                     options.cols, options.mines);
+    }
+}
+
+//play命令：开始新的一局并在终端中交互地玩
+int play(const Options &options) {
+    Board board;
+    board.startGame(options.rows, options.cols, options.mines, options.seed, options.policy);
+    noteNoGuessFallback(options, board);
+    std::printf("seed %llu\n", static_cast<unsigned long long>(board.getSeed()));
+    return playLoop(board);
+}
+
+//resume命令：读取存档继续玩（存档文件被映射进来直接作为棋盘的存储，读档的耗时与棋盘大小无关，之后的操作不会修改文件）
+int resume(const char *path) {
+    Board board;
+    if (!board.loadFromFile(path)) {
+        std::fprintf(stderr, "cannot load %s\n", path);
+        return 1;
+    }
+    return playLoop(board);
+}
+
+//generate命令：在首次点击后生成棋盘，并把所有地雷和数字打印出来；指定--count时改为批量生成并统计速度
+int generate(const Options &options) {
+    Board board;
+    const int row = options.firstRow >= 0 ? options.firstRow : options.rows / 2;
+    const int col = options.firstCol >= 0 ? options.firstCol : options.cols / 2;
+    if (options.count > 0) {
+        long long uncertified = 0;  //没能找到不需要猜的布局、退回普通布局的棋盘数
+        const auto start = std::chrono::steady_clock::now();
+        for (long long i = 0; i < options.count; ++i) {
+            board.startGame(options.rows, options.cols, options.mines, options.seed + std::uint64_t(i), options.policy);
+            board.revealCell(row, col);
+            uncertified += board.getFirstClickPolicy() == FirstClickPolicy::NoGuess && !board.isLayoutCertified();
+        }
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        noteNoGuessFallback(options, board);
+        std::printf("boards %lld  time %.3f s  %.1f boards/s\n", options.count, seconds,
+                    seconds > 0 ? double(options.count) / seconds : 0.0);
+        if (board.getFirstClickPolicy() == FirstClickPolicy::NoGuess) {
+            std::printf("uncertified %lld\n", uncertified);
+        }
+        return 0;
+    }
+
+    board.startGame(options.rows, options.cols, options.mines, options.seed, options.policy);
+    noteNoGuessFallback(options, board);
+    board.revealCell(row, col);
+
+    std::printf("seed %llu first %d %d mines %d\n", static_cast<unsigned long long>(board.getSeed()), row, col,
+                board.getMineCount());
+    if (board.getFirstClickPolicy() == FirstClickPolicy::NoGuess) {
+        //生成器在尝试上限内没能找到不需要猜的布局时退回了普通布局，这个棋盘可能需要猜
+        std::printf(board.isLayoutCertified() ? "certified no-guess\n" : "uncertified: this board may need guessing\n");
+    }
+    printBoard(board, true);
+    return 0;
+}
+
+//bench命令：连续模拟大量对局并统计吞吐量
+//每局从棋盘中央开始，之后随机翻开未翻开的格子直到分出胜负；所有对局复用同一个Board对象，稳定状态下不分配内存
+int bench(const Options &options) {
+    Board board;
+    Board::RandomEngine player(options.seed ^ 0x5DEECE66Dull);  //模拟玩家选点使用的随机数生成器，与布雷互相独立
+    const std::uint32_t cellCount = std::uint32_t(options.rows) * std::uint32_t(options.cols);
+    long long wins = 0;
+    long long moves = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (long long game = 0; game < options.games; ++game) {
+        board.startGame(options.rows, options.cols, options.mines, options.seed + std::uint64_t(game), options.policy);
+        board.revealCell(options.rows / 2, options.cols / 2);
+        ++moves;
+        while (board.getGameState() == GameState::Playing) {
+            const std::uint32_t cell = boundedRandom(player, cellCount);
+            //已翻开的格子会被revealCell直接忽略，不计入步数
+            moves += board.revealCell(int(cell / options.cols), int(cell % options.cols));
+        }
+        wins += board.getGameState() == GameState::Won;
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    noteNoGuessFallback(options, board);
+
+    std::printf("games %lld  wins %lld (%.2f%%)  moves %lld\n", options.games, wins,
+                options.games > 0 ? 100.0 * double(wins) / double(options.games) : 0.0, moves);
+    std::printf("time %.3f s  %.0f games/s  %.0f moves/s\n", seconds,
+                seconds > 0 ? double(options.games) / seconds : 0.0, seconds > 0 ? double(moves) / seconds : 0.0);
+    return 0;
+}
+
+//执行一个命令；tracePath不为空时在执行期间记录跟踪事件，结束后写成Chrome的trace-event JSON
+template <typename Run>
+int runTraced(const std::string &tracePath, Run run) {
+    if (!tracePath.empty()) Profiler::instance().setTracing(true);
+    const int result = run();
+    if (!tracePath.empty() && !Profiler::instance().writeChromeTrace(tracePath)) {
+        std::fprintf(stderr, "cannot write trace to %s\n", tracePath.c_str());
+        return 1;
+    }
+    return result;
+}
+
+}
+
+int main(int argc, char *argv[]) {
+    //resume只有一个存档文件参数，不需要棋盘设置，但和其他命令一样可以加上--trace FILE
+    if (argc >= 3 && std::strcmp(argv[1], "resume") == 0) {
+        std::string tracePath;
+        if (argc == 5 && std::strcmp(argv[3], "--trace") == 0) {
+            tracePath = argv[4];
+        } else if (argc != 3) {
+            printUsage();
+            return 2;
+        }
+        return runTraced(tracePath, [&]() { return resume(argv[2]); });
+    }
+
+    Options options;
+    if (argc < 2 || !parseOptions(argc, argv, options)) {
+        printUsage();
+        return 2;
+    }
+
+    const std::string command = argv[1];
+    int (*run)(const Options &) = nullptr;
+    if (command == "play") run = play;
+    if (command == "generate") run = generate;
+    if (command == "bench") run = bench;
+    if (!run) {
+        printUsage();
+        return 2;
+    }
+
+    return runTraced(options.tracePath, [&]() { return run(options); });
+}
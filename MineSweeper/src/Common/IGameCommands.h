@@ -1,6 +1,9 @@
 #ifndef IGAMECOMMANDS_H
 #define IGAMECOMMANDS_H
 
+#include <QRect>  //包含QRect，用于描述View当前显示的格子区域
+#include "../Core/Board.h"  //包含FirstClickPolicy，新游戏的命令带有首次点击策略
+
 /*
 抽象接口IGameCommands，是View->ViewModel的单向通信契约，定义了View可以向ViewModel发出的所有“用户操作命令”
 任何处理游戏逻辑的类（这里的GameViewModel）必须能够相应该接口中规定的所有命令
@@ -18,8 +21,8 @@ public:
     //--- 以下是纯虚函数，构成了命令接口的“合同” ---
 
     //View调用此命令来请求开始一局新游戏
-    //参数定义了新游戏的难度（行数、列数、地雷数）
-    virtual void startNewGame(int rows, int cols, int mines) = 0;
+    //参数定义了新游戏的难度（行数、列数、地雷数）和首次点击的保护策略（例如不需要猜的棋盘）
+    virtual void startNewGame(int rows, int cols, int mines, FirstClickPolicy policy = FirstClickPolicy::SafeCell) = 0;
 
     //当用户左键点击一个格子时，View调用此命令，请求翻开该格子
     //参数是用户点击的格子的坐标
@@ -28,6 +31,24 @@ public:
     //当用户右键点击一个格子时，View调用此命令，请求在该格子上标记/取消标记旗帜
     //参数是用户点击的格子的坐标
     virtual void toggleFlagRequest(int row, int col) = 0;
+
+    //当用户在已翻开的数字格上中键点击（或左右键同时按下）时，View调用此命令，请求一次性翻开它周围所有未插旗的格子
+    //参数是用户点击的格子的坐标
+    virtual void chordCellRequest(int row, int col) = 0;
+
+    //当用户按下Ctrl+Z时，View调用此命令，请求撤销最近的一次翻开、插旗或双击
+    virtual void undoRequest() = 0;
+
+    //当用户按下Ctrl+Y（或Ctrl+Shift+Z）时，View调用此命令，请求重做最近被撤销的一次操作
+    virtual void redoRequest() = 0;
+
+    //当用户请求提示时，View调用此命令，ViewModel会通过IGameUI::onShowHint告诉View建议翻开哪个格子
+    virtual void hintRequest() = 0;
+
+    //View告诉ViewModel当前需要显示哪一块区域（x是列，y是行，单位是格子）
+    //ViewModel此后只为这块区域内的格子发送更新，调用时会把这块区域内的全部格子发送一次
+    //从不调用此命令的View会一直收到整个棋盘的更新
+    virtual void setViewport(const QRect &cells) = 0;
 };
 
 #endif // IGAMECOMMANDS_H
\ No newline at end of file
@@ -9,6 +9,22 @@ ViewModel通过该接口指挥View，不需要知道View的具体类型
 
 #include <QString>  //包含Qt的字符串类
 #include <QSize>   //包含Qt的尺寸类（宽度和高度）
+#include <span>  //包含std::span，用于一次性传递一整段连续的格子更新
+
+//格子所有可能的外观状态
+//一个格子的外观只可能是这12种之一，ViewModel只需判断格子处于哪种状态，
+//对应的文字和样式来自一张预先构建好的固定表，不必为每个格子重新拼接字符串
+enum class CellVisual : quint8 {
+    Hidden,  //未翻开（可点击的灰色格子）
+    Flagged,  //已插旗
+    Mine,  //游戏失败后显示出来的地雷
+    Revealed0,  //已翻开的空白格（周围没有地雷）
+    Revealed1, Revealed2, Revealed3, Revealed4,
+    Revealed5, Revealed6, Revealed7, Revealed8  //已翻开的数字格，数字为周围的地雷数
+};
+
+//外观状态的总数，用于确定外观表的大小
+constexpr int CellVisualCount = static_cast<int>(CellVisual::Revealed8) + 1;
 
 //定义一个数据传输对象（Data Transfer Object，DTO），把多个相关的数据打包成一个独立的结构体，方便在不同层之间一次性传递
 //这里，该对象封装了更新单个格子UI所需的所有信息
@@ -18,6 +34,7 @@ struct CellUpdateInfo {
     QString text;  //格子上需要显示的文本（如数字、"🚩"、"💣"）
     QString styleSheet;  //控制格子外观的Qt样式表（CSS），用于改变颜色等
     bool enabled;  //格子是否可点击（已翻开的格子应被禁用）
+    CellVisual visual;  //格子的外观状态，text、styleSheet和enabled都由它唯一决定，View也可以直接根据它绘制
 };
 
 //IGameUI是一个纯虚类（接口），定义了UI层必须对外提供的能力
@@ -39,6 +56,15 @@ public:
     //View需要根据传入的CellUpdateInfo更新对应格子的外观
     virtual void onCellUpdated(const CellUpdateInfo& info) = 0;
 
+    //当一次操作改变了多个格子时，ViewModel会把所有更新打包成一段连续的数组，只调用一次此方法
+    //View可以重写它，在一次批处理中应用全部更新（例如期间暂停重绘）；
+    //默认实现只是逐个转发给onCellUpdated，所以只实现了单格接口的View（如测试用的Mock）无需任何改动
+    virtual void onCellsUpdated(std::span<const CellUpdateInfo> updates) {
+        for (const CellUpdateInfo& info : updates) {
+            onCellUpdated(info);
+        }
+    }
+
     //当游戏结束时（胜利或失败），ViewModel会调用此方法
     //View需要弹出一个对话框，向用户显示游戏结果
     virtual void onShowGameOverDialog(const QString& message) = 0;
@@ -50,6 +76,11 @@ public:
     //当游戏状态文本（如 "进行中"、"胜利"）变化时，ViewModel会调用此方法
     //View需要更新界面上显示状态的标签
     virtual void updateStatusLabel(const QString& text) = 0;
+
+    //当用户请求提示后，ViewModel会调用此方法
+    //row和col是建议翻开的格子（没有可建议的格子时为-1），message是ViewModel准备好的说明文字
+    //View需要突出显示这个格子，并把说明文字展示给用户
+    virtual void onShowHint(int row, int col, const QString& message) = 0;
 };
 
 #endif // IGAMEUI_H
\ No newline at end of file
@@ -0,0 +1,245 @@
+#include "BitPlanes.h"
+#include <algorithm>  //包含std::min
+#include <array>  //包含std::array，用于存放展开计数时使用的查找表
+#include <bit>  //包含std::popcount、std::countr_zero、std::endian
+#include <cstring>  //包含std::memcpy
+
+//x86-64平台一定支持SSE2，此时构建位平面时一次把16个格子字节转换成16个位
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define MINESWEEPER_HAS_SSE2 1
+#endif
+
+namespace {
+constexpr std::uint8_t kPlaneBits[3] = {CellBits::Mine, CellBits::Revealed, CellBits::Flagged};
+
+//位切片加法器：把一个1位的平面x加到用4个平面s0~s3表示的4位计数上（每一位独立计数，最多到15，8个邻居不会溢出）
+inline void addBit(std::uint64_t x, std::uint64_t &s0, std::uint64_t &s1, std::uint64_t &s2, std::uint64_t &s3) {
+    const std::uint64_t c0 = s0 & x;
+    s0 ^= x;
+    const std::uint64_t c1 = s1 & c0;
+    s1 ^= c0;
+    const std::uint64_t c2 = s2 & c1;
+    s2 ^= c1;
+    s3 |= c2;
+}
+
+//把一个字节的8个位展开成8个字节：第i个字节（按内存顺序）是原来的第i位，用于把计数平面一次8个格子地写成每格1字节
+constexpr std::array<std::uint64_t, 256> kSpreadBits = [] {
+    std::array<std::uint64_t, 256> table{};
+    for (int value = 0; value < 256; ++value) {
+        for (int bit = 0; bit < 8; ++bit) {
+            if (!((value >> bit) & 1)) continue;
+            //按内存顺序排列：小端序时第i个字节是数值的第8i~8i+7位，大端序时反过来
+            const int byte = std::endian::native == std::endian::little ? bit : 7 - bit;
+            table[value] |= std::uint64_t(1) << (byte * 8);
+        }
+    }
+    return table;
+}();
+}
+
+//全盘构建的实现
+void BitPlanes::capture(const Board &board) {
+    m_rows = board.getRows();
+    m_cols = board.getCols();
+    m_capturedReady = board.getGameState() == GameState::Ready;
+    m_wordsPerRow = (m_cols + 63) / 64;
+    m_lastWordMask = (m_cols % 64 == 0) ? ~std::uint64_t(0) : (std::uint64_t(1) << (m_cols % 64)) - 1;
+    const std::size_t words = std::size_t(m_rows) * m_wordsPerRow;
+    for (std::vector<std::uint64_t> &plane : m_planes) plane.assign(words, 0);
+
+    for (int r = 0; r < m_rows; ++r) {
+        const std::uint8_t *bits = board.getRowBits(r);
+        std::uint64_t *rows[3];
+        for (int p = 0; p < 3; ++p) rows[p] = m_planes[p].data() + std::size_t(r) * m_wordsPerRow;
+        int c = 0;
+#ifdef MINESWEEPER_HAS_SSE2
+        //16个字节分别与标志位比较，movemask把每个字节的比较结果收集成16个位，正好是这16个格子在平面上的位
+        for (; c + 16 <= m_cols; c += 16) {
+            const __m128i cells = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bits + c));
+            for (int p = 0; p < 3; ++p) {
+                const __m128i bit = _mm_set1_epi8(char(kPlaneBits[p]));
+                const unsigned mask = unsigned(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(cells, bit), bit)));
+                rows[p][c >> 6] |= std::uint64_t(mask) << (c & 63);
+            }
+        }
+#endif
+        //剩余不足16个的格子（或不支持SSE2的平台上的全部格子）逐个转换
+        for (; c < m_cols; ++c) {
+            for (int p = 0; p < 3; ++p) {
+                if (bits[c] & kPlaneBits[p]) rows[p][c >> 6] |= std::uint64_t(1) << (c & 63);
+            }
+        }
+    }
+}
+
+//增量更新的实现
+void BitPlanes::update(const Board &board, const std::vector<int> &cells) {
+    if (m_capturedReady || board.getRows() != m_rows || board.getCols() != m_cols) {
+        capture(board);
+        return;
+    }
+    for (const int cell : cells) {
+        const int row = cell / m_cols;
+        const int col = cell % m_cols;
+        const std::uint8_t bits = board.getRowBits(row)[col];
+        const std::size_t word = std::size_t(row) * m_wordsPerRow + (col >> 6);
+        const std::uint64_t bit = std::uint64_t(1) << (col & 63);
+        for (int p = 0; p < 3; ++p) {
+            if (bits & kPlaneBits[p]) m_planes[p][word] |= bit;
+            else m_planes[p][word] &= ~bit;
+        }
+    }
+}
+
+//count的实现
+int BitPlanes::count(Plane plane) const {
+    int total = 0;
+    for (const std::uint64_t word : m_planes[int(plane)]) total += std::popcount(word);
+    return total;
+}
+
+//allSafeRevealed的实现
+bool BitPlanes::allSafeRevealed() const {
+    const std::vector<std::uint64_t> &mines = m_planes[int(Plane::Mine)];
+    const std::vector<std::uint64_t> &revealed = m_planes[int(Plane::Revealed)];
+    for (int r = 0; r < m_rows; ++r) {
+        const std::size_t start = std::size_t(r) * m_wordsPerRow;
+        for (int k = 0; k < m_wordsPerRow; ++k) {
+            //既不是雷也没有翻开的位只要有一个，就还没有赢
+            if (~(mines[start + k] | revealed[start + k]) & validMask(k)) return false;
+        }
+    }
+    return true;
+}
+
+//countFlagsOnMines的实现
+int BitPlanes::countFlagsOnMines() const {
+    const std::vector<std::uint64_t> &mines = m_planes[int(Plane::Mine)];
+    const std::vector<std::uint64_t> &flags = m_planes[int(Plane::Flagged)];
+    int total = 0;
+    for (std::size_t i = 0; i < mines.size(); ++i) total += std::popcount(mines[i] & flags[i]);
+    return total;
+}
+
+//wordAt的实现
+std::uint64_t BitPlanes::wordAt(const std::uint64_t *plane, int row, int k) const {
+    if (row < 0 || row >= m_rows) return 0;
+    return plane[std::size_t(row) * m_wordsPerRow + k];
+}
+
+//westAt的实现
+std::uint64_t BitPlanes::westAt(const std::uint64_t *plane, int row, int k) const {
+    if (row < 0 || row >= m_rows) return 0;
+    const std::uint64_t *words = plane + std::size_t(row) * m_wordsPerRow;
+    //左移一位后第c位是第c-1列；前一个字的最高位移进来，最后一列移出到的填充位要清掉
+    const std::uint64_t carry = k > 0 ? words[k - 1] >> 63 : 0;
+    return ((words[k] << 1) | carry) & validMask(k);
+}
+
+//eastAt的实现
+std::uint64_t BitPlanes::eastAt(const std::uint64_t *plane, int row, int k) const {
+    if (row < 0 || row >= m_rows) return 0;
+    const std::uint64_t *words = plane + std::size_t(row) * m_wordsPerRow;
+    //右移一位后第c位是第c+1列；后一个字的最低位移进来（填充位总是0，不需要清）
+    const std::uint64_t carry = k + 1 < m_wordsPerRow ? words[k + 1] << 63 : 0;
+    return (words[k] >> 1) | carry;
+}
+
+//neighborCounts的实现
+void BitPlanes::neighborCounts(Plane plane, std::vector<std::uint8_t> &counts) const {
+    counts.assign(std::size_t(m_rows) * m_cols, 0);
+    const std::uint64_t *bits = m_planes[int(plane)].data();
+    for (int r = 0; r < m_rows; ++r) {
+        std::uint8_t *out = counts.data() + std::size_t(r) * m_cols;
+        for (int k = 0; k < m_wordsPerRow; ++k) {
+            //上一行和下一行各3个邻居，本行左右2个，一共8个平面逐个加到4位计数上
+            std::uint64_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+            addBit(westAt(bits, r - 1, k), s0, s1, s2, s3);
+            addBit(wordAt(bits, r - 1, k), s0, s1, s2, s3);
+            addBit(eastAt(bits, r - 1, k), s0, s1, s2, s3);
+            addBit(westAt(bits, r, k), s0, s1, s2, s3);
+            addBit(eastAt(bits, r, k), s0, s1, s2, s3);
+            addBit(westAt(bits, r + 1, k), s0, s1, s2, s3);
+            addBit(wordAt(bits, r + 1, k), s0, s1, s2, s3);
+            addBit(eastAt(bits, r + 1, k), s0, s1, s2, s3);
+
+            //把4个计数平面展开成每格1字节；全为0的字（周围没有任何邻居）直接跳过，counts已经清零
+            if ((s0 | s1 | s2 | s3) == 0) continue;
+            //每次取4个平面中同样位置的一个字节查表，一次写出8个格子的计数
+            const int base = k * 64;
+            const int end = std::min(64, m_cols - base);
+            for (int b = 0; b < end; b += 8) {
+                const std::uint64_t bytes = kSpreadBits[(s0 >> b) & 0xFF] | kSpreadBits[(s1 >> b) & 0xFF] << 1
+                                            | kSpreadBits[(s2 >> b) & 0xFF] << 2 | kSpreadBits[(s3 >> b) & 0xFF] << 3;
+                std::memcpy(out + base + b, &bytes, std::size_t(std::min(8, end - b)));
+            }
+        }
+    }
+}
+
+//collectRow的实现
+template <typename Combine>
+void BitPlanes::collectRow(int row, Combine &&combine, std::vector<int> &cells) const {
+    const int rowStart = row * m_cols;
+    for (int k = 0; k < m_wordsPerRow; ++k) {
+        //每次取出最低的一位，只访问结果中为1的格子
+        for (std::uint64_t word = combine(k); word != 0; word &= word - 1) {
+            cells.push_back(rowStart + k * 64 + std::countr_zero(word));
+        }
+    }
+}
+
+//frontier的实现
+void BitPlanes::frontier(std::vector<int> &cells) const {
+    cells.clear();
+    const std::vector<std::uint64_t> &mines = m_planes[int(Plane::Mine)];
+    const std::vector<std::uint64_t> &revealed = m_planes[int(Plane::Revealed)];
+    const std::vector<std::uint64_t> &flags = m_planes[int(Plane::Flagged)];
+
+    //先算出“已翻开的数字格”平面（失败后踩中的地雷也是已翻开的，但它没有数字）
+    std::vector<std::uint64_t> numbers(revealed.size());
+    for (std::size_t i = 0; i < numbers.size(); ++i) numbers[i] = revealed[i] & ~mines[i];
+
+    const std::uint64_t *plane = numbers.data();
+    for (int r = 0; r < m_rows; ++r) {
+        const std::size_t start = std::size_t(r) * m_wordsPerRow;
+        collectRow(r, [&](int k) {
+            //把数字格向8个方向各扩张一格，再去掉已翻开和插旗的格子
+            const std::uint64_t around = westAt(plane, r - 1, k) | wordAt(plane, r - 1, k) | eastAt(plane, r - 1, k)
+                                         | westAt(plane, r, k) | eastAt(plane, r, k) | westAt(plane, r + 1, k)
+                                         | wordAt(plane, r + 1, k) | eastAt(plane, r + 1, k);
+            return around & ~(revealed[start + k] | flags[start + k]) & validMask(k);
+        }, cells);
+    }
+}
+
+//hiddenMines的实现
+void BitPlanes::hiddenMines(std::vector<int> &cells) const {
+    cells.clear();
+    const std::vector<std::uint64_t> &mines = m_planes[int(Plane::Mine)];
+    const std::vector<std::uint64_t> &revealed = m_planes[int(Plane::Revealed)];
+    for (int r = 0; r < m_rows; ++r) {
+        const std::size_t start = std::size_t(r) * m_wordsPerRow;
+        collectRow(r, [&](int k) { return mines[start + k] & ~revealed[start + k]; }, cells);
+    }
+}
+
+//untouchedSafeCells的实现
+void BitPlanes::untouchedSafeCells(std::vector<int> &cells) const {
+    cells.clear();
+    const std::vector<std::uint64_t> &mines = m_planes[int(Plane::Mine)];
+    const std::vector<std::uint64_t> &revealed = m_planes[int(Plane::Revealed)];
+    const std::uint64_t *plane = revealed.data();
+    for (int r = 0; r < m_rows; ++r) {
+        const std::size_t start = std::size_t(r) * m_wordsPerRow;
+        collectRow(r, [&](int k) {
+            //已翻开的平面连同自身向8个方向各扩张一格，剩下的不是地雷的格子就是远离已翻开区域的
+            const std::uint64_t touched = westAt(plane, r - 1, k) | wordAt(plane, r - 1, k) | eastAt(plane, r - 1, k)
+                                          | westAt(plane, r, k) | wordAt(plane, r, k) | eastAt(plane, r, k)
+                                          | westAt(plane, r + 1, k) | wordAt(plane, r + 1, k) | eastAt(plane, r + 1, k);
+            return ~(touched | mines[start + k]) & validMask(k);
+        }, cells);
+    }
+}
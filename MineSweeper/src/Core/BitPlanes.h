@@ -0,0 +1,94 @@
+#ifndef MINESWEEPER_BITPLANES_H
+#define MINESWEEPER_BITPLANES_H
+
+/*
+BitPlanes是棋盘的位平面表示，属于不依赖Qt的核心库，是Board之外可选的一份只读视图
+它把地雷、已翻开、已插旗三种状态各存成一个位平面：每行占若干个64位字，第c列是该行第c/64个字的第c%64位
+一个字同时表示64个格子，整盘的查询只需对字做与、或、移位和popcount：
+- 是否所有安全格子都已翻开、插对了几面旗帜：逐字比较和计数，不需要逐个格子解码
+- 周围地雷数（或任意平面上的邻居数）：把上中下三行左右移位后的8个平面用位切片加法器相加，一次得到64个格子的计数
+- 边界（与已翻开数字相邻、尚未翻开也没有插旗的格子）和失败时需要显示的地雷：位运算得到结果平面后只访问其中为1的位
+
+Board本身仍然使用每格1字节的编码，翻开、插旗等操作和胜负判断（增量维护的计数器）都不经过这里；
+需要对大棋盘反复做整盘查询的代码可以用capture构建一次，之后用update按改变的格子增量维护，
+例如NoGuessGenerator每次修复布局之前都要找出边界上的地雷和远离已翻开区域的空格子
+*/
+
+#include <cstddef>  //包含std::size_t
+#include <cstdint>  //包含固定宽度的整数类型
+#include <vector>  //包含std::vector
+#include "Board.h"  //从Board读取格子的1字节编码
+
+class BitPlanes {
+public:
+    //位平面的种类
+    enum class Plane {
+        Mine,  //是地雷
+        Revealed,  //已翻开
+        Flagged  //已插旗
+    };
+
+    //从board全盘构建三个位平面，耗时与格子数成正比（支持SSE2时一次转换16个格子）
+    void capture(const Board &board);
+
+    //board上cells（行优先编号，例如Board::getChangedCells()）中的格子改变之后，增量更新对应的位
+    //首次翻开时布下的地雷不在改变的格子中，所以上次构建时还处于准备状态、或者board的尺寸不同（开始了新的一局）时改为全盘构建
+    void update(const Board &board, const std::vector<int> &cells);
+
+    int getRows() const { return m_rows; }
+    int getCols() const { return m_cols; }
+    int getWordsPerRow() const { return m_wordsPerRow; }  //每行占用的64位字数
+
+    //第row行的位，共getWordsPerRow()个字；最后一个字中超出列数的位总是0
+    const std::uint64_t *rowWords(Plane plane, int row) const {
+        return m_planes[int(plane)].data() + std::size_t(row) * m_wordsPerRow;
+    }
+
+    //格子在某个平面上的位
+    bool test(Plane plane, int row, int col) const { return (rowWords(plane, row)[col >> 6] >> (col & 63)) & 1; }
+
+    //某个平面上为1的格子数
+    int count(Plane plane) const;
+
+    //是否所有不是地雷的格子都已翻开（胜利条件）
+    bool allSafeRevealed() const;
+
+    //插在地雷上的旗帜数
+    int countFlagsOnMines() const;
+
+    //每个格子周围8个邻居中在plane上为1的个数（对Mine平面就是周围地雷数），按行优先写入counts
+    void neighborCounts(Plane plane, std::vector<std::uint8_t> &counts) const;
+
+    //边界：尚未翻开、没有插旗，且至少与一个已翻开的数字格相邻的格子，按行优先编号从小到大写入cells
+    void frontier(std::vector<int> &cells) const;
+
+    //尚未翻开的地雷（失败时需要显示出来的格子），按行优先编号从小到大写入cells
+    void hiddenMines(std::vector<int> &cells) const;
+
+    //尚未翻开、不是地雷，并且8个邻居都没有翻开的格子，按行优先编号从小到大写入cells
+    void untouchedSafeCells(std::vector<int> &cells) const;
+
+private:
+    //对第row行的每个字调用combine(k)（k是字在行中的序号）得到结果字，把结果中为1的位换算成行优先编号追加到cells
+    template <typename Combine>
+    void collectRow(int row, Combine &&combine, std::vector<int> &cells) const;
+
+    //plane是按行连续存放的一个平面（可以是临时计算出的平面），返回第row行的第k个字；row越界时返回0，相当于棋盘外都是0
+    std::uint64_t wordAt(const std::uint64_t *plane, int row, int k) const;
+
+    //第row行第k个字的左右邻居：west的第c位是第c-1列的位，east的第c位是第c+1列的位；row越界时返回0
+    std::uint64_t westAt(const std::uint64_t *plane, int row, int k) const;
+    std::uint64_t eastAt(const std::uint64_t *plane, int row, int k) const;
+
+    //第k个字中属于棋盘的位（只有每行最后一个字可能不满）
+    std::uint64_t validMask(int k) const { return k == m_wordsPerRow - 1 ? m_lastWordMask : ~std::uint64_t(0); }
+
+    int m_rows = 0;
+    int m_cols = 0;
+    int m_wordsPerRow = 0;
+    std::uint64_t m_lastWordMask = 0;  //每行最后一个字中属于棋盘的位
+    bool m_capturedReady = true;  //上次全盘构建时棋盘是否处于准备状态（可能还没有布雷）
+    std::vector<std::uint64_t> m_planes[3];  //按Plane的顺序存放三个平面，每个平面按行连续存放
+};
+
+#endif //MINESWEEPER_BITPLANES_H
@@ -0,0 +1,674 @@
+#include "Board.h"
+#include "NoGuessGenerator.h"  //NoGuess策略下由生成器给出经过求解器验证的布局
+#include "Profiler.h"  //记录布雷、重算和连锁翻开的耗时
+#include <algorithm>  //包含std::clamp、std::find等通用算法
+#include <bit>  //包含std::endian，存档文件使用小端序
+#include <cassert>  //包含assert，用于调试版本中的一致性检查
+#include <climits>  //包含INT_MAX
+#include <cstdio>  //包含std::fopen、std::fread、std::fwrite，用于读写存档文件
+#include <cstring>  //包含std::memcpy、std::memcmp
+#include <filesystem>  //包含std::filesystem::rename，用临时文件替换存档
+#include <type_traits>  //包含std::is_trivially_copyable_v
+
+//x86-64平台一定支持SSE2，此时整盘重算周围地雷数时一次处理16个格子
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define MINESWEEPER_HAS_SSE2 1
+#endif
+
+namespace {
+//地雷数达到总格子数的1/kDenseBoardRatio（即20%）及以上时视为“密集棋盘”
+//稀疏棋盘逐颗地雷增量更新邻居计数，代价与地雷数成正比；密集棋盘则改为放完雷后整盘向量化重算，代价与格子数成正比但常数极小
+constexpr int kDenseBoardRatio = 5;
+
+//存档文件头，所有整数都按本机的小端序直接存放
+struct FileHeader {
+    char magic[8];  //"MSBOARD"
+    std::uint32_t version;  //格式版本
+    std::uint32_t cellOffset;  //格子字节在文件中的起始位置
+    std::uint64_t cellBytes;  //格子字节数（含哨兵）
+    std::int32_t rows;
+    std::int32_t cols;
+    std::int32_t mines;
+    std::int32_t revealed;  //已翻开的非地雷格子数
+    std::int32_t flags;  //已插旗的格子数
+    std::uint8_t state;  //GameState
+    std::uint8_t policy;  //FirstClickPolicy
+    std::uint8_t reserved[2];
+    std::uint64_t seed;
+};
+static_assert(std::is_trivially_copyable_v<FileHeader>);
+static_assert(std::endian::native == std::endian::little, "the save file format is little-endian");
+
+constexpr char kFileMagic[8] = "MSBOARD";
+constexpr std::uint32_t kFileVersion = 1;
+//格子从第二个页面开始，文件头独占第0页，格子所在的页面都与页面边界对齐
+constexpr std::size_t kFileCellOffset = 4096;
+static_assert(sizeof(FileHeader) <= kFileCellOffset);
+
+//哨兵格子的编码：视为“已翻开”
+constexpr std::uint8_t kGuardCell = CellBits::Guard | CellBits::Revealed;
+
+//哨兵格子的高4位会被addMine顺带加上周围地雷数（没有逻辑会读取它），外围的一个哨兵最多与3个真实格子相邻
+constexpr int kMaxGuardCount = 3;
+
+//检查rows x cols棋盘（含哨兵共(rows+2) x (cols+2)个字节）外围的一圈是否都是哨兵格子，耗时与行数加列数成正比
+//连锁翻开和邻居访问不做边界检查，完全依靠这一圈哨兵停下来，所以读进来的格子字节必须先通过这个检查
+bool guardRingIntact(const std::uint8_t *bits, int rows, int cols) {
+    auto isGuard = [](std::uint8_t cell) {
+        return (cell & ~CellBits::CountMask) == kGuardCell && (cell >> CellBits::CountShift) <= kMaxGuardCount;
+    };
+    const std::size_t stride = std::size_t(cols) + 2;
+    const std::uint8_t *last = bits + (std::size_t(rows) + 1) * stride;
+    for (std::size_t c = 0; c < stride; ++c) {
+        if (!isGuard(bits[c]) || !isGuard(last[c])) return false;
+    }
+    for (std::size_t r = 1; r <= std::size_t(rows); ++r) {
+        if (!isGuard(bits[r * stride]) || !isGuard(bits[r * stride + cols + 1])) return false;
+    }
+    return true;
+}
+}
+
+//开始新游戏的实现
+void Board::startGame(int rows, int cols, int mines, std::uint64_t seed, FirstClickPolicy policy) {
+    //初始化或重置游戏的核心数据
+    setDimensions(rows, cols);
+    //设置行数、列数和地雷数；首次点击的格子永远不会是雷，所以地雷数最多只能是格子总数减一
+    m_mineCount = std::clamp(mines, 0, std::max(0, rows * cols - 1));
+    m_firstClickPolicy = policy;  //记录本局的首次点击保护策略
+    //生成器应付不了的棋盘上，“不需要猜”的布局会在首次翻开时长时间占住线程（几乎总是以未经验证的布局结束），直接退回SafeArea
+    if (policy == FirstClickPolicy::NoGuess && !NoGuessGenerator::canGenerate(m_rows, m_cols, m_mineCount)) {
+        m_firstClickPolicy = FirstClickPolicy::SafeArea;
+    }
+    m_layoutCertified = false;
+    m_seed = seed;  //记录本局的种子，并用它重置布雷用的随机数生成器
+    m_rng.reseed(seed);
+    m_revealedCount = 0;  //重置已翻开格子计数
+    m_flagCount = 0;  //重置旗帜计数
+    m_countersChecked = true;
+    m_changedCells.clear();
+    m_gameState = GameState::Ready;  //重新设置为准备状态
+
+    //棋盘按行连续存储在一块内存中，四周额外多出一圈哨兵格子，所以实际尺寸是(rows+2) x (cols+2)
+    m_board.assign((m_rows + 2) * m_stride, 0);  //所有真实格子清零（无雷、未翻开、未插旗、周围0颗雷）
+    //把最上、最下两行和最左、最右两列标记为哨兵，哨兵同时视为“已翻开”，这样任何翻开逻辑都会自然地跳过它们
+    std::fill(m_board.begin(), m_board.begin() + m_stride, kGuardCell);
+    std::fill(m_board.end() - m_stride, m_board.end(), kGuardCell);
+    for (int r = 1; r <= m_rows; ++r) {
+        m_board[r * m_stride] = kGuardCell;
+        m_board[r * m_stride + m_cols + 1] = kGuardCell;
+    }
+}
+
+//setDimensions的实现
+void Board::setDimensions(int rows, int cols) {
+    m_rows = rows;
+    m_cols = cols;
+    m_stride = m_cols + 2;  //一行的左右各有一个哨兵格子
+
+    //预先算好8个邻居相对于当前格子的下标偏移量，之后访问邻居只需一次加法
+    m_neighborOffsets = {-m_stride - 1, -m_stride, -m_stride + 1,
+                         -1, 1,
+                         m_stride - 1, m_stride, m_stride + 1};
+}
+
+//加载指定布局的实现
+void Board::loadLayout(int rows, int cols, const std::vector<std::uint8_t> &isMine, std::uint64_t seed,
+                       FirstClickPolicy policy) {
+    int mines = 0;
+    for (int cell = 0; cell < rows * cols; ++cell) mines += isMine[cell] != 0;
+    startGame(rows, cols, mines, seed, policy);
+    presetLayout(isMine, seed);
+}
+
+//预先指定布局的实现
+bool Board::presetLayout(const std::vector<std::uint8_t> &isMine, std::uint64_t seed, bool certified) {
+    ensureCountersChecked();
+    if (m_gameState != GameState::Ready) {
+        return false;
+    }
+    placeLayout(isMine);
+    m_seed = seed;
+    m_layoutCertified = certified && m_firstClickPolicy == FirstClickPolicy::NoGuess;
+    m_gameState = GameState::Playing;
+    return true;
+}
+
+//按布局放置地雷的实现
+void Board::placeLayout(const std::vector<std::uint8_t> &isMine) {
+    const bool dense = std::int64_t(m_mineCount) * kDenseBoardRatio >= std::int64_t(m_rows) * m_cols;
+    for (int cell = 0; cell < m_rows * m_cols; ++cell) {
+        if (!isMine[cell]) continue;
+        const int index = indexOf(cell / m_cols, cell % m_cols);
+        if (dense) {
+            m_board[index] |= CellBits::Mine;
+        } else {
+            addMine(index);
+        }
+    }
+    if (dense) {
+        calculateAdjacentMines();
+    }
+}
+
+//同步镜像的实现
+void Board::syncFrom(const Board &other, const std::vector<int> &cells) {
+    for (int cell : cells) {
+        const int index = indexOf(cell / m_cols, cell % m_cols);
+        m_board[index] = other.m_board[index];
+    }
+    m_flagCount = other.m_flagCount;
+    m_revealedCount = other.m_revealedCount;
+    m_gameState = other.m_gameState;
+    m_changedCells.assign(cells.begin(), cells.end());
+}
+
+//toggleCells的实现
+void Board::toggleCells(const std::vector<int> &cells, std::uint8_t bit, GameState state) {
+    ensureCountersChecked();
+    if (state == GameState::Ready && m_gameState != GameState::Ready) {
+        state = GameState::Playing;
+    }
+    //失败时所有地雷都会显示出来，所以进入或离开失败状态时，其余（未翻开的）地雷格子的显示也改变了
+    //踩中的地雷已经在cells中，所以在它处于翻开状态时（离开失败状态之前、进入失败状态之后）收集其余的地雷
+    const bool lostChanged = (state == GameState::Lost) != (m_gameState == GameState::Lost);
+    auto addHiddenMines = [this]() {
+        for (int r = 0; r < m_rows; ++r) {
+            for (int c = 0, i = indexOf(r, 0); c < m_cols; ++c, ++i) {
+                if ((m_board[i] & (CellBits::Mine | CellBits::Revealed)) == CellBits::Mine) {
+                    m_changedCells.push_back(r * m_cols + c);
+                }
+            }
+        }
+    };
+
+    m_changedCells.assign(cells.begin(), cells.end());
+    if (lostChanged && m_gameState == GameState::Lost) addHiddenMines();
+    for (int cell : cells) {
+        std::uint8_t &bits = m_board[indexOf(cell / m_cols, cell % m_cols)];
+        bits ^= bit;
+        const int delta = (bits & bit) ? 1 : -1;
+        if (bit == CellBits::Flagged) {
+            m_flagCount += delta;
+        } else if (!(bits & CellBits::Mine)) {
+            m_revealedCount += delta;  //踩中的地雷虽然被翻开，但不计入已翻开数
+        }
+    }
+    m_gameState = state;
+    if (lostChanged && state == GameState::Lost) addHiddenMines();
+    validateCounters();
+}
+
+//放置地雷的实现
+//使用Floyd抽样算法从所有允许放雷的格子中等概率地抽取m_mineCount个，每颗雷恰好消耗一次随机数，
+//不会像“随机选点、撞上已有地雷就重试”那样在高密度棋盘上越来越慢，总耗时严格与地雷数成正比
+//同一个种子、同一个首次点击位置，总是得到逐位相同的棋盘
+template <typename Engine>
+void Board::placeMines(Engine &engine, int firstClickRow, int firstClickCol) {
+    const int cellCount = m_rows * m_cols;
+
+    //收集不允许放雷的格子，使用行优先的一维编号（row * m_cols + col），按编号从小到大排列
+    //SafeArea策略排除首次点击格子周围的3x3区域；如果剩下的格子放不下全部地雷，则退回到只排除首次点击的格子
+    std::array<int, 9> excluded{};
+    int excludedCount = 0;
+    auto excludeAround = [&](int radius) {
+        excludedCount = 0;
+        for (int r = firstClickRow - radius; r <= firstClickRow + radius; ++r) {
+            for (int c = firstClickCol - radius; c <= firstClickCol + radius; ++c) {
+                if (isValid(r, c)) excluded[excludedCount++] = r * m_cols + c;
+            }
+        }
+    };
+    excludeAround(m_firstClickPolicy == FirstClickPolicy::SafeCell ? 0 : 1);
+    if (m_mineCount > cellCount - excludedCount) {
+        excludeAround(0);
+    }
+
+    //可放雷的格子共有candidateCount个，让编号[0, candidateCount)恰好一一对应它们：
+    //落在这个范围内的被排除编号，依次换成尾部[candidateCount, cellCount)中没有被排除的编号
+    const int candidateCount = cellCount - excludedCount;
+    std::array<std::pair<int, int>, 9> remap{};
+    int remapCount = 0;
+    for (int i = 0, tail = candidateCount; i < excludedCount && excluded[i] < candidateCount; ++i, ++tail) {
+        while (std::find(excluded.begin(), excluded.begin() + excludedCount, tail) != excluded.begin() + excludedCount) {
+            ++tail;
+        }
+        remap[remapCount++] = {excluded[i], tail};
+    }
+    //把候选编号换算成m_board中的下标
+    auto boardIndexOf = [&](int candidate) {
+        for (int i = 0; i < remapCount; ++i) {
+            if (remap[i].first == candidate) {
+                candidate = remap[i].second;
+                break;
+            }
+        }
+        return indexOf(candidate / m_cols, candidate % m_cols);
+    };
+
+    //根据地雷密度选择周围地雷数的计算方式（见kDenseBoardRatio的说明）
+    const bool dense = std::int64_t(m_mineCount) * kDenseBoardRatio >= std::int64_t(cellCount);
+
+    //Floyd抽样：依次考察j = n-k, ..., n-1，在[0, j]中随机抽一个编号，如果它已经被选过，就改选j本身（j此前一定没被选过）
+    //格子上的地雷位本身就记录了“是否已被选过”，不需要额外的集合
+    for (int j = candidateCount - m_mineCount; j < candidateCount; ++j) {
+        int index = boardIndexOf(int(boundedRandom(engine, std::uint32_t(j + 1))));
+        if (m_board[index] & CellBits::Mine) {
+            index = boardIndexOf(j);
+        }
+        //在该位置放置一个地雷；稀疏棋盘在放雷的同时就把它计入8个邻居的周围地雷数
+        if (dense) {
+            m_board[index] |= CellBits::Mine;
+        } else {
+            addMine(index);
+        }
+    }
+    //密集棋盘在地雷全部放置完毕后，再一次性计算所有格子周围的地雷数
+    if (dense) {
+        calculateAdjacentMines();
+    }
+}
+
+//放置单颗地雷并增量更新邻居计数的实现
+void Board::addMine(int index) {
+    std::uint8_t *board = m_board.data();
+    board[index] |= CellBits::Mine;
+    //8个邻居的周围地雷数各加一（直接加在高4位上）；落在哨兵上的计数不会被任何逻辑读取，无需跳过
+    for (int offset : m_neighborOffsets) {
+        board[index + offset] += std::uint8_t(1 << CellBits::CountShift);
+    }
+}
+
+//计算每个格子周围地雷数量的实现
+//把“是否是雷”看作一张0/1平面，每个格子的周围地雷数就是这张平面向8个方向平移后逐格相加的结果
+//由于棋盘按行连续存储且四周有哨兵，同一行里相邻的格子可以整段批量计算，这里用SSE2一次算16个格子
+void Board::calculateAdjacentMines() {
+    MINESWEEPER_PROFILE_SCOPE(ProfileZone::AdjacentMines);
+    std::uint8_t *board = m_board.data();
+#ifdef MINESWEEPER_HAS_SSE2
+    const int stride = m_stride;
+#endif
+    for (int r = 0; r < m_rows; ++r) {
+        const int rowStart = indexOf(r, 0);
+        int c = 0;
+#ifdef MINESWEEPER_HAS_SSE2
+        const __m128i mineBit = _mm_set1_epi8(CellBits::Mine);
+        const __m128i flagBits = _mm_set1_epi8(char(~CellBits::CountMask));
+        for (; c + 16 <= m_cols; c += 16) {
+            const std::uint8_t *p = board + rowStart + c;
+            auto mines = [&](int offset) {
+                return _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p + offset)), mineBit);
+            };
+            __m128i sum = _mm_add_epi8(mines(-stride - 1), mines(-stride));
+            sum = _mm_add_epi8(sum, mines(-stride + 1));
+            sum = _mm_add_epi8(sum, mines(-1));
+            sum = _mm_add_epi8(sum, mines(1));
+            sum = _mm_add_epi8(sum, mines(stride - 1));
+            sum = _mm_add_epi8(sum, mines(stride));
+            sum = _mm_add_epi8(sum, mines(stride + 1));
+            //每个字节的和不超过8，按16位左移4位不会把低字节的位移进高字节，相当于逐字节左移
+            const __m128i counts = _mm_slli_epi16(sum, CellBits::CountShift);
+            const __m128i current = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(board + rowStart + c),
+                             _mm_or_si128(_mm_and_si128(current, flagBits), counts));
+        }
+#endif
+        //剩余不足16个的格子（或不支持SSE2的平台上的全部格子）逐个计算，同样不需要边界检查
+        for (; c < m_cols; ++c) {
+            const int index = rowStart + c;
+            int count = 0;
+            for (int offset : m_neighborOffsets) {
+                count += board[index + offset] & CellBits::Mine;
+            }
+            board[index] = std::uint8_t((board[index] & ~CellBits::CountMask) | (count << CellBits::CountShift));
+        }
+    }
+}
+
+//布雷的实现
+bool Board::layMines(int firstRow, int firstCol) {
+    ensureCountersChecked();
+    if (!isValid(firstRow, firstCol) || m_gameState != GameState::Ready) {
+        return false;
+    }
+    MINESWEEPER_PROFILE_SCOPE(ProfileZone::PlaceMines);
+    if (m_firstClickPolicy == FirstClickPolicy::NoGuess) {
+        //由生成器找出一个不需要猜的布局
+        NoGuessGenerator generator(m_rows, m_cols, m_mineCount, firstRow, firstCol, m_seed);
+        generator.setThreadCount(m_generatorThreads);
+        generator.setCancelFlag(m_generatorCancel);
+        const NoGuessGenerator::Result result = generator.generate();
+        if (result.isMine.empty()) {
+            return false;  //被取消了
+        }
+        placeLayout(result.isMine);
+        m_layoutCertified = result.certified;
+    } else {
+        placeMines(m_rng, firstRow, firstCol);
+    }
+    m_gameState = GameState::Playing;  //游戏状态变为“进行中”
+    return true;
+}
+
+//翻开格子的实现
+bool Board::revealCell(int row, int col) {
+    ensureCountersChecked();
+    //边界检查和状态验证：如果坐标无效，或格子已翻开/已标记，或游戏已结束，则不执行任何操作
+    if (!isValid(row, col) || m_gameState == GameState::Won || m_gameState == GameState::Lost) {
+        return false;
+    }
+    const int index = indexOf(row, col);
+    if (m_board[index] & (CellBits::Revealed | CellBits::Flagged)) {
+        return false;
+    }
+
+    //如果这是第一次点击（游戏处于Ready状态），先安全地放置地雷；布雷被取消时这次翻开不做任何事
+    if (m_gameState == GameState::Ready && !layMines(row, col)) {
+        return false;
+    }
+
+    m_changedCells.clear();  //开始记录本次操作改变了哪些格子
+    revealIndex(index);
+    finishReveal();
+    return true;
+}
+
+//双击（同时翻开周围格子）的实现
+bool Board::chordCell(int row, int col) {
+    ensureCountersChecked();
+    //只能在游戏进行中、对已翻开的数字格使用
+    if (!isValid(row, col) || m_gameState != GameState::Playing) {
+        return false;
+    }
+    const int index = indexOf(row, col);
+    const std::uint8_t bits = m_board[index];
+    if (!(bits & CellBits::Revealed) || (bits & CellBits::Mine) || adjacentOf(bits) == 0) {
+        return false;
+    }
+
+    //统计周围的旗帜数，与数字不符时不做任何事
+    int flags = 0;
+    for (int offset : m_neighborOffsets) {
+        flags += (m_board[index + offset] & CellBits::Flagged) != 0;
+    }
+    if (flags != adjacentOf(bits)) {
+        return false;
+    }
+
+    //在同一个操作里翻开周围所有未翻开、未插旗的格子；前面的格子引发的连锁翻开可能已经翻开了后面的格子，所以逐个重新检查
+    //旗帜插错时会踩到地雷，但剩下的邻居仍然会被翻开，与一次性按下所有邻居的效果一致
+    m_changedCells.clear();
+    for (int offset : m_neighborOffsets) {
+        const int neighbor = index + offset;
+        if (!(m_board[neighbor] & (CellBits::Revealed | CellBits::Flagged))) {
+            revealIndex(neighbor);
+        }
+    }
+    if (m_changedCells.empty()) {
+        return false;  //周围已经没有可翻开的格子
+    }
+    finishReveal();
+    return true;
+}
+
+//翻开单个格子的实现
+void Board::revealIndex(int index) {
+    m_board[index] |= CellBits::Revealed;  //将当前格子标记为“已翻开”
+    m_changedCells.push_back(index);
+
+    //检查是否踩到地雷
+    if (m_board[index] & CellBits::Mine) {
+        m_gameState = GameState::Lost;  //游戏状态变为“失败”
+        return;
+    }
+
+    m_revealedCount++;  //已翻开的非地雷格子数加一
+
+    //如果翻开的是一个空白格（周围没有地雷）
+    if (adjacentOf(m_board[index]) == 0) {
+        revealEmptyAdjacentCells(index);  //连锁翻开相邻的格子
+    }
+}
+
+//翻开操作收尾的实现
+void Board::finishReveal() {
+    //此时m_changedCells中恰好是本次操作翻开的格子（下面失败时还会补上其余的地雷）
+    MINESWEEPER_PROFILE_COUNT(ProfileCounter::CellsRevealed, m_changedCells.size());
+    if (m_gameState == GameState::Lost) {
+        //失败后所有地雷都要显示出来，所以把其余（未被翻开的）地雷格子也记为已改变
+        for (int r = 0; r < m_rows; ++r) {
+            for (int c = 0, i = indexOf(r, 0); c < m_cols; ++c, ++i) {
+                if ((m_board[i] & (CellBits::Mine | CellBits::Revealed)) == CellBits::Mine) m_changedCells.push_back(i);
+            }
+        }
+    } else if (m_revealedCount == m_rows * m_cols - m_mineCount) {
+        //胜利条件：已翻开的格子数等于总格子数减去地雷数
+        m_gameState = GameState::Won;  //游戏状态变为“胜利”
+    }
+
+    validateCounters();
+    convertChangedCells();
+}
+
+//标记/取消标记旗帜的实现
+bool Board::flagCell(int row, int col) {
+    ensureCountersChecked();
+    //边界检查：如果坐标无效，或格子已翻开，或游戏已结束，则不执行任何操作
+    if (!isValid(row, col) || m_gameState == GameState::Won || m_gameState == GameState::Lost) {
+        return false;
+    }
+    std::uint8_t &bits = m_board[indexOf(row, col)];
+    if (bits & CellBits::Revealed) {
+        return false;
+    }
+
+    //切换标记状态，并同步更新旗帜计数
+    bits ^= CellBits::Flagged;
+    m_flagCount += (bits & CellBits::Flagged) ? 1 : -1;
+    validateCounters();
+    m_changedCells.clear();
+    m_changedCells.push_back(row * m_cols + col);  //只有这一个格子被改变
+    return true;
+}
+
+//保存到文件的实现
+bool Board::saveToFile(const std::string &path) {
+    if (m_rows <= 0 || m_cols <= 0) {
+        return false;
+    }
+    //文件头独占第0页，剩余部分补零
+    std::vector<char> headerPage(kFileCellOffset, 0);
+    FileHeader header{};
+    std::memcpy(header.magic, kFileMagic, sizeof header.magic);
+    header.version = kFileVersion;
+    header.cellOffset = std::uint32_t(kFileCellOffset);
+    header.cellBytes = m_board.size();
+    header.rows = m_rows;
+    header.cols = m_cols;
+    header.mines = m_mineCount;
+    header.revealed = m_revealedCount;
+    header.flags = m_flagCount;
+    header.state = std::uint8_t(m_gameState);
+    header.policy = std::uint8_t(m_firstClickPolicy);
+    header.seed = m_seed;
+    std::memcpy(headerPage.data(), &header, sizeof header);
+
+    //先完整地写进同一目录下的临时文件，再用它替换目标文件：目标文件可能正是当前映射着的存档（路径的写法可以不同），
+    //原地截断它会毁掉正在使用的格子；写到一半失败时，原来的存档也保持完整
+    const std::string temporary = path + ".tmp";
+    std::FILE *file = std::fopen(temporary.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    bool written = std::fwrite(headerPage.data(), headerPage.size(), 1, file) == 1
+        && std::fwrite(m_board.data(), m_board.size(), 1, file) == 1;
+    written = std::fclose(file) == 0 && written;
+#ifdef _WIN32
+    //Windows上被映射着的文件不能被替换，先把格子复制到堆上并解除映射
+    if (written && m_board.isMapped()) m_board = BoardStorage(m_board);
+#endif
+    std::error_code error;
+    if (written) std::filesystem::rename(temporary, path, error);
+    if (!written || error) {
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+//读档的实现
+bool Board::loadFromFile(const std::string &path) {
+    //先只读出文件头检查格式，这一步的耗时与棋盘大小无关
+    FileHeader header{};
+    std::FILE *file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        return false;
+    }
+    const bool complete = std::fread(&header, sizeof header, 1, file) == 1;
+    std::fclose(file);
+    if (!complete || std::memcmp(header.magic, kFileMagic, sizeof header.magic) != 0 || header.version != kFileVersion
+        || header.cellOffset != kFileCellOffset) {
+        return false;
+    }
+    const std::int64_t rows = header.rows, cols = header.cols;
+    if (rows <= 0 || cols <= 0 || (rows + 2) * (cols + 2) > INT_MAX
+        || header.cellBytes != std::uint64_t((rows + 2) * (cols + 2))) {
+        return false;
+    }
+    const std::int64_t cells = rows * cols;
+    if (header.mines < 0 || header.mines > std::max<std::int64_t>(0, cells - 1) || header.flags < 0
+        || header.flags > cells || header.revealed < 0 || header.revealed > cells - header.mines
+        || header.state > std::uint8_t(GameState::Lost) || header.policy > std::uint8_t(FirstClickPolicy::NoGuess)) {
+        return false;
+    }
+
+    //以写时复制的方式映射整个文件，格子直接使用文件中的字节，不读入、不复制，之后的操作也不会修改文件
+    BoardStorage storage;
+    if (!storage.mapFile(path, kFileCellOffset, std::size_t(header.cellBytes))) {
+        return false;
+    }
+    //损坏或伪造的文件如果缺了哨兵，第一次翻开就会越过映射读写；只检查外围一圈，读档的耗时仍与棋盘面积无关
+    if (!guardRingIntact(storage.data(), header.rows, header.cols)) {
+        return false;
+    }
+    m_board = std::move(storage);
+    setDimensions(header.rows, header.cols);
+    m_mineCount = header.mines;
+    m_firstClickPolicy = FirstClickPolicy(header.policy);
+    m_layoutCertified = false;  //存档不记录布局是否经过验证
+    m_seed = header.seed;
+    m_rng.reseed(m_seed);  //还没有布雷的一局，之后的布雷与用这个种子开始的新游戏完全相同
+    m_gameState = GameState(header.state);
+    m_revealedCount = header.revealed;
+    m_flagCount = header.flags;
+    m_countersChecked = false;  //文件头中的计数器还没有与格子核对过，见recountLoadedCounters
+    m_changedCells.clear();
+    m_floodStack.clear();
+    return true;
+}
+
+//recountLoadedCounters的实现
+void Board::recountLoadedCounters() {
+    //读档时没有读入格子，文件头中的计数器可能与格子不符（文件损坏或被改动过），那样胜利判断就会出错
+    //所以在第一次操作之前以格子为准全盘统计一次，之后计数器照常增量维护
+    int flags = 0;
+    int revealed = 0;
+    int mines = 0;
+    for (int r = 0; r < m_rows; ++r) {
+        const std::uint8_t *rowBits = m_board.data() + indexOf(r, 0);
+        for (int c = 0; c < m_cols; ++c) {
+            flags += (rowBits[c] & CellBits::Flagged) != 0;
+            revealed += (rowBits[c] & (CellBits::Revealed | CellBits::Mine)) == CellBits::Revealed;
+            mines += rowBits[c] & CellBits::Mine;
+        }
+    }
+    m_flagCount = flags;
+    m_revealedCount = revealed;
+    //已经有地雷的棋盘不会再布雷，地雷数以格子中实际的地雷为准
+    if (mines > 0) {
+        m_mineCount = mines;
+        if (m_gameState == GameState::Ready) m_gameState = GameState::Playing;
+    }
+    m_countersChecked = true;
+}
+
+//getCell的实现
+Cell Board::getCell(int row, int col) const {
+    //把1字节的紧凑编码解码成Cell结构体返回
+    const std::uint8_t bits = m_board[indexOf(row, col)];
+    Cell cell;
+    cell.isMine = bits & CellBits::Mine;
+    cell.isRevealed = bits & CellBits::Revealed;
+    cell.isFlagged = bits & CellBits::Flagged;
+    cell.adjacentMines = adjacentOf(bits);
+    return cell;
+}
+
+//getPercentCleared的实现
+double Board::getPercentCleared() const {
+    const int safeCells = m_rows * m_cols - m_mineCount;
+    //没有任何非地雷格子的棋盘（例如0x0）视为0%
+    return safeCells > 0 ? 100.0 * m_revealedCount / safeCells : 0.0;
+}
+
+//validateCounters的实现
+void Board::validateCounters() const {
+#ifndef NDEBUG
+    int flags = 0;
+    int revealed = 0;
+    //遍历整个棋盘，重新统计旗帜数和已翻开的非地雷格子数（失败时被踩中的地雷虽然已翻开，但不计入）
+    for (int r = 0; r < m_rows; ++r) {
+        const std::uint8_t *rowBits = m_board.data() + indexOf(r, 0);
+        for (int c = 0; c < m_cols; ++c) {
+            flags += (rowBits[c] & CellBits::Flagged) != 0;
+            revealed += (rowBits[c] & (CellBits::Revealed | CellBits::Mine)) == CellBits::Revealed;
+        }
+    }
+    assert(flags == m_flagCount && "flag counter out of sync");
+    assert(revealed == m_revealedCount && "revealed counter out of sync");
+#endif
+}
+
+//连锁翻开空白区域的实现
+//使用显式的工作栈代替递归：递归深度会随空白区域的大小线性增长，在大而稀疏的棋盘上会直接把调用栈撑爆
+void Board::revealEmptyAdjacentCells(int startIndex) {
+    MINESWEEPER_PROFILE_SCOPE(ProfileZone::FloodReveal);
+    std::uint8_t *board = m_board.data();
+    //每个格子在入栈前就已被标记为“已翻开”，所以同一个格子最多入栈一次，栈的大小不会超过棋盘格子数
+    //工作栈是成员变量，清空后保留容量，多次点击之间重复使用同一块内存
+    m_floodStack.clear();
+    m_floodStack.push_back(startIndex);
+
+    while (!m_floodStack.empty()) {
+        const int index = m_floodStack.back();
+        m_floodStack.pop_back();
+        //遍历周围8个格子，外围哨兵格子被视为“已翻开”，会被下面的条件自然地跳过，所以不需要边界检查
+        for (int offset : m_neighborOffsets) {
+            const int neighbor = index + offset;
+            std::uint8_t &bits = board[neighbor];
+            //只处理未被翻开、未被标记、也不是雷的格子（空白格周围本就不会有雷，这里只是再确认一次）
+            if (bits & (CellBits::Revealed | CellBits::Flagged | CellBits::Mine)) continue;
+            bits |= CellBits::Revealed;  //翻开它
+            m_revealedCount++;
+            m_changedCells.push_back(neighbor);
+            //如果新翻开的格子也是空白格，则把它加入工作栈，稍后以它为中心继续向外扩展
+            if (adjacentOf(bits) == 0) {
+                m_floodStack.push_back(neighbor);
+            }
+        }
+    }
+}
+
+//convertChangedCells的实现
+void Board::convertChangedCells() {
+    //内部记录的是m_board中的下标（含哨兵），对外统一换算成行优先的一维编号 row * cols + col
+    for (int &cell : m_changedCells) {
+        cell = (cell / m_stride - 1) * m_cols + (cell % m_stride - 1);
+    }
+}
+
+//检查坐标是否有效的实现
+bool Board::isValid(int row, int col) const {
+    return row >= 0 && row < m_rows && col >= 0 && col < m_cols;
+}
\ No newline at end of file
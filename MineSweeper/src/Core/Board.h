@@ -0,0 +1,221 @@
+#ifndef MINESWEEPER_BOARD_H
+#define MINESWEEPER_BOARD_H
+
+/*
+Board是扫雷的核心规则引擎，只使用标准C++20，不依赖Qt（没有QObject、信号/槽和MOC）
+它负责管理棋盘状态、地雷位置、胜负判断等所有核心规则，可以直接用于命令行工具、服务器上的批量模拟等没有界面和事件循环的场景
+GUI程序中的GameModel只是它外面的一层QObject适配器，把每次操作的结果转换成Qt信号
+*/
+
+#include <array>  //包含std::array，用于存放固定的8个邻居偏移量
+#include <atomic>  //包含std::atomic，用作生成不需要猜的布局时的取消标志
+#include <cstdint>  //包含固定宽度的整数类型
+#include <string>  //包含std::string，用于存档文件的路径
+#include <vector>  //包含std::vector
+#include "BoardStorage.h"  //包含存放格子字节的连续内存（堆上，或者映射进来的存档文件）
+#include "RandomEngine.h"  //包含布雷使用的快速、可复现的伪随机数生成器
+
+//定义了单个格子的所有状态信息，是格子数据对外展示的“解码视图”
+//棋盘内部并不直接存储Cell，而是存储下面CellBits描述的1字节紧凑编码，getCell会把它解码成Cell返回
+struct Cell {
+    bool isMine = false;  //标记这个格子是否是地雷
+    bool isRevealed = false;  //标记这个格子是否已被玩家翻开
+    bool isFlagged = false;  //标记这个格子是否已被玩家插上旗帜
+    int adjacentMines = 0;  //存储该格子周围8个相邻格子中的地雷总数
+};
+
+//棋盘在内存中的紧凑编码：每个格子只占1个字节
+//低4位是状态标志位，高4位存放该格子周围的地雷数（0~8，地雷格子自身也会记录，但不会被显示）
+namespace CellBits {
+    constexpr std::uint8_t Mine = 0x01;  //是地雷
+    constexpr std::uint8_t Revealed = 0x02;  //已翻开
+    constexpr std::uint8_t Flagged = 0x04;  //已插旗
+    constexpr std::uint8_t Guard = 0x08;  //棋盘外围一圈的哨兵格子，不属于真实棋盘，只用来省去邻居访问时的边界检查
+    constexpr int CountShift = 4;  //周围地雷数在字节中的起始位
+    constexpr std::uint8_t CountMask = 0xF0;  //周围地雷数所占的位
+}
+
+//定义了游戏可能处于的几种状态
+enum class GameState {
+    Ready,  //准备状态：游戏已初始化，但玩家还未进行第一次点击
+    Playing,  //进行中状态：玩家已开始点击，游戏正在进行中
+    Won,  //胜利状态：玩家成功翻开所有非地雷格子，游戏胜利
+    Lost  //失败状态玩家点到了地雷，游戏失败
+};
+
+//定义了首次点击时对玩家的保护策略，决定布雷时哪些格子必须留空
+enum class FirstClickPolicy {
+    SafeCell,  //只保证首次点击的格子本身不是雷（经典规则）
+    SafeArea,  //保证首次点击的格子及其周围3x3区域都不是雷，首次点击必然打开一片空白区域（地雷过多放不下时退回SafeCell）
+    NoGuess  //在SafeArea的基础上，保证从首次点击开始只靠逻辑推理（不需要猜）就能翻开所有非地雷格子，见NoGuessGenerator（生成器应付不了的棋盘退回SafeArea）
+};
+
+//Board类是一局扫雷游戏的全部数据和规则
+//每个改变棋盘的操作都返回是否真的改变了什么，被改变的格子可以在操作之后通过getChangedCells()取得
+class Board {
+public:
+    //布雷使用的随机数生成器类型，替换成任何满足UniformRandomBitGenerator要求的64位生成器即可更换算法
+    using RandomEngine = Xoshiro256StarStar;
+
+    //--- 操作 ---
+
+    //使用指定的64位种子开始一局新游戏：同样的参数、种子和首次点击位置，总是生成逐位相同的棋盘
+    //地雷数会被限制在[0, rows*cols-1]范围内；policy决定首次点击时需要留空的区域，
+    //NoGuessGenerator::canGenerate不允许的棋盘上NoGuess会被换成SafeArea（用getFirstClickPolicy()可以知道实际的策略）
+    void startGame(int rows, int cols, int mines, std::uint64_t seed, FirstClickPolicy policy = FirstClickPolicy::SafeCell);
+
+    //以给定的地雷布局开始一局：isMine按行优先存放每个格子是否是雷，seed和policy只作为本局的记录
+    //地雷已经布好，游戏直接进入进行中状态，第一次翻开时不会再布雷（用于验证生成的布局，以及在测试中构造特定的棋盘）
+    void loadLayout(int rows, int cols, const std::vector<std::uint8_t> &isMine, std::uint64_t seed = 0,
+                    FirstClickPolicy policy = FirstClickPolicy::SafeCell);
+
+    //在首次翻开之前为本局指定现成的地雷布局（例如从BoardPool中取出的布局），之后首次翻开时不再布雷；已插的旗帜保持不变
+    //布局中地雷数必须等于本局的地雷数，seed记录为本局的种子，certified记录NoGuess布局是否经过求解器验证；不处于准备状态时不做任何事并返回false
+    bool presetLayout(const std::vector<std::uint8_t> &isMine, std::uint64_t seed, bool certified = false);
+
+    //按首次点击的位置布雷但不翻开任何格子，游戏进入进行中状态，之后的revealCell照常进行
+    //只在准备状态下有效，返回是否布了雷；revealCell在首次翻开时调用的就是它，单独调用可以只生成棋盘或者单独测量布雷的耗时
+    //NoGuess布局的生成被取消时（见setGeneratorCancelFlag）不布雷，仍然处于准备状态并返回false
+    bool layMines(int firstRow, int firstCol);
+
+    //NoGuess策略下布雷时生成器使用的线程数，默认是1（在调用者线程中生成）；0表示使用全部硬件线程
+    void setGeneratorThreads(int threads) { m_generatorThreads = threads; }
+
+    //NoGuess策略下布雷时检查的取消标志，可以为空；它变为true时生成器尽快放弃，这次布雷（以及引发它的翻开）不做任何事
+    //标志由调用者拥有，必须比使用它的这个Board（及其副本）的布雷活得更久
+    void setGeneratorCancelFlag(const std::atomic<bool> *cancel) { m_generatorCancel = cancel; }
+
+    //翻开一个格子（首次翻开时才布雷），返回棋盘是否发生了变化
+    bool revealCell(int row, int col);
+
+    //标记/取消标记一个格子，返回棋盘是否发生了变化
+    bool flagCell(int row, int col);
+
+    //在已翻开的数字格上“双击”：当该格子周围的旗帜数恰好等于它的数字时，一次性翻开周围所有未插旗的格子（包括由此引发的连锁翻开）
+    //旗帜数不符时不做任何事，返回棋盘是否发生了变化
+    bool chordCell(int row, int col);
+
+    //把other中cells列出的格子（行优先编号）以及计数器和游戏状态复制过来，getChangedCells()随之变为cells
+    //两个棋盘必须是同一局（先用赋值整体复制一次），用于在另一个线程中以与改变量成正比的代价维护棋盘的镜像
+    void syncFrom(const Board &other, const std::vector<int> &cells);
+
+    //把cells（行优先编号）中每个格子的bit位（CellBits::Revealed或CellBits::Flagged）取反，同时增量更新计数器，并把游戏状态设为state
+    //用于撤销和重做一次操作（见UndoHistory），代价与cells的大小成正比；getChangedCells()随之变为cells，
+    //进入或离开失败状态时还包含其余的地雷格子（它们的显示随之改变）
+    //已经布雷的棋盘不会回到准备状态：state为Ready而棋盘已布雷时改为Playing，地雷布局保持不变
+    void toggleCells(const std::vector<int> &cells, std::uint8_t bit, GameState state);
+
+    //--- 存档 ---
+    //存档文件的第0页（4096字节）是文件头（格式版本、行列数、地雷数、计数器、游戏状态、种子），之后是与内存中逐字节相同的格子
+    //读档时文件以写时复制的方式被映射进来直接作为棋盘的存储，所以读档的耗时与棋盘大小无关，格子所在的页面在第一次被访问时才从磁盘读入
+
+    //保存到文件：把文件头和整个棋盘写进临时文件，再用它替换path，返回是否成功
+    //path可以就是当前读档的那个文件（包括同一个文件的不同写法），正在使用的棋盘不受影响；保存之后的操作不会改变文件
+    bool saveToFile(const std::string &path);
+
+    //映射存档文件作为棋盘的存储，继续其中保存的那一局：只读取并检查文件头和外围一圈哨兵格子
+    //之后的操作只改变内存中的棋盘，不会修改存档文件；文件头中的计数器在第一次操作之前与格子核对
+    //文件不存在或格式不对时棋盘保持不变并返回false
+    bool loadFromFile(const std::string &path);
+
+    //棋盘是否直接映射着读档的那个文件（开始新的一局之后不再映射）
+    bool isFileBacked() const { return m_board.isMapped(); }
+
+    //--- Getters (访问器) ---
+    int getRows() const { return m_rows; }  //返回棋盘的行数
+    int getCols() const { return m_cols; }  //返回棋盘的列数
+    int getMineCount() const { return m_mineCount; }  //返回总地雷数
+    int getFlagCount() const { return m_flagCount; }  //返回当前已标记旗帜的数量
+    int getRevealedCount() const { return m_revealedCount; }  //返回已翻开的非地雷格子数量
+    int getRemainingSafeCount() const { return m_rows * m_cols - m_mineCount - m_revealedCount; }  //返回尚未翻开的非地雷格子数量
+    double getPercentCleared() const;  //返回已翻开的非地雷格子占全部非地雷格子的百分比（0~100）
+    Cell getCell(int row, int col) const;  //返回指定位置格子解码后的副本
+    GameState getGameState() const { return m_gameState; }  //返回当前的游戏状态
+    FirstClickPolicy getFirstClickPolicy() const { return m_firstClickPolicy; }  //返回本局的首次点击保护策略
+    //NoGuess布局是否经过求解器验证：生成器在尝试上限内没有找到不需要猜的布局时退回普通的SafeArea布局，此时为false
+    //其他策略、尚未布雷以及读档得到的一局都是false
+    bool isLayoutCertified() const { return m_layoutCertified; }
+    std::uint64_t getSeed() const { return m_seed; }  //返回本局布雷使用的种子
+
+    //返回第row行第一个格子的1字节编码（编码见CellBits），一行的getCols()个格子在内存中是连续的
+    //供需要整行批量读取格子的代码（例如BitPlanes）使用，避免逐个格子调用getCell；棋盘被修改后指针仍然有效，但重新开局后失效
+    const std::uint8_t *getRowBits(int row) const { return m_board.data() + indexOf(row, 0); }
+
+    //最近一次改变了棋盘的操作所改变的全部格子，每个元素是行优先的一维编号 row * getCols() + col
+    //失败时还包含所有地雷格子；下一次操作开始时会被清空重写
+    const std::vector<int> &getChangedCells() const { return m_changedCells; }
+
+private:
+    //--- 私有辅助函数 ---
+
+    //在玩家首次点击后，根据点击位置和首次点击保护策略，等概率地随机布置地雷（耗时与地雷数成正比）
+    template <typename Engine>
+    void placeMines(Engine &engine, int firstClickRow, int firstClickCol);
+
+    //按行优先的isMine放置全部地雷并计算周围地雷数，不改变其他状态
+    void placeLayout(const std::vector<std::uint8_t> &isMine);
+
+    //在m_board[index]处放置一颗地雷，并立即把它计入8个邻居的周围地雷数（稀疏棋盘的增量计算方式）
+    void addMine(int index);
+
+    //对整个棋盘重新计算每个格子周围的地雷数量（密集棋盘的批量计算方式，使用SIMD一次处理一整段格子）
+    void calculateAdjacentMines();
+
+    //翻开m_board[index]处的格子并记入m_changedCells，踩到地雷时把游戏状态设为失败，翻开空白格时连锁翻开相连区域
+    //调用者负责保证该格子未翻开、未插旗，并在整个操作结束后调用finishReveal
+    void revealIndex(int index);
+
+    //一次翻开操作（单击或双击）结束后的收尾：失败时把所有地雷记为已改变，检查胜利条件，并把m_changedCells换算成行优先编号
+    void finishReveal();
+
+    //当玩家点开一个空白格（周围没有地雷）时，自动翻开与它相连的整片空白区域及其边缘的数字格
+    //参数是该空白格在m_board中的下标，内部使用显式工作栈迭代展开，不会因区域过大而栈溢出
+    void revealEmptyAdjacentCells(int startIndex);
+
+    //把m_changedCells中m_board的下标（含哨兵）就地换算成行优先的一维编号
+    void convertChangedCells();
+
+    //设置棋盘的行列数，并据此算出一行的字节数和8个邻居的偏移量
+    void setDimensions(int rows, int cols);
+
+    //读档之后的第一次操作之前，以格子为准重新统计计数器（文件头中的计数器不一定可信）；每个改变棋盘的操作开头都调用它
+    void ensureCountersChecked() {
+        if (!m_countersChecked) recountLoadedCounters();
+    }
+    void recountLoadedCounters();
+
+    //调试版本中全盘重新统计旗帜数和已翻开格子数，并与增量维护的计数器对比，不一致时断言失败
+    //发布版本（定义了NDEBUG）中是空函数，不产生任何开销
+    void validateCounters() const;
+
+    //检查给定的坐标是否在棋盘的有效范围内
+    bool isValid(int row, int col) const;
+
+    //把行列坐标换算成m_board中的下标（棋盘四周各有一圈哨兵格子，所以行列都要偏移1）
+    int indexOf(int row, int col) const { return (row + 1) * m_stride + (col + 1); }
+
+    //从格子的1字节编码中取出周围地雷数
+    static int adjacentOf(std::uint8_t bits) { return bits >> CellBits::CountShift; }
+
+    //--- 核心数据成员 ---
+    int m_rows = 0;  //棋盘的行数
+    int m_cols = 0;  //棋盘的列数
+    int m_mineCount = 0;  //游戏设定的地雷总数
+    FirstClickPolicy m_firstClickPolicy = FirstClickPolicy::SafeCell;  //本局的首次点击保护策略
+    std::uint64_t m_seed = 0;  //本局布雷使用的种子
+    RandomEngine m_rng;  //布雷使用的随机数生成器，每局开始时用m_seed重置
+    bool m_layoutCertified = false;  //本局的NoGuess布局是否经过求解器验证
+    int m_generatorThreads = 1;  //NoGuess布局的生成器使用的线程数
+    const std::atomic<bool> *m_generatorCancel = nullptr;  //NoGuess布局的生成器检查的取消标志，可以为空
+    int m_stride = 0;  //m_board中一行所占的字节数（列数+左右两个哨兵格子）
+    BoardStorage m_board;  //按行连续存储的整个棋盘（含外围哨兵），每个格子1字节，编码见CellBits；可以是映射进来的存档文件
+    std::array<int, 8> m_neighborOffsets{};  //8个相邻格子相对于当前格子在m_board中的下标偏移量
+    std::vector<int> m_floodStack;  //连锁翻开时使用的工作栈，作为成员在多次点击之间复用，避免反复分配内存
+    std::vector<int> m_changedCells;  //最近一次操作改变了的格子
+    GameState m_gameState = GameState::Ready;  //当前游戏所处的状态
+    int m_revealedCount = 0;  //已经翻开的非地雷格子计数，用于快速判断胜利条件
+    int m_flagCount = 0;  //当前已插旗的格子计数，在插旗/取消插旗时增量维护
+    bool m_countersChecked = true;  //计数器是否与格子一致；读档之后在第一次操作之前为false
+};
+
+#endif //MINESWEEPER_BOARD_H
@@ -0,0 +1,205 @@
+#include "BoardPool.h"
+#include <algorithm>  //包含std::max
+#include "NoGuessGenerator.h"
+#include "Profiler.h"  //包含Profiler::MutedThread
+
+namespace {
+//由池的种子和布局编号派生出每个布局的种子（SplitMix64）
+std::uint64_t layoutSeed(std::uint64_t seed, std::uint64_t generation) {
+    std::uint64_t z = seed + (generation + 1) * 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+}
+
+//构造函数的实现：启动后台线程，它们在configure之前一直处于等待状态
+BoardPool::BoardPool(std::uint64_t seed, int threads, int capacity)
+    : m_capacity(std::max(1, capacity)), m_seed(seed) {
+    threads = std::max(1, threads);
+    m_cancel = std::make_unique<std::atomic<bool>[]>(threads);
+    for (int worker = 0; worker < threads; ++worker) {
+        m_workers.emplace_back(&BoardPool::run, this, worker);
+    }
+}
+
+//析构函数的实现
+BoardPool::~BoardPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+        for (std::size_t worker = 0; worker < m_workers.size(); ++worker) m_cancel[worker] = true;
+    }
+    m_wake.notify_all();
+    for (std::thread &worker : m_workers) worker.join();
+}
+
+//设置棋盘的实现
+void BoardPool::configure(const Key &key) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (key == m_key) return;
+        m_key = key;
+        ++m_epoch;
+        m_stats.discarded += m_queue.size();
+        m_queue.clear();
+        //正在为旧设置生成的布局尽快停止，完成时会因为m_epoch已经改变而被丢弃
+        for (std::size_t worker = 0; worker < m_workers.size(); ++worker) m_cancel[worker] = true;
+    }
+    m_wake.notify_all();
+}
+
+//取出布局的实现
+bool BoardPool::take(const Key &key, int firstRow, int firstCol, Layout &layout) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (key == m_key) {
+        for (auto entry = m_queue.begin(); entry != m_queue.end(); ++entry) {
+            //依次尝试原样、上下翻转、左右翻转、旋转180度；翻转不改变地雷数，也不改变“不需要猜”的性质
+            for (int flip = 0; flip < 4; ++flip) {
+                const auto mapRow = [&](int row) { return flip & 1 ? key.rows - 1 - row : row; };
+                const auto mapCol = [&](int col) { return flip & 2 ? key.cols - 1 - col : col; };
+                if (!fits(key, *entry, mapRow(firstRow), mapCol(firstCol))) continue;
+
+                layout.isMine.resize(entry->isMine.size());
+                for (int r = 0; r < key.rows; ++r) {
+                    for (int c = 0; c < key.cols; ++c) {
+                        layout.isMine[r * key.cols + c] = entry->isMine[mapRow(r) * key.cols + mapCol(c)];
+                    }
+                }
+                layout.seed = entry->seed;
+                layout.certified = entry->certified;
+                m_queue.erase(entry);
+                ++m_stats.hits;
+                lock.unlock();
+                m_wake.notify_one();  //队列腾出了空位，唤醒一个后台线程补充
+                return true;
+            }
+        }
+    }
+    ++m_stats.misses;
+    return false;
+}
+
+//返回统计数据的实现
+BoardPool::Stats BoardPool::stats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+//返回队列长度的实现
+int BoardPool::size() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return int(m_queue.size());
+}
+
+//后台线程主循环的实现
+void BoardPool::run(int worker) {
+    const Profiler::MutedThread muted;  //后台预先生成布局的开销不计入玩家操作的统计
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        //背压：队列（连同正在生成的布局）满了就等待，直到有布局被取走或者设置改变
+        m_wake.wait(lock, [&]() {
+            return m_stopping || (m_key.rows > 0 && int(m_queue.size()) + m_inFlight < m_capacity);
+        });
+        if (m_stopping) return;
+
+        const Key key = m_key;
+        const std::uint64_t epoch = m_epoch;
+        const std::uint64_t seed = layoutSeed(m_seed, m_generation++);
+        m_cancel[worker] = false;
+        ++m_inFlight;
+        lock.unlock();
+
+        Entry entry = generate(key, seed, &m_cancel[worker]);
+
+        lock.lock();
+        --m_inFlight;
+        if (epoch != m_epoch || entry.isMine.empty()) {
+            ++m_stats.discarded;
+            continue;
+        }
+        m_queue.push_back(std::move(entry));
+        ++m_stats.generated;
+    }
+}
+
+//生成布局的实现
+BoardPool::Entry BoardPool::generate(const Key &key, std::uint64_t seed, const std::atomic<bool> *cancel) {
+    Entry entry;
+    entry.seed = seed;
+    const int firstRow = key.rows / 2;
+    const int firstCol = key.cols / 2;
+    if (key.policy == FirstClickPolicy::NoGuess) {
+        NoGuessGenerator generator(key.rows, key.cols, key.mines, firstRow, firstCol, seed);
+        generator.setThreadCount(1);  //并行度由池的后台线程数决定
+        generator.setCancelFlag(cancel);
+        NoGuessGenerator::Result result = generator.generate();
+        entry.isMine = std::move(result.isMine);
+        entry.certified = result.certified;
+        return entry;
+    }
+
+    Board board;
+    board.startGame(key.rows, key.cols, key.mines, seed, key.policy);
+    board.layMines(firstRow, firstCol);
+    entry.isMine.resize(std::size_t(key.rows) * key.cols);
+    for (int cell = 0; cell < key.rows * key.cols; ++cell) {
+        entry.isMine[cell] = board.getCell(cell / key.cols, cell % key.cols).isMine;
+    }
+    return entry;
+}
+
+//检查布局是否适用的实现
+bool BoardPool::fits(const Key &key, const Entry &entry, int row, int col) {
+    const auto isMine = [&](int r, int c) { return entry.isMine[r * key.cols + c] != 0; };
+    const auto isValid = [&](int r, int c) { return r >= 0 && r < key.rows && c >= 0 && c < key.cols; };
+    if (key.policy == FirstClickPolicy::SafeCell) {
+        return !isMine(row, col);
+    }
+
+    if (key.policy == FirstClickPolicy::NoGuess && entry.certified) {
+        //经过验证的布局从棋盘中央开始不需要猜；点击与中央相连的同一片空白区域中的任何格子都会翻开完全相同的区域，所以同样不需要猜
+        const auto isZero = [&](int r, int c) {
+            if (isMine(r, c)) return false;
+            for (int nr = r - 1; nr <= r + 1; ++nr) {
+                for (int nc = c - 1; nc <= c + 1; ++nc) {
+                    if (isValid(nr, nc) && isMine(nr, nc)) return false;
+                }
+            }
+            return true;
+        };
+        const int start = (key.rows / 2) * key.cols + key.cols / 2;
+        const int target = row * key.cols + col;
+        if (start == target) return true;
+        if (!isZero(row, col) || !isZero(key.rows / 2, key.cols / 2)) return false;
+        std::vector<std::uint8_t> visited(entry.isMine.size(), 0);
+        std::vector<int> stack(1, start);
+        visited[start] = 1;
+        while (!stack.empty()) {
+            const int cell = stack.back();
+            stack.pop_back();
+            if (cell == target) return true;
+            for (int r = cell / key.cols - 1; r <= cell / key.cols + 1; ++r) {
+                for (int c = cell % key.cols - 1; c <= cell % key.cols + 1; ++c) {
+                    if (!isValid(r, c) || visited[r * key.cols + c] || !isZero(r, c)) continue;
+                    visited[r * key.cols + c] = 1;
+                    stack.push_back(r * key.cols + c);
+                }
+            }
+        }
+        return false;
+    }
+
+    //SafeArea（以及没能通过验证的NoGuess布局）：与Board::placeMines相同，首次点击周围3x3放不下时只要求首次点击的格子本身不是雷
+    int excludedCount = 0;
+    for (int r = row - 1; r <= row + 1; ++r) {
+        for (int c = col - 1; c <= col + 1; ++c) excludedCount += isValid(r, c);
+    }
+    const int radius = key.mines > key.rows * key.cols - excludedCount ? 0 : 1;
+    for (int r = row - radius; r <= row + radius; ++r) {
+        for (int c = col - radius; c <= col + radius; ++c) {
+            if (isValid(r, c) && isMine(r, c)) return false;
+        }
+    }
+    return true;
+}
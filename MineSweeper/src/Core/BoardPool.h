@@ -0,0 +1,107 @@
+#ifndef MINESWEEPER_BOARDPOOL_H
+#define MINESWEEPER_BOARDPOOL_H
+
+/*
+BoardPool是预先生成地雷布局的后台服务，属于不依赖Qt的核心库
+不需要猜的棋盘、超大棋盘等模式的布雷比较耗时，如果在首次点击时才同步生成，玩家会明显感觉到卡顿
+BoardPool用后台线程为当前的棋盘设置（行数、列数、地雷数、首次点击策略）提前生成若干个布局放在有界队列中，首次点击时直接取用
+
+- 背压：队列满了以后后台线程就停下来等待，直到有布局被取走
+- 取消：棋盘设置改变时丢弃队列中的全部布局，正在生成的布局也会尽快停止并被丢弃
+- 统计：记录取用时的命中/未命中次数，以及生成和丢弃的布局数
+
+布局在首次点击之前生成，所以假定首次点击在棋盘中央（这也是Solver在准备状态下给出的提示），
+取用时再检查布局对实际的点击位置是否仍然成立（必要时把布局水平/垂直翻转），不成立时算作未命中，由调用者照常同步生成
+*/
+
+#include <atomic>  //包含std::atomic，用作后台线程的取消标志
+#include <condition_variable>  //包含std::condition_variable，用于唤醒等待的后台线程
+#include <cstdint>  //包含固定宽度的整数类型
+#include <deque>  //包含std::deque，用作布局队列
+#include <memory>  //包含std::unique_ptr
+#include <mutex>  //包含std::mutex
+#include <thread>  //包含std::thread
+#include <vector>  //包含std::vector
+#include "Board.h"  //包含FirstClickPolicy
+
+class BoardPool {
+public:
+    //决定布局能否通用的棋盘设置
+    struct Key {
+        int rows = 0;
+        int cols = 0;
+        int mines = 0;
+        FirstClickPolicy policy = FirstClickPolicy::SafeCell;
+
+        bool operator==(const Key &other) const = default;
+    };
+
+    //取出的布局
+    struct Layout {
+        std::vector<std::uint8_t> isMine;  //按行优先存放每个格子是否是雷，可以直接交给Board::presetLayout
+        std::uint64_t seed = 0;  //生成它使用的种子（布局可能经过翻转，所以只作为记录，不保证能用它复现）
+        bool certified = false;  //NoGuess策略下是否经过求解器验证，可以直接交给Board::presetLayout
+    };
+
+    //统计数据
+    struct Stats {
+        std::uint64_t hits = 0;  //取用成功的次数
+        std::uint64_t misses = 0;  //取用时没有合适布局的次数
+        std::uint64_t generated = 0;  //生成并放入队列的布局数
+        std::uint64_t discarded = 0;  //因设置改变而丢弃的布局数（包括生成到一半被取消的）
+    };
+
+    //seed决定后台生成布局使用的种子序列；threads是后台线程数，capacity是队列中最多保存的布局数
+    explicit BoardPool(std::uint64_t seed, int threads = 1, int capacity = 4);
+
+    //停止并等待所有后台线程
+    ~BoardPool();
+
+    BoardPool(const BoardPool &) = delete;
+    BoardPool &operator=(const BoardPool &) = delete;
+
+    //设置需要预先生成的棋盘；与当前设置不同时丢弃已有的布局并取消正在进行的生成，相同时什么也不做
+    void configure(const Key &key);
+
+    //取出一个适用于key和首次点击位置的布局，成功时写入layout并返回true；不会阻塞等待生成
+    bool take(const Key &key, int firstRow, int firstCol, Layout &layout);
+
+    //返回统计数据
+    Stats stats() const;
+
+    //返回队列中现有的布局数
+    int size() const;
+
+private:
+    //队列中的一个布局
+    struct Entry {
+        std::vector<std::uint8_t> isMine;
+        std::uint64_t seed = 0;
+        bool certified = false;  //NoGuess策略下是否经过求解器验证
+    };
+
+    //后台线程的主循环，worker是线程编号
+    void run(int worker);
+
+    //为key生成一个首次点击在棋盘中央的布局；被取消时返回空的isMine
+    static Entry generate(const Key &key, std::uint64_t seed, const std::atomic<bool> *cancel);
+
+    //检查以(row, col)为首次点击位置时，entry的布局是否满足key的首次点击策略
+    static bool fits(const Key &key, const Entry &entry, int row, int col);
+
+    mutable std::mutex m_mutex;  //保护以下所有成员
+    std::condition_variable m_wake;  //设置改变、布局被取走或需要停止时唤醒后台线程
+    Key m_key;  //当前的棋盘设置，行数为0表示尚未设置
+    std::uint64_t m_epoch = 0;  //设置改变的次数，生成完成时与开始时不同就说明结果已经过期
+    std::deque<Entry> m_queue;  //已生成的布局
+    int m_capacity;
+    int m_inFlight = 0;  //正在生成中的布局数，与队列长度一起计入容量
+    std::uint64_t m_seed;
+    std::uint64_t m_generation = 0;  //已经开始生成的布局数，用于为每个布局派生种子
+    Stats m_stats;
+    bool m_stopping = false;
+    std::unique_ptr<std::atomic<bool>[]> m_cancel;  //每个后台线程的取消标志
+    std::vector<std::thread> m_workers;
+};
+
+#endif //MINESWEEPER_BOARDPOOL_H
@@ -0,0 +1,136 @@
+#include "BoardStorage.h"
+#include <utility>  //包含std::exchange
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>  //CreateFileMapping、MapViewOfFile
+#else
+#include <fcntl.h>  //open
+#include <sys/mman.h>  //mmap、munmap
+#include <sys/stat.h>  //fstat
+#include <unistd.h>  //close
+#endif
+
+//析构函数的实现
+BoardStorage::~BoardStorage() {
+    unmap();
+}
+
+//复制构造函数的实现
+BoardStorage::BoardStorage(const BoardStorage &other)
+    : m_heap(other.m_data, other.m_data + other.m_size), m_data(m_heap.data()), m_size(other.m_size) {}
+
+//复制赋值的实现
+BoardStorage &BoardStorage::operator=(const BoardStorage &other) {
+    if (this == &other) return *this;
+    unmap();
+    //大小相同时（例如每帧同步的镜像棋盘）直接覆盖，不重新分配内存
+    m_heap.assign(other.m_data, other.m_data + other.m_size);
+    m_data = m_heap.data();
+    m_size = other.m_size;
+    return *this;
+}
+
+//移动构造函数的实现
+BoardStorage::BoardStorage(BoardStorage &&other) noexcept {
+    *this = std::move(other);
+}
+
+//移动赋值的实现
+BoardStorage &BoardStorage::operator=(BoardStorage &&other) noexcept {
+    if (this == &other) return *this;
+    unmap();
+    //移动vector不会改变它的缓冲区地址，所以m_data仍然有效
+    m_heap = std::move(other.m_heap);
+    m_data = std::exchange(other.m_data, nullptr);
+    m_size = std::exchange(other.m_size, 0);
+    m_mapping = std::exchange(other.m_mapping, nullptr);
+    m_mappingSize = std::exchange(other.m_mappingSize, 0);
+#ifdef _WIN32
+    m_file = std::exchange(other.m_file, nullptr);
+    m_fileMapping = std::exchange(other.m_fileMapping, nullptr);
+#else
+    m_file = std::exchange(other.m_file, -1);
+#endif
+    return *this;
+}
+
+//assign的实现
+void BoardStorage::assign(std::size_t size, std::uint8_t value) {
+    unmap();
+    m_heap.assign(size, value);
+    m_data = m_heap.data();
+    m_size = size;
+}
+
+//映射文件的实现
+bool BoardStorage::mapFile(const std::string &path, std::size_t offset, std::size_t size) {
+    const std::size_t required = offset + size;
+    //文件只以只读方式打开，写时复制的映射保证对格子的修改不会到达文件
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER fileSize{};
+    if (!GetFileSizeEx(file, &fileSize) || std::uint64_t(fileSize.QuadPart) < required) {
+        CloseHandle(file);
+        return false;
+    }
+    const std::uint64_t mappingSize = std::uint64_t(fileSize.QuadPart);
+    HANDLE fileMapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+    void *mapping = fileMapping ? MapViewOfFile(fileMapping, FILE_MAP_COPY, 0, 0, 0) : nullptr;
+    if (!mapping) {
+        if (fileMapping) CloseHandle(fileMapping);
+        CloseHandle(file);
+        return false;
+    }
+#else
+    const int file = ::open(path.c_str(), O_RDONLY);
+    if (file < 0) return false;
+    struct stat status {};
+    if (::fstat(file, &status) != 0 || std::size_t(status.st_size) < required) {
+        ::close(file);
+        return false;
+    }
+    const std::size_t mappingSize = std::size_t(status.st_size);
+    void *mapping = ::mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+    if (mapping == MAP_FAILED) {
+        ::close(file);
+        return false;
+    }
+#endif
+
+    unmap();
+    m_heap.clear();
+    m_heap.shrink_to_fit();
+    m_mapping = mapping;
+    m_mappingSize = std::size_t(mappingSize);
+    m_file = file;
+#ifdef _WIN32
+    m_fileMapping = fileMapping;
+#endif
+    m_data = static_cast<std::uint8_t *>(mapping) + offset;
+    m_size = size;
+    return true;
+}
+
+//unmap的实现
+void BoardStorage::unmap() {
+    if (!m_mapping) return;
+#ifdef _WIN32
+    UnmapViewOfFile(m_mapping);
+    CloseHandle(m_fileMapping);
+    CloseHandle(m_file);
+    m_fileMapping = nullptr;
+    m_file = nullptr;
+#else
+    ::munmap(m_mapping, m_mappingSize);
+    ::close(m_file);
+    m_file = -1;
+#endif
+    m_mapping = nullptr;
+    m_mappingSize = 0;
+    m_data = nullptr;
+    m_size = 0;
+}
@@ -0,0 +1,68 @@
+#ifndef MINESWEEPER_BOARDSTORAGE_H
+#define MINESWEEPER_BOARDSTORAGE_H
+
+/*
+BoardStorage是Board存放格子字节的连续内存，属于不依赖Qt的核心库
+平时它就是堆上的一块内存；读档时它以写时复制的方式映射存档文件，直接指向文件被映射进地址空间的那一段：
+- 映射本身与文件大小无关，只有被访问到的页面（当前显示的区域、连锁翻开经过的区域）才会由操作系统按需读入
+- 被修改的页面由操作系统复制一份留在本进程的内存中，永远不会写回文件，存档只在玩家明确保存时才会改变
+复制一个映射了文件的BoardStorage得到的是堆上的一份普通副本（例如异步模式下的镜像棋盘）
+*/
+
+#include <cstddef>  //包含std::size_t
+#include <cstdint>  //包含固定宽度的整数类型
+#include <string>  //包含std::string，用于文件路径
+#include <vector>  //包含std::vector，作为堆上的存储
+
+class BoardStorage {
+public:
+    BoardStorage() = default;
+    ~BoardStorage();
+
+    //复制时总是得到堆上的副本
+    BoardStorage(const BoardStorage &other);
+    BoardStorage &operator=(const BoardStorage &other);
+
+    //移动时连同文件映射一起转移
+    BoardStorage(BoardStorage &&other) noexcept;
+    BoardStorage &operator=(BoardStorage &&other) noexcept;
+
+    //--- 与std::vector相同的访问方式，Board的代码不需要关心字节在堆上还是在文件里 ---
+    std::uint8_t *data() { return m_data; }
+    const std::uint8_t *data() const { return m_data; }
+    std::size_t size() const { return m_size; }
+    std::uint8_t &operator[](std::size_t index) { return m_data[index]; }
+    const std::uint8_t &operator[](std::size_t index) const { return m_data[index]; }
+    std::uint8_t *begin() { return m_data; }
+    std::uint8_t *end() { return m_data + m_size; }
+
+    //改为堆上的size个value（已映射的文件会先被解除映射）
+    void assign(std::size_t size, std::uint8_t value);
+
+    //以写时复制的方式映射已有的整个文件，格子字节从文件的offset处开始，共size个，文件不够大时失败
+    //成功时原来的内容被丢弃并返回true；失败时什么也不改变并返回false
+    bool mapFile(const std::string &path, std::size_t offset, std::size_t size);
+
+    //是否映射了文件
+    bool isMapped() const { return m_mapping != nullptr; }
+
+private:
+    //解除文件映射并关闭文件（被修改过的页面随之丢弃）
+    void unmap();
+
+    std::vector<std::uint8_t> m_heap;  //没有映射文件时格子字节存放在这里
+    std::uint8_t *m_data = nullptr;  //格子字节的起始位置：m_heap.data()或者映射中offset处
+    std::size_t m_size = 0;  //格子字节数
+
+    //--- 文件映射 ---
+    void *m_mapping = nullptr;  //映射的起始地址，为空表示没有映射文件
+    std::size_t m_mappingSize = 0;  //映射的字节数（整个文件）
+#ifdef _WIN32
+    void *m_file = nullptr;  //文件句柄
+    void *m_fileMapping = nullptr;  //文件映射对象的句柄
+#else
+    int m_file = -1;  //文件描述符
+#endif
+};
+
+#endif //MINESWEEPER_BOARDSTORAGE_H
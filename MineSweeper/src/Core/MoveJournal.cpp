@@ -0,0 +1,267 @@
+#include "MoveJournal.h"
+#include <algorithm>  //包含std::clamp、std::equal、std::upper_bound
+#include <iterator>  //包含std::begin、std::end
+
+namespace {
+//日志开头的魔数和格式版本
+constexpr std::uint8_t kMagic[3] = {'M', 'S', 'J'};
+constexpr std::uint8_t kVersion = 2;
+//版本1的日志没有撤销和重做，其余格式完全相同，仍然可以重放
+constexpr std::uint8_t kOldestVersion = 1;
+
+//一条记录的varint中表示操作类型的低位数
+constexpr int kMoveBits = 2;
+
+//每局开始时预留的字节数，足够一般的一局使用（每步只有1~3字节），操作时不需要分配内存
+constexpr std::size_t kInitialCapacity = 4096;
+
+//把一个无符号整数以varint编码追加到字节流末尾
+void appendVarint(std::vector<std::uint8_t> &bytes, std::uint64_t value) {
+    while (value >= 0x80) {
+        bytes.push_back(static_cast<std::uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    bytes.push_back(static_cast<std::uint8_t>(value));
+}
+
+//从offset处读出一个varint并把offset移到它后面，字节流提前结束或编码超过64位时返回false
+bool readVarint(const std::vector<std::uint8_t> &bytes, std::size_t &offset, std::uint64_t &value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (offset >= bytes.size()) return false;
+        const std::uint8_t byte = bytes[offset++];
+        value |= std::uint64_t(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+//zigzag编码：把有符号的差值映射成无符号数，绝对值小的差值（无论正负）编码后都很短
+std::uint64_t zigzag(std::int64_t value) {
+    return (std::uint64_t(value) << 1) ^ std::uint64_t(value >> 63);
+}
+
+std::int64_t unzigzag(std::uint64_t value) {
+    return std::int64_t(value >> 1) ^ -std::int64_t(value & 1);
+}
+
+//类型为Layout的记录的其余位：0是布局记录，撤销和重做分别是下面的值
+constexpr std::uint64_t kUndo = 1;
+constexpr std::uint64_t kRedo = 2;
+
+//一条记录的操作类型
+MoveJournal::Move moveOf(std::uint64_t value) {
+    return MoveJournal::Move(value & ((1u << kMoveBits) - 1));
+}
+
+//一步操作翻转的格子位，与GameModel记录撤销时使用的相同
+std::uint8_t bitOf(MoveJournal::Move move) {
+    return move == MoveJournal::Move::Flag ? CellBits::Flagged : CellBits::Revealed;
+}
+}
+
+//开始记录的实现
+void MoveJournal::start(int rows, int cols, int mines, std::uint64_t seed, FirstClickPolicy policy) {
+    m_bytes.clear();  //保留上一局的容量
+    m_bytes.reserve(kInitialCapacity);
+    for (std::uint8_t byte : kMagic) m_bytes.push_back(byte);
+    m_bytes.push_back(kVersion);
+    appendVarint(m_bytes, std::uint64_t(rows));
+    appendVarint(m_bytes, std::uint64_t(cols));
+    appendVarint(m_bytes, std::uint64_t(mines));
+    appendVarint(m_bytes, std::uint64_t(policy));
+    appendVarint(m_bytes, seed);
+    m_cols = cols;
+    m_previousCell = 0;
+    m_moveCount = 0;
+}
+
+//clear的实现
+void MoveJournal::clear() {
+    m_bytes.clear();
+    m_moveCount = 0;
+}
+
+//记录一步操作的实现
+void MoveJournal::record(Move move, int row, int col) {
+    if (m_bytes.empty()) return;  //没有开局记录，后面的操作无法重放
+    const int cell = row * m_cols + col;
+    appendVarint(m_bytes, (zigzag(std::int64_t(cell) - m_previousCell) << kMoveBits) | std::uint64_t(move));
+    m_previousCell = cell;
+    ++m_moveCount;
+}
+
+//记录撤销的实现
+void MoveJournal::recordUndo() {
+    if (m_bytes.empty()) return;
+    appendVarint(m_bytes, (kUndo << kMoveBits) | std::uint64_t(Move::Layout));
+    ++m_moveCount;
+}
+
+//记录重做的实现
+void MoveJournal::recordRedo() {
+    if (m_bytes.empty()) return;
+    appendVarint(m_bytes, (kRedo << kMoveBits) | std::uint64_t(Move::Layout));
+    ++m_moveCount;
+}
+
+//记录布局的实现
+void MoveJournal::recordLayout(const std::vector<std::uint8_t> &isMine, std::uint64_t seed) {
+    if (m_bytes.empty()) return;
+    appendVarint(m_bytes, std::uint64_t(Move::Layout));
+    appendVarint(m_bytes, seed);
+    //地雷数已经写在文件头里，这里只需要依次记录每颗地雷与上一颗之间隔了多少个格子
+    int previous = -1;
+    for (int cell = 0; cell < int(isMine.size()); ++cell) {
+        if (!isMine[cell]) continue;
+        appendVarint(m_bytes, std::uint64_t(cell - previous - 1));
+        previous = cell;
+    }
+}
+
+//JournalReplayer构造函数的实现
+JournalReplayer::JournalReplayer(std::vector<std::uint8_t> bytes, int keyframeInterval)
+    : m_bytes(std::move(bytes)), m_keyframeInterval(std::max(1, keyframeInterval)) {
+    //先完整地解析一遍：检查文件头和每条记录都在合法范围内，同时数出总步数，之后重放时不再需要检查
+    if (m_bytes.size() < 4 || !std::equal(std::begin(kMagic), std::end(kMagic), m_bytes.begin())
+        || m_bytes[3] < kOldestVersion || m_bytes[3] > kVersion) {
+        return;
+    }
+    std::size_t offset = 4;
+    std::uint64_t rows = 0, cols = 0, mines = 0, policy = 0, seed = 0;
+    if (!readVarint(m_bytes, offset, rows) || !readVarint(m_bytes, offset, cols) || !readVarint(m_bytes, offset, mines)
+        || !readVarint(m_bytes, offset, policy) || !readVarint(m_bytes, offset, seed)) {
+        return;
+    }
+    if (rows == 0 || cols == 0 || rows * cols > std::uint64_t(INT32_MAX / 2) || mines >= rows * cols
+        || policy > std::uint64_t(FirstClickPolicy::NoGuess)) {
+        return;
+    }
+    const std::int64_t cells = std::int64_t(rows * cols);
+    const std::size_t headerEnd = offset;
+
+    std::int64_t previousCell = 0;
+    bool afterLayout = false;  //布局记录之后必须紧跟一步操作
+    while (offset < m_bytes.size()) {
+        std::uint64_t value = 0;
+        if (!readVarint(m_bytes, offset, value)) return;
+        if (moveOf(value) == MoveJournal::Move::Layout && (value >> kMoveBits) != 0) {
+            //撤销或重做，布局记录之后必须是一次翻开
+            if (afterLayout || ((value >> kMoveBits) != kUndo && (value >> kMoveBits) != kRedo)) return;
+            m_hasUndo = true;
+            ++m_moveCount;
+            continue;
+        }
+        if (moveOf(value) == MoveJournal::Move::Layout) {
+            if (afterLayout) return;
+            afterLayout = true;
+            std::uint64_t layoutSeed = 0;
+            if (!readVarint(m_bytes, offset, layoutSeed)) return;
+            std::int64_t mine = -1;
+            for (std::uint64_t i = 0; i < mines; ++i) {
+                std::uint64_t gap = 0;
+                if (!readVarint(m_bytes, offset, gap) || gap >= std::uint64_t(cells)) return;
+                mine += std::int64_t(gap) + 1;
+                if (mine >= cells) return;
+            }
+            continue;
+        }
+        previousCell += unzigzag(value >> kMoveBits);
+        if (previousCell < 0 || previousCell >= cells) return;
+        afterLayout = false;
+        ++m_moveCount;
+    }
+
+    //第0步的关键帧就是刚开始的棋盘
+    Cursor start;
+    start.offset = headerEnd;
+    start.board.startGame(int(rows), int(cols), int(mines), seed, FirstClickPolicy(policy));
+    if (m_hasUndo) {
+        //容量不设上限：日志中的每次撤销在录制时都成功了，重放时也必须能撤销
+        start.history.emplace(std::size_t(UINT32_MAX));
+    }
+    m_mineCount = int(mines);
+    m_keyframes.push_back(start);
+    m_cursor = start;
+    m_valid = true;
+
+    //预先重放整个日志并保存全部关键帧，之后跳转到任何位置（包括第一次跳到末尾附近）都最多重放keyframeInterval步
+    Cursor cursor = start;
+    while (cursor.move < m_moveCount) {
+        step(cursor);
+        if (cursor.move % m_keyframeInterval == 0) {
+            m_keyframes.push_back(cursor);
+        }
+    }
+}
+
+//跳转的实现
+const Board &JournalReplayer::seek(int move) {
+    move = std::clamp(move, 0, m_moveCount);
+    //二分查找不晚于目标的最后一个关键帧
+    const auto next = std::upper_bound(m_keyframes.begin(), m_keyframes.end(), move,
+                                       [](int target, const Cursor &keyframe) { return target < keyframe.move; });
+    const Cursor &keyframe = *(next - 1);
+    //当前位置在这个关键帧和目标之间时（例如逐步向后播放），直接从当前位置继续，否则从关键帧开始
+    if (m_cursor.move > move || m_cursor.move < keyframe.move) {
+        m_cursor = keyframe;
+    }
+    while (m_cursor.move < move) {
+        step(m_cursor);
+    }
+    return m_cursor.board;
+}
+
+//执行一步的实现
+void JournalReplayer::step(Cursor &cursor) const {
+    Board &board = cursor.board;
+    std::uint64_t value = 0;
+    readVarint(m_bytes, cursor.offset, value);
+    if (moveOf(value) == MoveJournal::Move::Layout && (value >> kMoveBits) != 0) {
+        if ((value >> kMoveBits) == kUndo) {
+            cursor.history->undo(board);
+        } else {
+            cursor.history->redo(board);
+        }
+        ++cursor.move;
+        return;
+    }
+    if (moveOf(value) == MoveJournal::Move::Layout) {
+        std::uint64_t seed = 0;
+        readVarint(m_bytes, cursor.offset, seed);
+        std::vector<std::uint8_t> isMine(std::size_t(board.getRows()) * board.getCols(), 0);
+        int mine = -1;
+        for (int i = 0; i < m_mineCount; ++i) {
+            std::uint64_t gap = 0;
+            readVarint(m_bytes, cursor.offset, gap);
+            mine += int(gap) + 1;
+            isMine[mine] = 1;
+        }
+        board.presetLayout(isMine, seed);
+        //布局记录后面紧跟着使用它的那次翻开
+        readVarint(m_bytes, cursor.offset, value);
+    }
+
+    cursor.previousCell += int(unzigzag(value >> kMoveBits));
+    const int row = cursor.previousCell / board.getCols();
+    const int col = cursor.previousCell % board.getCols();
+    const GameState before = board.getGameState();
+    bool changed = false;
+    switch (moveOf(value)) {
+    case MoveJournal::Move::Reveal:
+        changed = board.revealCell(row, col);
+        break;
+    case MoveJournal::Move::Flag:
+        changed = board.flagCell(row, col);
+        break;
+    case MoveJournal::Move::Chord:
+        changed = board.chordCell(row, col);
+        break;
+    case MoveJournal::Move::Layout:
+        break;
+    }
+    if (changed && cursor.history) {
+        cursor.history->record(board, bitOf(moveOf(value)), before);
+    }
+    ++cursor.move;
+}
@@ -0,0 +1,111 @@
+#ifndef MINESWEEPER_MOVEJOURNAL_H
+#define MINESWEEPER_MOVEJOURNAL_H
+
+/*
+MoveJournal是一局游戏的只追加的操作日志，属于不依赖Qt的核心库，JournalReplayer可以根据它逐位精确地重建这一局的任意时刻
+
+日志是一段紧凑的二进制字节流，所有整数都使用varint（LEB128，每个字节7位数据，最高位表示后面还有字节）编码：
+- 文件头：魔数"MSJ"和版本号各1字节，然后是行数、列数、地雷数、首次点击策略和布雷种子
+- 之后每次改变了棋盘的操作（翻开、插旗、双击）是一个varint：低2位是操作类型，其余位是这次的格子编号相对上一次的差（zigzag编码）
+  玩家的相邻两次点击通常离得很近，差值很小，9x9的棋盘每步1字节，百万格的棋盘一般也只要1~3字节
+- 首次翻开使用了预先生成的布局（BoardPool）时，布局不能由种子复现，所以在那次翻开之前插入一条布局记录：
+  类型为Layout的varint，布局的种子，然后按行优先的顺序记录每颗地雷与上一颗地雷之间的间隔
+- 撤销和重做（版本2）也是一步操作，类型同样是Layout，其余位为1表示撤销、为2表示重做（布局记录的其余位是0），后面没有其他数据
+布雷完全由种子和首次点击位置决定（包括NoGuess生成器），所以除了来自池的布局以外，日志里不需要保存棋盘本身
+
+记录只是在字节数组末尾追加几个字节，相对于一次翻开或插旗本身的开销可以忽略
+*/
+
+#include <cstddef>  //包含std::size_t
+#include <cstdint>  //包含固定宽度的整数类型
+#include <optional>  //包含std::optional，只在需要时为重放建立撤销记录
+#include <vector>  //包含std::vector，用于存放日志的字节流和关键帧
+#include "Board.h"  //包含Board和FirstClickPolicy
+#include "UndoHistory.h"  //包含撤销记录，用于重放日志中的撤销和重做
+
+class MoveJournal {
+public:
+    //一条记录的类型，占varint的低2位
+    enum class Move : std::uint8_t {
+        Reveal,  //翻开一个格子
+        Flag,  //标记/取消标记一个格子
+        Chord,  //在数字格上双击
+        Layout  //为首次翻开预设的地雷布局，不算作一步操作
+    };
+
+    //开始记录一局新游戏，清空之前的全部记录；参数应当是Board调整之后的值（例如被限制过的地雷数）
+    void start(int rows, int cols, int mines, std::uint64_t seed, FirstClickPolicy policy);
+
+    //清空全部记录，之后的记录都被忽略，直到下一次start（用于从存档中读出、没有开局记录的一局）
+    void clear();
+
+    //记录一次改变了棋盘的操作（只应记录Board返回true的操作），move不能是Layout
+    void record(Move move, int row, int col);
+
+    //记录一次撤销/重做（只应记录UndoHistory返回true的撤销和重做），各算作一步操作
+    void recordUndo();
+    void recordRedo();
+
+    //记录首次翻开之前预设的地雷布局，isMine和seed与传给Board::presetLayout的相同
+    void recordLayout(const std::vector<std::uint8_t> &isMine, std::uint64_t seed);
+
+    //返回已记录的操作步数（不包括布局记录）
+    int getMoveCount() const { return m_moveCount; }
+
+    //返回日志的字节流，可以直接保存下来，之后交给JournalReplayer重放
+    const std::vector<std::uint8_t> &getBytes() const { return m_bytes; }
+
+private:
+    std::vector<std::uint8_t> m_bytes;  //日志的字节流
+    int m_cols = 0;  //本局的列数，用于把行列坐标换算成格子编号
+    int m_previousCell = 0;  //上一次操作的格子编号，下一次操作只记录与它的差
+    int m_moveCount = 0;  //已记录的操作步数
+};
+
+//JournalReplayer根据MoveJournal的字节流重放一局游戏，可以跳到任意一步之后的棋盘状态
+//日志中有撤销/重做时，重放过程中也用UndoHistory记录每一步，关键帧同时保存它（没有撤销的日志不需要这部分开销）
+//构造时把整个日志重放一遍，每隔keyframeInterval步把整个棋盘保存为一个关键帧；跳转时先二分查找目标之前最近的关键帧，
+//再从那里最多重放keyframeInterval步，所以包括第一次在内，每次跳转的代价都与日志的总长度无关。关键帧只在内存中建立，不写进日志
+//每个关键帧是一份完整的棋盘，内存占用约为（总步数/keyframeInterval）乘以棋盘大小，超大棋盘应使用较大的间隔
+class JournalReplayer {
+public:
+    //默认的关键帧间隔（步数）
+    static constexpr int kDefaultKeyframeInterval = 64;
+
+    //解析并检查整个日志，然后重放一遍建立全部关键帧（耗时与重放整局相同）；日志不完整或不合法时isValid()返回false，此时不能调用seek
+    explicit JournalReplayer(std::vector<std::uint8_t> bytes, int keyframeInterval = kDefaultKeyframeInterval);
+
+    //日志是否合法
+    bool isValid() const { return m_valid; }
+
+    //日志中记录的操作步数
+    int getMoveCount() const { return m_moveCount; }
+
+    //返回执行完前move步之后的棋盘（move为0时是刚开始、还没有任何操作的棋盘），move会被限制在[0, getMoveCount()]范围内
+    //返回的引用在下一次调用seek之前有效
+    const Board &seek(int move);
+
+private:
+    //重放的位置：执行完move步之后的棋盘，以及下一条记录在字节流中的位置
+    struct Cursor {
+        int move = 0;
+        std::size_t offset = 0;
+        int previousCell = 0;
+        Board board;
+        std::optional<UndoHistory> history;  //日志中有撤销/重做时才建立
+    };
+
+    //从cursor的位置读出并执行下一步操作（包括它之前的布局记录）
+    void step(Cursor &cursor) const;
+
+    std::vector<std::uint8_t> m_bytes;  //日志的字节流
+    int m_keyframeInterval;
+    bool m_valid = false;
+    int m_moveCount = 0;
+    int m_mineCount = 0;  //布局记录中的地雷数
+    bool m_hasUndo = false;  //日志中是否有撤销/重做
+    std::vector<Cursor> m_keyframes;  //按步数递增的关键帧，第一个是第0步
+    Cursor m_cursor;  //当前重放到的位置，顺序向后跳转时直接从这里继续
+};
+
+#endif //MINESWEEPER_MOVEJOURNAL_H
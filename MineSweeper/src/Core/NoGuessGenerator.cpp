@@ -0,0 +1,165 @@
+#include "NoGuessGenerator.h"
+#include <algorithm>  //包含std::min、std::max
+#include <climits>  //包含INT_MAX
+#include <cstdlib>  //包含std::abs
+#include <mutex>  //包含std::mutex，用于保护目前最好的布局
+#include <thread>  //包含std::thread，用于并行尝试候选
+#include "BitPlanes.h"  //包含位平面，用于每次修复前找出边界上的地雷和可以挪去的空格子
+#include "Board.h"
+#include "Profiler.h"  //包含Profiler::MutedThread
+#include "Solver.h"
+
+namespace {
+//最多尝试的候选数，全部失败时退回一个未经验证的SafeArea布局，保证地雷过于密集时生成也会在有限时间内结束
+constexpr int kMaxCandidates = 256;
+//每个候选最多做的修复次数是地雷数的kRepairsPerMine倍（至少kMinRepairs次）
+constexpr int kRepairsPerMine = 2;
+constexpr int kMinRepairs = 16;
+
+//从首次点击开始，让求解器不断翻开确定安全的格子，直到胜利或者没有确定安全的格子为止，返回是否胜利
+//超大的棋盘解一遍要翻开上百万个格子，所以每一步都检查取消标志（cancel可以为空），被取消时返回false
+bool solveWithoutGuessing(Board &board, Solver &solver, int firstRow, int firstCol, const std::atomic<bool> *cancel) {
+    board.revealCell(firstRow, firstCol);
+    solver.reset(board);
+    while (board.getGameState() == GameState::Playing) {
+        if (cancel && cancel->load(std::memory_order_relaxed)) return false;
+        const Solver::Hint hint = solver.hint(board);
+        if (!hint.certain) break;
+        board.revealCell(hint.row, hint.col);
+        solver.update(board, board.getChangedCells());
+    }
+    return board.getGameState() == GameState::Won;
+}
+}
+
+//构造函数的实现
+NoGuessGenerator::NoGuessGenerator(int rows, int cols, int mines, int firstRow, int firstCol, std::uint64_t seed)
+    : m_rows(rows), m_cols(cols), m_mines(mines), m_firstRow(firstRow), m_firstCol(firstCol), m_seed(seed) {}
+
+//候选种子的实现：候选编号经过一轮SplitMix64混合后与种子结合，相邻编号得到的随机数序列互不相关
+std::uint64_t NoGuessGenerator::candidateSeed(int candidate) const {
+    std::uint64_t z = std::uint64_t(candidate) * 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return m_seed ^ z ^ (z >> 31);
+}
+
+//生成布局的实现
+NoGuessGenerator::Result NoGuessGenerator::generate() const {
+    Result result;
+    std::atomic<int> next{0};  //下一个待尝试的候选编号
+    std::atomic<int> best{INT_MAX};  //目前已知的最小成功候选编号
+    std::mutex mutex;
+
+    //每个线程不断领取下一个候选编号，直到编号超过了已知的最小成功编号或者达到上限
+    auto work = [&]() {
+        //尝试候选时的大量布雷和翻开不是玩家的操作，不计入统计
+        const Profiler::MutedThread muted;
+        std::vector<std::uint8_t> isMine;
+        for (;;) {
+            const int candidate = next.fetch_add(1, std::memory_order_relaxed);
+            if (candidate >= kMaxCandidates || candidate > best.load(std::memory_order_relaxed)) break;
+            if (m_cancel && m_cancel->load(std::memory_order_relaxed)) break;
+            if (!tryCandidate(candidate, isMine, best)) continue;
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (candidate < best.load(std::memory_order_relaxed)) {
+                best.store(candidate, std::memory_order_relaxed);
+                result.isMine.swap(isMine);
+            }
+        }
+    };
+
+    const int threads = m_threads > 0 ? m_threads : std::max(1, int(std::thread::hardware_concurrency()));
+    std::vector<std::thread> workers;
+    for (int i = 1; i < threads; ++i) workers.emplace_back(work);
+    work();  //调用者线程自己也参与尝试
+    for (std::thread &worker : workers) worker.join();
+
+    result.candidates = std::min(next.load(), kMaxCandidates);
+    result.certified = best.load() != INT_MAX;
+    if (m_cancel && m_cancel->load(std::memory_order_relaxed)) {
+        result.isMine.clear();
+        result.certified = false;
+        return result;
+    }
+    if (!result.certified) {
+        //所有候选都失败了，退回第0个候选的初始SafeArea布局
+        Board board;
+        board.startGame(m_rows, m_cols, m_mines, candidateSeed(0), FirstClickPolicy::SafeArea);
+        board.layMines(m_firstRow, m_firstCol);
+        result.isMine.assign(std::size_t(m_rows) * m_cols, 0);
+        for (int cell = 0; cell < m_rows * m_cols; ++cell) {
+            result.isMine[cell] = board.getCell(cell / m_cols, cell % m_cols).isMine;
+        }
+    }
+    return result;
+}
+
+//尝试一个候选的实现
+bool NoGuessGenerator::tryCandidate(int candidate, std::vector<std::uint8_t> &isMine, const std::atomic<int> &best) const {
+    const int cellCount = m_rows * m_cols;
+    const std::uint64_t seed = candidateSeed(candidate);
+
+    //初始布局就是这个种子下的SafeArea布局
+    Board board;
+    board.startGame(m_rows, m_cols, m_mines, seed, FirstClickPolicy::SafeArea);
+    board.layMines(m_firstRow, m_firstCol);  //只需要布雷，不需要连锁翻开
+    isMine.assign(cellCount, 0);
+    for (int cell = 0; cell < cellCount; ++cell) {
+        isMine[cell] = board.getCell(cell / m_cols, cell % m_cols).isMine;
+    }
+
+    //修复时挪动地雷同样不能挪进首次点击需要留空的区域（与Board::placeMines相同：放不下时只留空首次点击的格子）
+    int excludedCount = 0;
+    for (int r = m_firstRow - 1; r <= m_firstRow + 1; ++r) {
+        for (int c = m_firstCol - 1; c <= m_firstCol + 1; ++c) {
+            excludedCount += r >= 0 && r < m_rows && c >= 0 && c < m_cols;
+        }
+    }
+    const int radius = m_mines > cellCount - excludedCount ? 0 : 1;
+    auto isExcluded = [&](int cell) {
+        return std::abs(cell / m_cols - m_firstRow) <= radius && std::abs(cell % m_cols - m_firstCol) <= radius;
+    };
+
+    Board::RandomEngine rng(seed ^ 0xA0761D6478BD642Full);  //修复使用的随机数与布雷互相独立
+    Solver solver;
+    BitPlanes planes;
+    std::vector<int> sources;
+    std::vector<int> targets;
+    const int maxRepairs = std::max(kMinRepairs, m_mines * kRepairsPerMine);
+    for (int repair = 0; repair <= maxRepairs; ++repair) {
+        //已经有编号更小的候选成功了，这个候选不会被采用
+        if (best.load(std::memory_order_relaxed) < candidate) return false;
+        if (m_cancel && m_cancel->load(std::memory_order_relaxed)) return false;
+
+        board.loadLayout(m_rows, m_cols, isMine);
+        if (solveWithoutGuessing(board, solver, m_firstRow, m_firstCol, m_cancel)) return true;
+        if (board.getGameState() != GameState::Playing) return false;
+
+        //卡住了：把一颗求解器无法确定的地雷挪到远离已翻开区域的空格子里
+        //优先挪动边界上的地雷，它们正是让推理卡住的地方；没有边界地雷时（未知区域被已确定的地雷完全包围）挪动任意一颗未确定的地雷
+        //边界和远离已翻开区域的格子都由位平面一次64个格子地算出，只有结果中的格子才需要逐个检查
+        //（求解过程中不插旗，所以与已翻开格子相邻的未翻开格子一定与某个数字相邻，正是位平面的边界）
+        const auto isMovable = [&](int cell) {
+            return isMine[cell] && !isExcluded(cell)
+                   && solver.knowledge(cell / m_cols, cell % m_cols) == Solver::Knowledge::Unknown;
+        };
+        planes.capture(board);
+        planes.frontier(sources);
+        std::erase_if(sources, [&](int cell) { return !isMovable(cell); });
+        if (sources.empty()) {
+            planes.hiddenMines(sources);
+            std::erase_if(sources, [&](int cell) { return !isMovable(cell); });
+        }
+        planes.untouchedSafeCells(targets);
+        std::erase_if(targets, isExcluded);
+        if (sources.empty() || targets.empty()) return false;  //无处可挪，尽早放弃
+
+        const int from = sources[boundedRandom(rng, std::uint32_t(sources.size()))];
+        const int to = targets[boundedRandom(rng, std::uint32_t(targets.size()))];
+        isMine[from] = 0;
+        isMine[to] = 1;
+    }
+    return false;
+}
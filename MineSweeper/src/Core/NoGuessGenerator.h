@@ -0,0 +1,72 @@
+#ifndef MINESWEEPER_NOGUESSGENERATOR_H
+#define MINESWEEPER_NOGUESSGENERATOR_H
+
+/*
+NoGuessGenerator生成“不需要猜”的地雷布局：从首次点击开始，只靠Solver的确定性推理（包括精确枚举得到的确定结论）就能翻开所有非地雷格子
+它属于不依赖Qt的核心库，供Board在FirstClickPolicy::NoGuess策略下首次翻开时调用，也可以在命令行工具中批量生成
+
+每个候选布局的生成过程：
+1.按SafeArea策略随机布雷，翻开首次点击的格子，让求解器一直翻开确定安全的格子
+2.卡住时做局部修复：把一颗边界上（与已翻开格子相邻、求解器无法确定）的地雷挪到远离已翻开区域的空格子里，再从头验证
+3.修复次数用完或者无处可挪时尽早放弃这个候选
+
+候选之间互相独立，由多个线程并行尝试；每个候选的随机数只由种子和候选编号决定，最终总是采用编号最小的成功候选，
+所以同样的参数和种子在任意线程数下都得到逐位相同的布局
+*/
+
+#include <atomic>  //包含std::atomic，用于在线程之间共享目前最小的成功候选编号
+#include <cstdint>  //包含固定宽度的整数类型
+#include <vector>  //包含std::vector，用于存放布局
+
+class NoGuessGenerator {
+public:
+    //一次生成的结果
+    struct Result {
+        std::vector<std::uint8_t> isMine;  //按行优先存放每个格子是否是雷，可以直接交给Board::loadLayout
+        bool certified = false;  //布局是否经过求解器验证；在尝试次数上限内都没有成功时为false，此时是一个普通的SafeArea布局（被取消时isMine为空）
+        int candidates = 0;  //为得到结果而尝试过的候选数（多线程时包括被提前终止的候选）
+    };
+
+    //格子数乘以地雷数的上限，以及地雷占格子总数的百分比上限（高级是20.6%），见canGenerate
+    static constexpr std::int64_t MaxWork = std::int64_t(1) << 19;
+    static constexpr int MaxDensityPercent = 22;
+
+    //rows/cols/mines是棋盘参数（地雷数应已被限制在合法范围内），firstRow/firstCol是首次点击的位置
+    NoGuessGenerator(int rows, int cols, int mines, int firstRow, int firstCol, std::uint64_t seed);
+
+    //生成器能否在一两秒之内（单线程）给出rows x cols、mines颗雷的布局
+    //每个候选最多修复的次数与地雷数成正比，每次修复都要从头验证整个棋盘，所以耗时大致与格子数乘以地雷数成正比，
+    //而且随地雷密度急剧上升（45x45的棋盘上25%的地雷平均每个布局约4秒，50%时几分钟也生成不完）；超出上限的棋盘只会长时间占住线程
+    static bool canGenerate(int rows, int cols, int mines) {
+        const std::int64_t cells = std::int64_t(rows) * cols;
+        return cells * mines <= MaxWork && std::int64_t(mines) * 100 <= cells * MaxDensityPercent;
+    }
+
+    //设置并行尝试候选的线程数：默认是1，在调用者线程中串行生成；0表示使用全部硬件线程
+    void setThreadCount(int threads) { m_threads = threads; }
+
+    //设置取消标志：生成过程中它变为true时尽快停止，返回空的isMine（用于后台生成的结果已经不再需要时）
+    void setCancelFlag(const std::atomic<bool> *cancel) { m_cancel = cancel; }
+
+    //生成一个布局，阻塞直到完成
+    Result generate() const;
+
+private:
+    //尝试第candidate个候选，成功时把布局写入isMine并返回true
+    //best是目前已知的最小成功候选编号，它小于candidate时说明这个候选无论成败都不会被采用，立即放弃
+    bool tryCandidate(int candidate, std::vector<std::uint8_t> &isMine, const std::atomic<int> &best) const;
+
+    //第candidate个候选使用的种子
+    std::uint64_t candidateSeed(int candidate) const;
+
+    int m_rows;
+    int m_cols;
+    int m_mines;
+    int m_firstRow;
+    int m_firstCol;
+    std::uint64_t m_seed;
+    int m_threads = 1;
+    const std::atomic<bool> *m_cancel = nullptr;
+};
+
+#endif //MINESWEEPER_NOGUESSGENERATOR_H
@@ -0,0 +1,180 @@
+#include "Profiler.h"
+#include <algorithm>  //包含std::sort
+#include <chrono>  //包含std::chrono::steady_clock，用作计时的时钟
+#include <cstdio>  //包含std::fopen、std::fprintf，用于写出跟踪文件
+
+namespace {
+//当前线程是否被屏蔽
+thread_local bool t_muted = false;
+
+//当前线程的编号，0表示还没有分配
+thread_local std::uint32_t t_threadId = 0;
+std::atomic<std::uint32_t> g_nextThreadId{1};
+
+std::uint32_t currentThreadId() {
+    if (t_threadId == 0) t_threadId = g_nextThreadId.fetch_add(1, std::memory_order_relaxed);
+    return t_threadId;
+}
+
+constexpr const char *kZoneNames[ProfileZoneCount] = {"placeMines", "adjacentMines", "floodReveal",
+                                                      "translate", "applyView", "paint"};
+constexpr const char *kCounterNames[ProfileCounterCount] = {"cellsRevealed", "updatesEmitted"};
+}
+
+//Scope构造函数的实现
+Profiler::Scope::Scope(ProfileZone zone) : m_zone(zone), m_start(t_muted ? -1 : now()) {}
+
+//Scope析构函数的实现
+Profiler::Scope::~Scope() {
+    if (m_start < 0) return;
+    instance().recordZone(m_zone, m_start, now() - m_start);
+}
+
+//MutedThread构造函数的实现
+Profiler::MutedThread::MutedThread() : m_previous(t_muted) {
+    t_muted = true;
+}
+
+//MutedThread析构函数的实现
+Profiler::MutedThread::~MutedThread() {
+    t_muted = m_previous;
+}
+
+//instance的实现
+Profiler &Profiler::instance() {
+    static Profiler profiler;
+    return profiler;
+}
+
+//name的实现
+const char *Profiler::name(ProfileZone zone) {
+    return kZoneNames[static_cast<int>(zone)];
+}
+
+const char *Profiler::name(ProfileCounter counter) {
+    return kCounterNames[static_cast<int>(counter)];
+}
+
+//now的实现
+std::int64_t Profiler::now() {
+    static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+//AtomicStats::add的实现
+void Profiler::AtomicStats::add(std::uint64_t value) {
+    calls.fetch_add(1, std::memory_order_relaxed);
+    total.fetch_add(value, std::memory_order_relaxed);
+    last.store(value, std::memory_order_relaxed);
+    std::uint64_t previous = max.load(std::memory_order_relaxed);
+    while (value > previous && !max.compare_exchange_weak(previous, value, std::memory_order_relaxed)) {
+    }
+}
+
+//AtomicStats::load的实现
+Profiler::Stats Profiler::AtomicStats::load() const {
+    return Stats{calls.load(std::memory_order_relaxed), total.load(std::memory_order_relaxed),
+                 max.load(std::memory_order_relaxed), last.load(std::memory_order_relaxed)};
+}
+
+//AtomicStats::clear的实现
+void Profiler::AtomicStats::clear() {
+    calls.store(0, std::memory_order_relaxed);
+    total.store(0, std::memory_order_relaxed);
+    max.store(0, std::memory_order_relaxed);
+    last.store(0, std::memory_order_relaxed);
+}
+
+//记录区段的实现
+void Profiler::recordZone(ProfileZone zone, std::int64_t start, std::int64_t duration) {
+    m_zones[static_cast<int>(zone)].add(std::uint64_t(duration));
+    if (isTracing()) {
+        addEvent(TraceEvent{start, duration, currentThreadId(), true, static_cast<std::uint8_t>(zone)});
+    }
+}
+
+//记录计数的实现
+void Profiler::recordCounter(ProfileCounter counter, std::int64_t value) {
+    if (t_muted) return;
+    m_counters[static_cast<int>(counter)].add(std::uint64_t(value));
+    if (isTracing()) {
+        addEvent(TraceEvent{now(), value, currentThreadId(), false, static_cast<std::uint8_t>(counter)});
+    }
+}
+
+//snapshot的实现
+Profiler::Snapshot Profiler::snapshot() const {
+    Snapshot snapshot;
+    for (int i = 0; i < ProfileZoneCount; ++i) snapshot.zones[i] = m_zones[i].load();
+    for (int i = 0; i < ProfileCounterCount; ++i) snapshot.counters[i] = m_counters[i].load();
+    return snapshot;
+}
+
+//reset的实现
+void Profiler::reset() {
+    for (AtomicStats &stats : m_zones) stats.clear();
+    for (AtomicStats &stats : m_counters) stats.clear();
+    std::lock_guard<std::mutex> lock(m_traceMutex);
+    m_nextEvent = 0;
+    m_wrapped = false;
+}
+
+//setTracing的实现
+void Profiler::setTracing(bool enabled) {
+    std::lock_guard<std::mutex> lock(m_traceMutex);
+    //缓冲区只在第一次开启时分配，之后一直保留；事件只在持有锁时写入，所以先分配再打开开关
+    if (enabled && m_events.empty()) m_events.resize(kTraceCapacity);
+    m_nextEvent = 0;
+    m_wrapped = false;
+    m_tracing.store(enabled, std::memory_order_relaxed);
+}
+
+//addEvent的实现
+void Profiler::addEvent(const TraceEvent &event) {
+    if (!isTracing()) return;  //没有开启跟踪时不加锁
+    std::lock_guard<std::mutex> lock(m_traceMutex);
+    //调用者检查开关之后跟踪可能刚刚被关闭，在锁内再检查一次；开关只在持有锁时改变，开启时缓冲区一定已经分配
+    if (!isTracing()) return;
+    m_events[m_nextEvent] = event;
+    if (++m_nextEvent == m_events.size()) {
+        m_nextEvent = 0;
+        m_wrapped = true;
+    }
+}
+
+//导出Chrome跟踪文件的实现
+bool Profiler::writeChromeTrace(const std::string &path) const {
+    std::vector<TraceEvent> events;
+    {
+        //先在锁内复制出来，写文件时不阻塞正在记录的线程
+        std::lock_guard<std::mutex> lock(m_traceMutex);
+        if (m_wrapped) {
+            events.assign(m_events.begin() + std::ptrdiff_t(m_nextEvent), m_events.end());
+        }
+        events.insert(events.end(), m_events.begin(), m_events.begin() + std::ptrdiff_t(m_nextEvent));
+    }
+    //区段在结束时才被记录，嵌套的区段会先于外层的区段进入缓冲区，按开始时刻重新排序
+    std::stable_sort(events.begin(), events.end(),
+                     [](const TraceEvent &a, const TraceEvent &b) { return a.timestamp < b.timestamp; });
+
+    std::FILE *file = std::fopen(path.c_str(), "w");
+    if (!file) return false;
+    //时间单位是微秒，保留到纳秒
+    std::fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+    for (std::size_t i = 0; i < events.size(); ++i) {
+        const TraceEvent &event = events[i];
+        std::fprintf(file, i == 0 ? "\n" : ",\n");
+        if (event.isZone) {
+            std::fprintf(file,
+                         "{\"name\":\"%s\",\"cat\":\"minesweeper\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                         kZoneNames[event.id], event.thread, double(event.timestamp) / 1000.0,
+                         double(event.value) / 1000.0);
+        } else {
+            std::fprintf(file, "{\"name\":\"%s\",\"ph\":\"C\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"args\":{\"value\":%lld}}",
+                         kCounterNames[event.id], event.thread, double(event.timestamp) / 1000.0,
+                         static_cast<long long>(event.value));
+        }
+    }
+    std::fprintf(file, "\n]}\n");
+    return std::fclose(file) == 0;
+}
@@ -0,0 +1,176 @@
+#ifndef MINESWEEPER_PROFILER_H
+#define MINESWEEPER_PROFILER_H
+
+/*
+Profiler是热点路径上的轻量级计时器和计数器，属于不依赖Qt的核心库，Model、ViewModel和View都通过它记录耗时
+- 计时区段：在一段代码的开头写MINESWEEPER_PROFILE_SCOPE(区段)，离开作用域时记录这一次执行的耗时
+- 计数器：MINESWEEPER_PROFILE_COUNT(计数器, 数量)记录一次操作处理了多少东西（例如一次点击翻开了多少格子）
+每个区段和计数器都累计次数、总量、最大值和最近一次的值，可以随时取快照（统计浮层每隔一段时间读取一次）
+打开跟踪后，每一次记录还会作为一个事件存入有界的环形缓冲区（只保留最近的事件），可以导出为Chrome的trace-event JSON，
+在chrome://tracing或ui.perfetto.dev中按时间线查看“卡住”的那一刻各个线程在做什么
+
+编译开关：CMake选项MINESWEEPER_PROFILING关闭时两个宏展开为空语句，热点路径上没有任何额外的代码
+打开时，没有开启跟踪的每次记录只是两次读时钟和几次原子加法，与被测的操作（一次点击级别）相比可以忽略
+后台生成棋盘的线程用MutedThread屏蔽自己的记录，统计只反映玩家操作的开销
+*/
+
+#include <array>  //包含std::array，用于存放每个区段和计数器的统计
+#include <atomic>  //包含std::atomic，多个线程同时记录时不需要加锁
+#include <cstdint>  //包含固定宽度的整数类型
+#include <mutex>  //包含std::mutex，保护跟踪事件的环形缓冲区
+#include <string>  //包含std::string，用于导出文件的路径
+#include <vector>  //包含std::vector，用作跟踪事件的环形缓冲区
+
+//没有通过构建系统指定时默认打开
+#ifndef MINESWEEPER_PROFILING
+#define MINESWEEPER_PROFILING 1
+#endif
+
+//计时区段
+enum class ProfileZone : std::uint8_t {
+    PlaceMines,  //首次点击时布雷（包括稀疏棋盘逐颗更新邻居计数，以及NoGuess布局的生成）
+    AdjacentMines,  //密集棋盘放完雷后整盘重算周围地雷数
+    FloodReveal,  //从一个空白格开始连锁翻开整片区域
+    Translate,  //ViewModel把被改变的格子翻译成UI更新
+    ApplyView,  //View应用一批格子更新
+    Paint  //棋盘控件重绘一次
+};
+
+//计时区段的总数
+constexpr int ProfileZoneCount = static_cast<int>(ProfileZone::Paint) + 1;
+
+//计数器
+enum class ProfileCounter : std::uint8_t {
+    CellsRevealed,  //一次翻开或双击翻开的格子数
+    UpdatesEmitted  //ViewModel一次交给View的格子更新数
+};
+
+//计数器的总数
+constexpr int ProfileCounterCount = static_cast<int>(ProfileCounter::UpdatesEmitted) + 1;
+
+class Profiler {
+public:
+    //一个区段或计数器的累计统计：区段的单位是纳秒，计数器的单位是各自记录的数量
+    struct Stats {
+        std::uint64_t calls = 0;  //记录的次数
+        std::uint64_t total = 0;  //全部记录的总和
+        std::uint64_t max = 0;  //单次的最大值
+        std::uint64_t last = 0;  //最近一次的值
+    };
+
+    //全部统计的快照
+    struct Snapshot {
+        std::array<Stats, ProfileZoneCount> zones;
+        std::array<Stats, ProfileCounterCount> counters;
+    };
+
+    //在作用域内计时的RAII对象，通常通过MINESWEEPER_PROFILE_SCOPE使用
+    class Scope {
+    public:
+        explicit Scope(ProfileZone zone);
+        ~Scope();
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        ProfileZone m_zone;
+        std::int64_t m_start;  //开始的时间，-1表示当前线程被屏蔽，不记录
+    };
+
+    //在作用域内屏蔽当前线程的所有记录的RAII对象（可以嵌套），用于后台生成棋盘的线程
+    class MutedThread {
+    public:
+        MutedThread();
+        ~MutedThread();
+
+        MutedThread(const MutedThread &) = delete;
+        MutedThread &operator=(const MutedThread &) = delete;
+
+    private:
+        bool m_previous;
+    };
+
+    //全局唯一的实例
+    static Profiler &instance();
+
+    //区段和计数器的名字，用于显示和导出
+    static const char *name(ProfileZone zone);
+    static const char *name(ProfileCounter counter);
+
+    //当前时刻，单位是纳秒（起点是进程中第一次调用的时刻）
+    static std::int64_t now();
+
+    //记录一次区段的执行：start是开始时刻（now()的返回值），duration是耗时
+    void recordZone(ProfileZone zone, std::int64_t start, std::int64_t duration);
+
+    //记录一次计数
+    void recordCounter(ProfileCounter counter, std::int64_t value);
+
+    //返回当前的统计快照（各项分别读取，记录与读取同时进行时各项之间可能有微小的不一致）
+    Snapshot snapshot() const;
+
+    //清空全部统计和跟踪事件
+    void reset();
+
+    //开启或关闭跟踪：开启时分配环形缓冲区，之后的每次记录都会存为一个跟踪事件；关闭时丢弃已有的事件
+    void setTracing(bool enabled);
+    bool isTracing() const { return m_tracing.load(std::memory_order_relaxed); }
+
+    //把缓冲区中的跟踪事件按时间顺序写成Chrome的trace-event JSON文件，返回是否写入成功
+    bool writeChromeTrace(const std::string &path) const;
+
+private:
+    Profiler() = default;
+
+    //跟踪事件的环形缓冲区最多保存的事件数，写满后覆盖最早的事件
+    static constexpr std::size_t kTraceCapacity = std::size_t(1) << 18;
+
+    //一个区段或计数器的统计，各项用原子变量分别累计
+    struct AtomicStats {
+        std::atomic<std::uint64_t> calls{0};
+        std::atomic<std::uint64_t> total{0};
+        std::atomic<std::uint64_t> max{0};
+        std::atomic<std::uint64_t> last{0};
+
+        void add(std::uint64_t value);
+        Stats load() const;
+        void clear();
+    };
+
+    //一个跟踪事件
+    struct TraceEvent {
+        std::int64_t timestamp;  //区段的开始时刻，或计数的时刻
+        std::int64_t value;  //区段的耗时，或计数的数量
+        std::uint32_t thread;  //记录它的线程的编号（按线程第一次记录的顺序从1开始）
+        bool isZone;  //是区段还是计数器
+        std::uint8_t id;  //区段或计数器的编号
+    };
+
+    //把一个事件存入环形缓冲区；跟踪没有开启（或者刚刚被关闭）时什么也不做
+    void addEvent(const TraceEvent &event);
+
+    std::array<AtomicStats, ProfileZoneCount> m_zones;
+    std::array<AtomicStats, ProfileCounterCount> m_counters;
+    std::atomic<bool> m_tracing{false};
+
+    //--- 以下成员由m_traceMutex保护 ---
+    mutable std::mutex m_traceMutex;
+    std::vector<TraceEvent> m_events;  //环形缓冲区
+    std::size_t m_nextEvent = 0;  //下一个事件写入的位置
+    bool m_wrapped = false;  //缓冲区是否已经写满过一圈
+};
+
+#if MINESWEEPER_PROFILING
+#define MINESWEEPER_PROFILE_CONCAT_INNER(a, b) a##b
+#define MINESWEEPER_PROFILE_CONCAT(a, b) MINESWEEPER_PROFILE_CONCAT_INNER(a, b)
+//在当前作用域内计时，离开作用域时记录
+#define MINESWEEPER_PROFILE_SCOPE(zone) const Profiler::Scope MINESWEEPER_PROFILE_CONCAT(profileScope, __LINE__)(zone)
+//记录一次计数
+#define MINESWEEPER_PROFILE_COUNT(counter, value) Profiler::instance().recordCounter(counter, std::int64_t(value))
+#else
+#define MINESWEEPER_PROFILE_SCOPE(zone) ((void)0)
+#define MINESWEEPER_PROFILE_COUNT(counter, value) ((void)0)
+#endif
+
+#endif //MINESWEEPER_PROFILER_H
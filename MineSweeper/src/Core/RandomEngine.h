@@ -0,0 +1,69 @@
+#ifndef MINESWEEPER_RANDOMENGINE_H
+#define MINESWEEPER_RANDOMENGINE_H
+
+/*
+布雷使用的伪随机数生成器
+扫雷只需要“看起来随机”且可以复现的棋盘，不需要密码学强度，所以这里使用速度极快的xoshiro256**算法，
+同一个64位种子在任何平台、任何编译器上都会产生完全相同的随机序列，从而产生完全相同的棋盘
+*/
+
+#include <cstdint>  //包含固定宽度的整数类型（std::uint32_t、std::uint64_t），核心库不依赖Qt
+
+//xoshiro256**生成器（David Blackman与Sebastiano Vigna提出），周期为2^256-1
+//它满足C++标准库的UniformRandomBitGenerator要求，也可以直接交给<random>中的各种分布使用
+class Xoshiro256StarStar {
+public:
+    using result_type = std::uint64_t;
+
+    //用一个64位种子初始化256位内部状态，种子先经过SplitMix64展开，保证即使种子很小（如0、1）内部状态也足够“随机”
+    explicit Xoshiro256StarStar(std::uint64_t seed = 0) { reseed(seed); }
+
+    void reseed(std::uint64_t seed) {
+        for (std::uint64_t &word : m_state) {
+            seed += 0x9E3779B97F4A7C15ull;
+            std::uint64_t z = seed;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            word = z ^ (z >> 31);
+        }
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return ~result_type(0); }
+
+    //生成下一个64位随机数
+    result_type operator()() {
+        const std::uint64_t result = rotl(m_state[1] * 5, 7) * 9;
+        const std::uint64_t t = m_state[1] << 17;
+        m_state[2] ^= m_state[0];
+        m_state[3] ^= m_state[1];
+        m_state[1] ^= m_state[2];
+        m_state[0] ^= m_state[3];
+        m_state[2] ^= t;
+        m_state[3] = rotl(m_state[3], 45);
+        return result;
+    }
+
+private:
+    static std::uint64_t rotl(std::uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+    std::uint64_t m_state[4];
+};
+
+//从任意64位随机数生成器中等概率地取出[0, range)范围内的整数（range必须大于0）
+//使用Lemire的乘法映射加拒绝采样，绝大多数情况下不需要除法，结果也没有取模带来的偏差，并且与平台无关
+template <typename Engine>
+std::uint32_t boundedRandom(Engine &engine, std::uint32_t range) {
+    std::uint64_t product = std::uint64_t(std::uint32_t(engine() >> 32)) * range;
+    std::uint32_t low = std::uint32_t(product);
+    if (low < range) {
+        const std::uint32_t threshold = std::uint32_t(-range) % range;
+        while (low < threshold) {
+            product = std::uint64_t(std::uint32_t(engine() >> 32)) * range;
+            low = std::uint32_t(product);
+        }
+    }
+    return std::uint32_t(product >> 32);
+}
+
+#endif //MINESWEEPER_RANDOMENGINE_H
@@ -0,0 +1,467 @@
+#include "Solver.h"
+#include <algorithm>  //包含std::includes、std::set_difference等集合算法
+#include <cmath>  //包含std::log和std::exp，用于在对数空间中计算组合数
+
+namespace {
+//精确枚举时单个连通分量最多搜索的节点数，超过后放弃该分量（其中的格子按非边界格子计算概率），保证每次计算的耗时有上限
+constexpr long kMaxEnumerationNodes = 1 << 16;
+
+//ln n!，按需增长的表格，每个线程各有一份
+//不使用std::lgamma：它会写全局变量signgam，在多个线程同时求解（例如NoGuessGenerator并行生成）时产生数据竞争
+double logFactorial(int n) {
+    thread_local std::vector<double> table(1, 0.0);
+    while (int(table.size()) <= n) {
+        table.push_back(table.back() + std::log(double(table.size())));
+    }
+    return table[n];
+}
+
+//ln C(n, k)
+double logBinomial(int n, int k) {
+    return logFactorial(n) - logFactorial(k) - logFactorial(n - k);
+}
+
+//两个“放k颗雷的方式数”分布的卷积
+std::vector<double> convolve(const std::vector<double> &a, const std::vector<double> &b) {
+    std::vector<double> result(a.size() + b.size() - 1, 0.0);
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i] == 0.0) continue;
+        for (size_t j = 0; j < b.size(); ++j) {
+            result[i + j] += a[i] * b[j];
+        }
+    }
+    return result;
+}
+
+//一个连通分量的精确枚举结果
+struct ComponentResult {
+    std::vector<int> vars;  //分量中的未知格子
+    std::vector<double> ways;  //恰好放k颗雷的方式数
+    std::vector<double> cellWays;  //恰好放k颗雷、且第i个格子是雷的方式数，按[k * vars.size() + i]存储
+};
+}
+
+//forEachNeighbor的实现
+template <typename Visit>
+void Solver::forEachNeighbor(int cell, Visit &&visit) const {
+    const int row = cell / m_cols;
+    const int col = cell % m_cols;
+    for (int r = std::max(0, row - 1); r <= std::min(m_rows - 1, row + 1); ++r) {
+        for (int c = std::max(0, col - 1); c <= std::min(m_cols - 1, col + 1); ++c) {
+            if (r != row || c != col) visit(r * m_cols + c);
+        }
+    }
+}
+
+//reset的实现
+void Solver::reset(const Board &board) {
+    m_rows = board.getRows();
+    m_cols = board.getCols();
+    const int cellCount = m_rows * m_cols;
+    m_knowledge.assign(cellCount, std::uint8_t(Knowledge::Unknown));
+    m_queued.assign(cellCount, 0);
+    m_queue.clear();
+    m_safeCells.clear();
+
+    //棋盘上已经翻开的格子全部视为新翻开的格子
+    for (int cell = 0; cell < cellCount; ++cell) {
+        const Cell state = board.getCell(cell / m_cols, cell % m_cols);
+        if (state.isRevealed && !state.isMine) {
+            m_knowledge[cell] = std::uint8_t(Knowledge::Safe);
+            enqueue(cell);
+        }
+    }
+    propagate(board);
+}
+
+//update的实现
+void Solver::update(const Board &board, const std::vector<int> &changedCells) {
+    if (board.getRows() != m_rows || board.getCols() != m_cols) {
+        reset(board);
+        return;
+    }
+    for (int cell : changedCells) {
+        const Cell state = board.getCell(cell / m_cols, cell % m_cols);
+        if (!state.isRevealed) {
+            //撤销把已知安全的格子重新盖上时，hint可能已经把它从m_safeCells中取走了，要放回去才能再次被提示
+            //地雷不会被撤销，推理结果仍然成立；插旗也会走到这里，m_safeCells中重复的编号不影响hint
+            if (m_knowledge[cell] == std::uint8_t(Knowledge::Safe)) m_safeCells.push_back(cell);
+            continue;
+        }
+        //插旗不影响推理（求解器不相信旗帜），踩中的地雷也不提供任何数字
+        if (state.isMine) continue;
+        if (m_knowledge[cell] == std::uint8_t(Knowledge::Unknown)) {
+            //此前未知的格子变成了安全格子，它周围数字的未知邻居都少了一个，需要重新检查
+            m_knowledge[cell] = std::uint8_t(Knowledge::Safe);
+            enqueueAround(board, cell);
+        } else {
+            enqueue(cell);  //此前已推理出是安全的，只有它自己这个新数字需要检查
+        }
+    }
+    propagate(board);
+}
+
+//constraintOf的实现
+bool Solver::constraintOf(const Board &board, int cell, Constraint &constraint) const {
+    const Cell state = board.getCell(cell / m_cols, cell % m_cols);
+    if (!state.isRevealed || state.isMine) return false;
+
+    constraint.count = 0;
+    constraint.mines = state.adjacentMines;
+    //邻居按行优先顺序访问，得到的未知格子天然是从小到大排列的
+    forEachNeighbor(cell, [&](int neighbor) {
+        const auto knowledge = Knowledge(m_knowledge[neighbor]);
+        if (knowledge == Knowledge::Mine) {
+            constraint.mines--;
+        } else if (knowledge == Knowledge::Unknown) {
+            constraint.cells[constraint.count++] = neighbor;
+        }
+    });
+    return true;
+}
+
+//enqueue的实现
+void Solver::enqueue(int cell) {
+    if (m_queued[cell]) return;
+    m_queued[cell] = 1;
+    m_queue.push_back(cell);
+}
+
+//enqueueAround的实现
+void Solver::enqueueAround(const Board &board, int cell) {
+    enqueue(cell);
+    forEachNeighbor(cell, [&](int neighbor) {
+        if (board.getCell(neighbor / m_cols, neighbor % m_cols).isRevealed) enqueue(neighbor);
+    });
+}
+
+//learn的实现
+void Solver::learn(const Board &board, int cell, Knowledge knowledge) {
+    if (m_knowledge[cell] != std::uint8_t(Knowledge::Unknown)) return;
+    m_knowledge[cell] = std::uint8_t(knowledge);
+    if (knowledge == Knowledge::Safe) {
+        m_safeCells.push_back(cell);
+    }
+    //这个格子周围的数字都少了一个未知邻居
+    forEachNeighbor(cell, [&](int neighbor) {
+        if (board.getCell(neighbor / m_cols, neighbor % m_cols).isRevealed) enqueue(neighbor);
+    });
+}
+
+//propagate的实现
+void Solver::propagate(const Board &board) {
+    Constraint a, b;
+    while (!m_queue.empty()) {
+        const int cell = m_queue.back();
+        m_queue.pop_back();
+        m_queued[cell] = 0;
+        if (!constraintOf(board, cell, a) || a.count == 0) continue;
+
+        //单格规则：剩下的地雷数为0，所有未知邻居都安全；剩下的地雷数等于未知邻居数，所有未知邻居都是雷
+        if (a.mines == 0 || a.mines == a.count) {
+            const Knowledge knowledge = a.mines == 0 ? Knowledge::Safe : Knowledge::Mine;
+            for (int i = 0; i < a.count; ++i) learn(board, a.cells[i], knowledge);
+            continue;
+        }
+
+        //子集规则：只有距离不超过2的两个数字才可能有公共的未知邻居
+        const int row = cell / m_cols;
+        const int col = cell % m_cols;
+        bool learned = false;
+        for (int r = std::max(0, row - 2); r <= std::min(m_rows - 1, row + 2) && !learned; ++r) {
+            for (int c = std::max(0, col - 2); c <= std::min(m_cols - 1, col + 2) && !learned; ++c) {
+                const int other = r * m_cols + c;
+                if (other == cell || !constraintOf(board, other, b) || b.count == 0) continue;
+
+                //small是big的真子集时，差集中恰好有big.mines - small.mines颗雷
+                auto applySubset = [&](const Constraint &small, const Constraint &big) {
+                    if (small.count >= big.count ||
+                        !std::includes(big.cells, big.cells + big.count, small.cells, small.cells + small.count)) {
+                        return false;
+                    }
+                    int difference[8];
+                    const int count = int(std::set_difference(big.cells, big.cells + big.count,
+                                                              small.cells, small.cells + small.count, difference) - difference);
+                    const int mines = big.mines - small.mines;
+                    if (mines != 0 && mines != count) return false;
+                    for (int i = 0; i < count; ++i) {
+                        learn(board, difference[i], mines == 0 ? Knowledge::Safe : Knowledge::Mine);
+                    }
+                    return true;
+                };
+                //学到新结论后当前数字的约束已经变了（learn会把它重新加入队列），先停止检查它
+                learned = applySubset(a, b) || applySubset(b, a);
+            }
+        }
+    }
+}
+
+//enumerateComponent的实现
+bool Solver::enumerateComponent(const Board &board, const std::vector<int> &vars, const std::vector<int> &constraints) {
+    const int varCount = int(vars.size());
+    //每个数字约束：还需要的地雷数、已经放下的地雷数、尚未赋值的变量数
+    struct Slot {
+        int required = 0;
+        int assigned = 0;
+        int open = 0;
+    };
+    std::vector<Slot> slots(constraints.size());
+    std::vector<std::vector<int>> slotsOfVar(varCount);
+    Constraint constraint;
+    for (size_t s = 0; s < constraints.size(); ++s) {
+        constraintOf(board, constraints[s], constraint);
+        Slot &slot = slots[s];
+        slot.required = constraint.mines;
+        for (int i = 0; i < constraint.count; ++i) {
+            slotsOfVar[m_localIndex[constraint.cells[i]]].push_back(int(s));
+        }
+        slot.open = constraint.count;
+    }
+
+    m_ways.assign(varCount + 1, 0.0);
+    m_cellWays.assign(size_t(varCount + 1) * varCount, 0.0);
+    std::vector<std::uint8_t> assignment(varCount, 0);
+    long nodes = 0;
+    int mines = 0;
+
+    //按广度优先的顺序逐个给变量赋值（相邻的变量共享约束，剪枝更早生效）
+    auto search = [&](auto &&self, int var) -> bool {
+        if (++nodes > kMaxEnumerationNodes) return false;
+        if (var == varCount) {
+            m_ways[mines] += 1.0;
+            double *row = m_cellWays.data() + size_t(mines) * varCount;
+            for (int i = 0; i < varCount; ++i) row[i] += assignment[i];
+            return true;
+        }
+        for (int value = 0; value <= 1; ++value) {
+            bool consistent = true;
+            for (int s : slotsOfVar[var]) {
+                Slot &slot = slots[s];
+                slot.open--;
+                slot.assigned += value;
+                consistent = consistent && slot.assigned <= slot.required && slot.assigned + slot.open >= slot.required;
+            }
+            if (consistent) {
+                assignment[var] = std::uint8_t(value);
+                mines += value;
+                const bool ok = self(self, var + 1);
+                mines -= value;
+                assignment[var] = 0;
+                if (!ok) {
+                    for (int s : slotsOfVar[var]) { slots[s].open++; slots[s].assigned -= value; }
+                    return false;
+                }
+            }
+            for (int s : slotsOfVar[var]) {
+                slots[s].open++;
+                slots[s].assigned -= value;
+            }
+        }
+        return true;
+    };
+    return search(search, 0);
+}
+
+//computeProbabilities的实现
+void Solver::computeProbabilities(const Board &board, std::vector<double> &probabilities) {
+    const int cellCount = m_rows * m_cols;
+    probabilities.assign(cellCount, 0.0);
+    if (cellCount == 0) return;
+
+    //首次点击之前还没有布雷，所有格子的概率相同
+    if (board.getGameState() == GameState::Ready) {
+        std::fill(probabilities.begin(), probabilities.end(), double(board.getMineCount()) / cellCount);
+        return;
+    }
+
+    std::vector<ComponentResult> components;
+    double interiorProbability = 0.0;
+    bool learned = true;
+    //精确枚举可能得到新的确定结论，学到之后重新推理并重新枚举，直到没有新结论为止
+    while (learned) {
+        learned = false;
+        components.clear();
+        m_localIndex.assign(cellCount, -1);
+
+        //按连通分量收集边界：从一个未知格子出发，经由共享的数字格找到所有互相关联的未知格子
+        std::vector<int> pending;
+        for (int start = 0; start < cellCount; ++start) {
+            if (m_localIndex[start] != -1 || m_knowledge[start] != std::uint8_t(Knowledge::Unknown)) continue;
+            bool onFrontier = false;
+            forEachNeighbor(start, [&](int neighbor) {
+                onFrontier = onFrontier || board.getCell(neighbor / m_cols, neighbor % m_cols).isRevealed;
+            });
+            if (!onFrontier) continue;
+
+            ComponentResult component;
+            std::vector<int> constraints;
+            m_localIndex[start] = 0;
+            component.vars.push_back(start);
+            pending.assign(1, start);
+            while (!pending.empty()) {
+                const int var = pending.back();
+                pending.pop_back();
+                forEachNeighbor(var, [&](int number) {
+                    if (m_localIndex[number] != -1 || !board.getCell(number / m_cols, number % m_cols).isRevealed) return;
+                    m_localIndex[number] = -2;
+                    constraints.push_back(number);
+                    forEachNeighbor(number, [&](int next) {
+                        if (m_localIndex[next] != -1 || m_knowledge[next] != std::uint8_t(Knowledge::Unknown)) return;
+                        m_localIndex[next] = int(component.vars.size());
+                        component.vars.push_back(next);
+                        pending.push_back(next);
+                    });
+                });
+            }
+
+            if (!enumerateComponent(board, component.vars, constraints)) {
+                //放弃枚举的分量中的格子按非边界格子处理
+                for (int var : component.vars) m_localIndex[var] = -3;
+                continue;
+            }
+            component.ways = m_ways;
+            component.cellWays = m_cellWays;
+
+            //在所有满足约束的布雷方式中都不是雷（或都是雷）的格子是确定的
+            const int varCount = int(component.vars.size());
+            double total = 0.0;
+            for (double ways : component.ways) total += ways;
+            for (int i = 0; i < varCount; ++i) {
+                double mineWays = 0.0;
+                for (int k = 0; k <= varCount; ++k) mineWays += component.cellWays[size_t(k) * varCount + i];
+                if (mineWays == 0.0) {
+                    learn(board, component.vars[i], Knowledge::Safe);
+                    learned = true;
+                } else if (mineWays == total) {
+                    learn(board, component.vars[i], Knowledge::Mine);
+                    learned = true;
+                }
+            }
+            components.push_back(std::move(component));
+        }
+        if (learned) {
+            propagate(board);
+            continue;
+        }
+
+        //剩余地雷数M，以及不在任何已枚举分量中的未知格子数I（“内部”格子）
+        int remainingMines = board.getMineCount();
+        int interior = 0;
+        for (int cell = 0; cell < cellCount; ++cell) {
+            if (m_knowledge[cell] == std::uint8_t(Knowledge::Mine)) {
+                remainingMines--;
+            } else if (m_knowledge[cell] == std::uint8_t(Knowledge::Unknown) && m_localIndex[cell] < 0) {
+                interior++;
+            }
+        }
+
+        //边界上共放m颗雷的方式数要乘以剩下的M-m颗雷放进I个内部格子的方式数C(I, M-m)，在对数空间中计算以免溢出
+        std::vector<double> total{1.0};
+        for (const ComponentResult &component : components) total = convolve(total, component.ways);
+        std::vector<double> logWeight(total.size() + 1);
+        double maxLog = -HUGE_VAL;
+        for (size_t m = 0; m < logWeight.size(); ++m) {
+            const int rest = remainingMines - int(m);
+            logWeight[m] = (rest < 0 || rest > interior) ? -HUGE_VAL : logBinomial(interior, rest);
+            if (m < total.size() && total[m] > 0.0) maxLog = std::max(maxLog, logWeight[m]);
+        }
+        auto weight = [&](size_t m) {
+            return m < logWeight.size() && logWeight[m] != -HUGE_VAL ? std::exp(logWeight[m] - maxLog) : 0.0;
+        };
+
+        double normalizer = 0.0, interiorMines = 0.0;
+        for (size_t m = 0; m < total.size(); ++m) {
+            normalizer += total[m] * weight(m);
+            if (interior > 0) interiorMines += total[m] * weight(m) * double(remainingMines - int(m)) / interior;
+        }
+        if (normalizer <= 0.0) {
+            //约束互相矛盾（只在棋盘异常时发生），退回按平均密度估计
+            const int unknown = std::max(1, interior);
+            interiorProbability = std::clamp(double(remainingMines) / unknown, 0.0, 1.0);
+            for (const ComponentResult &component : components) {
+                for (int var : component.vars) probabilities[var] = interiorProbability;
+            }
+            break;
+        }
+        interiorProbability = interiorMines / normalizer;
+
+        //每个分量的格子：先把其余分量卷积起来，再对本分量的每种地雷数k加权
+        for (size_t i = 0; i < components.size(); ++i) {
+            const ComponentResult &component = components[i];
+            std::vector<double> others{1.0};
+            for (size_t j = 0; j < components.size(); ++j) {
+                if (j != i) others = convolve(others, components[j].ways);
+            }
+            const int varCount = int(component.vars.size());
+            for (int k = 0; k <= varCount; ++k) {
+                double factor = 0.0;
+                for (size_t m = 0; m < others.size(); ++m) factor += others[m] * weight(size_t(k) + m);
+                if (factor == 0.0) continue;
+                const double *row = component.cellWays.data() + size_t(k) * varCount;
+                for (int v = 0; v < varCount; ++v) probabilities[component.vars[v]] += row[v] * factor / normalizer;
+            }
+        }
+    }
+
+    //已确定的格子和内部格子
+    for (int cell = 0; cell < cellCount; ++cell) {
+        const auto knowledge = Knowledge(m_knowledge[cell]);
+        if (knowledge == Knowledge::Safe) {
+            probabilities[cell] = 0.0;
+        } else if (knowledge == Knowledge::Mine) {
+            probabilities[cell] = 1.0;
+        } else if (m_localIndex[cell] < 0) {
+            probabilities[cell] = interiorProbability;
+        }
+    }
+}
+
+//hint的实现
+Solver::Hint Solver::hint(const Board &board) {
+    Hint hint;
+    const GameState state = board.getGameState();
+    if (state == GameState::Won || state == GameState::Lost || m_rows * m_cols == 0) return hint;
+
+    //首次点击必然安全，建议从棋盘中央开始
+    if (state == GameState::Ready) {
+        hint.row = m_rows / 2;
+        hint.col = m_cols / 2;
+        hint.mineProbability = 0.0;
+        hint.certain = true;
+        return hint;
+    }
+
+    //从推理出的安全格子中取一个还没有被翻开、也没有被插旗的
+    auto takeSafeCell = [&]() {
+        while (!m_safeCells.empty()) {
+            const int cell = m_safeCells.back();
+            const Cell cellState = board.getCell(cell / m_cols, cell % m_cols);
+            if (!cellState.isRevealed && !cellState.isFlagged) {
+                hint.row = cell / m_cols;
+                hint.col = cell % m_cols;
+                hint.mineProbability = 0.0;
+                hint.certain = true;
+                return true;
+            }
+            m_safeCells.pop_back();
+        }
+        return false;
+    };
+    if (takeSafeCell()) return hint;
+
+    //确定性推理没有结论时计算概率（精确枚举可能会得到新的安全格子）
+    std::vector<double> probabilities;
+    computeProbabilities(board, probabilities);
+    if (takeSafeCell()) return hint;
+
+    for (int cell = 0; cell < m_rows * m_cols; ++cell) {
+        const Cell cellState = board.getCell(cell / m_cols, cell % m_cols);
+        if (cellState.isRevealed || cellState.isFlagged) continue;
+        if (hint.row < 0 || probabilities[cell] < hint.mineProbability) {
+            hint.row = cell / m_cols;
+            hint.col = cell % m_cols;
+            hint.mineProbability = probabilities[cell];
+        }
+    }
+    return hint;
+}
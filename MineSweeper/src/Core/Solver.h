@@ -0,0 +1,100 @@
+#ifndef MINESWEEPER_SOLVER_H
+#define MINESWEEPER_SOLVER_H
+
+/*
+Solver是基于约束传播的扫雷求解器，属于不依赖Qt的核心库
+它只使用玩家能看到的信息（已翻开格子上的数字），不读取地雷位置，也不相信玩家插的旗帜（旗帜可能插错）
+
+求解分两个层次：
+1.确定性推理：单格规则（数字减去已知地雷数为0，或等于未知邻居数）和子集规则（一个数字的未知邻居是另一个数字的未知邻居的子集时，
+  差集中的地雷数是两个数字的差），推理是增量进行的：每次操作只重新检查被改变格子附近的数字
+2.概率计算：对剩下的边界（与数字相邻的未知格子）按连通分量精确枚举所有满足约束的布雷方式，
+  再结合剩余地雷在非边界格子中的组合数，得到每个未知格子是地雷的精确概率
+*/
+
+#include <cstdint>  //包含固定宽度的整数类型
+#include <vector>  //包含std::vector
+#include "Board.h"  //求解器读取Board中已翻开格子的数字
+
+class Solver {
+public:
+    //求解器对一个格子的了解程度
+    enum class Knowledge : std::uint8_t {
+        Unknown,  //无法确定
+        Safe,  //一定不是地雷（包括所有已翻开的格子）
+        Mine  //一定是地雷
+    };
+
+    //一次提示的结果
+    struct Hint {
+        int row = -1;  //建议翻开的格子，没有可建议的格子（例如游戏已结束）时为-1
+        int col = -1;
+        double mineProbability = 1.0;  //该格子是地雷的概率，0表示确定安全
+        bool certain = false;  //是否是确定安全的格子
+    };
+
+    //开始求解一局新的棋盘：丢弃之前的所有推理结果，并根据棋盘上已翻开的格子重新推理一遍
+    void reset(const Board &board);
+
+    //增量更新：changedCells是Board::getChangedCells()中的行优先编号，只有这些格子及其邻居的数字会被重新检查
+    //撤销后重新被盖上的格子也在changedCells中，其中已知安全的格子会重新成为提示的候选
+    void update(const Board &board, const std::vector<int> &changedCells);
+
+    //返回求解器对某个格子的了解程度
+    Knowledge knowledge(int row, int col) const { return Knowledge(m_knowledge[row * m_cols + col]); }
+
+    //计算每个格子是地雷的概率，结果按行优先存入probabilities（已翻开或确定安全的格子为0，确定是地雷的格子为1）
+    //精确枚举得到的确定结论（概率恰好为0或1）会被记入推理结果，并继续进行确定性推理
+    void computeProbabilities(const Board &board, std::vector<double> &probabilities);
+
+    //给出下一步建议：优先返回一个确定安全的未翻开格子，没有时返回地雷概率最低的格子
+    Hint hint(const Board &board);
+
+    //当前已推理出但尚未翻开的安全格子（行优先编号），其中可能包含已经被翻开的格子，使用时需要检查
+    const std::vector<int> &safeCells() const { return m_safeCells; }
+
+private:
+    //一个数字约束：某个已翻开数字格周围尚未确定的格子，以及其中还需要放置的地雷数
+    struct Constraint {
+        int cells[8];  //尚未确定的邻居（行优先编号），按编号从小到大排列
+        int count = 0;  //尚未确定的邻居数
+        int mines = 0;  //这些邻居中还需要的地雷数
+    };
+
+    //读取cell处数字格的当前约束，cell不是已翻开的格子时返回false
+    bool constraintOf(const Board &board, int cell, Constraint &constraint) const;
+
+    //把cell处的数字格加入待检查队列（已在队列中的不会重复加入）
+    void enqueue(int cell);
+
+    //把cell及其周围的已翻开格子加入待检查队列
+    void enqueueAround(const Board &board, int cell);
+
+    //记录一个推理结论，并把受影响的数字格加入待检查队列
+    void learn(const Board &board, int cell, Knowledge knowledge);
+
+    //处理待检查队列直到为空，依次应用单格规则和子集规则
+    void propagate(const Board &board);
+
+    //对一个边界连通分量做精确枚举，结果写入m_ways和m_cellWays；vars是其中的未知格子，constraints是与它们相邻的数字格
+    //搜索的节点数超过上限时放弃并返回false
+    bool enumerateComponent(const Board &board, const std::vector<int> &vars, const std::vector<int> &constraints);
+
+    //对格子的8个邻居调用visit（自动跳过棋盘外的位置）
+    template <typename Visit>
+    void forEachNeighbor(int cell, Visit &&visit) const;
+
+    int m_rows = 0;
+    int m_cols = 0;
+    std::vector<std::uint8_t> m_knowledge;  //每个格子的Knowledge，按行优先存储
+    std::vector<std::uint8_t> m_queued;  //每个格子是否已在待检查队列中
+    std::vector<int> m_queue;  //待检查的数字格
+    std::vector<int> m_safeCells;  //推理出的安全格子（用作提示的候选）
+
+    //--- 精确枚举时复用的工作内存 ---
+    std::vector<int> m_localIndex;  //边界格子在所属连通分量中的下标；-1表示尚未访问，-2表示已访问过的数字格
+    std::vector<double> m_ways;  //当前分量中恰好放k颗雷的布雷方式数
+    std::vector<double> m_cellWays;  //当前分量中恰好放k颗雷、且第i个格子是雷的方式数，按[k * 变量数 + i]存储
+};
+
+#endif //MINESWEEPER_SOLVER_H
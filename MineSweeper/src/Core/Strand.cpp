@@ -0,0 +1,57 @@
+#include "Strand.h"
+#include <algorithm>  //包含std::min
+
+//Strand析构函数的实现
+Strand::~Strand() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_closing = true;
+    m_pending.clear();
+    //已经提交给线程池的drain还会执行一次（或者正在执行一个任务），它看到m_closing后丢弃剩下的任务并结束；必须等它结束，它访问的是这个对象
+    m_idle.wait(lock, [this]() { return !m_scheduled; });
+}
+
+//提交任务的实现
+void Strand::post(Task task) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_closing) return;
+        m_pending.push_back(std::move(task));
+        //已经有drain在执行或等待执行时，它会把新的任务一起执行，不需要再提交
+        if (m_scheduled) return;
+        m_scheduled = true;
+    }
+    m_pool.submit([this]() { drain(); });
+}
+
+//执行一批任务的实现
+void Strand::drain() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        //上一批全部执行完了，取走目前提交的全部任务（两个队列互相交换，稳定状态下不分配内存）
+        if (m_next == m_running.size() && !m_closing) {
+            m_running.clear();
+            m_next = 0;
+            m_running.swap(m_pending);
+        }
+    }
+
+    //每个任务开始之前都检查m_closing：析构开始之后，这一批中还没有开始的任务也不再执行，直接到下面收尾
+    const std::size_t end = std::min(m_running.size(), m_next + kBatchSize);
+    while (m_next < end && !m_closing.load(std::memory_order_relaxed)) {
+        Task task = std::move(m_running[m_next++]);
+        task();
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (!m_closing && (m_next < m_running.size() || !m_pending.empty())) {
+        //还有任务：重新提交自己，排到这个工作线程队列的末尾，让其他Strand先执行
+        lock.unlock();
+        m_pool.submit([this]() { drain(); });
+        return;
+    }
+    m_running.clear();
+    m_next = 0;
+    m_scheduled = false;
+    //在锁内通知：析构函数被唤醒后要先拿到锁才能返回，那时这里已经不再访问这个对象
+    m_idle.notify_all();
+}
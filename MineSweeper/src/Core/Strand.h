@@ -0,0 +1,56 @@
+#ifndef MINESWEEPER_STRAND_H
+#define MINESWEEPER_STRAND_H
+
+/*
+Strand是建立在WorkStealingPool之上的串行执行器，属于不依赖Qt的核心库
+提交给同一个Strand的任务严格按提交顺序逐个执行，任意时刻最多只有一个在执行，所以它们访问的数据（例如一局游戏）不需要加锁；
+不同Strand的任务则在线程池的各个线程上并行执行。Strand本身不占用线程，没有任务时只是几十字节的数据
+
+- 有任务时Strand向线程池提交一个“执行一批”的任务，每批最多执行kBatchSize个，还有剩余时重新提交自己，
+  一个命令很多的Strand不会长时间占住一个工作线程，其他Strand的任务照样能轮到
+- 任务可能在不同的工作线程上执行（前后两个任务之间有完整的同步，后一个总能看到前一个的全部结果）
+*/
+
+#include <atomic>  //包含std::atomic，drain在两个任务之间不加锁地检查析构是否已经开始
+#include <condition_variable>  //包含std::condition_variable，析构时等待正在执行的一批任务
+#include <cstddef>  //包含std::size_t
+#include <mutex>  //包含std::mutex
+#include <vector>  //包含std::vector，用作任务队列
+#include "WorkStealingPool.h"
+
+class Strand {
+public:
+    using Task = WorkStealingPool::Task;
+
+    //每批最多连续执行的任务数
+    static constexpr std::size_t kBatchSize = 64;
+
+    //任务在pool中执行，pool必须比Strand活得更久
+    explicit Strand(WorkStealingPool &pool) : m_pool(pool) {}
+
+    //丢弃还没有开始执行的任务，并等待正在执行的一批结束；不能在这个Strand自己的任务中析构
+    ~Strand();
+
+    Strand(const Strand &) = delete;
+    Strand &operator=(const Strand &) = delete;
+
+    //提交一个任务，它会在此前提交的任务全部执行完之后执行；可以在任何线程中调用，包括这个Strand自己的任务中
+    void post(Task task);
+
+private:
+    //在线程池中执行一批任务
+    void drain();
+
+    WorkStealingPool &m_pool;
+    std::mutex m_mutex;  //保护m_pending和m_scheduled，m_closing只在持有它时写入
+    std::condition_variable m_idle;  //一批任务执行完、不再需要执行时唤醒析构函数
+    std::vector<Task> m_pending;  //已提交、还没有被取走执行的任务
+    bool m_scheduled = false;  //是否已经向线程池提交了drain（提交之后直到没有任务为止一直为true）
+    std::atomic<bool> m_closing{false};  //析构函数已经开始，剩下的任务（包括已经取到m_running中的）不再执行
+
+    //--- 以下成员只在drain中访问，同一时刻最多只有一个drain在执行 ---
+    std::vector<Task> m_running;  //从m_pending取走的一批任务
+    std::size_t m_next = 0;  //m_running中下一个要执行的任务
+};
+
+#endif //MINESWEEPER_STRAND_H
@@ -0,0 +1,99 @@
+#include "UndoHistory.h"
+#include <algorithm>  //包含std::min
+
+namespace {
+//创建时预留的格子编号数和记录数，足够一般的一局使用，操作时不需要分配内存
+//会话服务器中同时有成千上万局游戏，预留的内存保持在每局20KB左右
+constexpr std::size_t kInitialCells = 1024;
+constexpr std::size_t kInitialRecords = 1024;
+}
+
+//UndoHistory构造函数的实现
+UndoHistory::UndoHistory(std::size_t capacity) : m_capacity(std::max<std::size_t>(1, capacity)) {
+    m_cells.reserve(std::min(m_capacity, kInitialCells));
+    m_records.reserve(std::min(m_capacity, kInitialRecords));
+}
+
+//clear的实现
+void UndoHistory::clear() {
+    //位置继续单调递增，缓冲区保留已有的内容和容量，之后直接覆盖
+    m_firstRecord = m_current = m_endRecord;
+}
+
+//store的实现
+template <typename T>
+void UndoHistory::store(std::vector<T> &ring, std::uint64_t position, const T &value) {
+    //位置是连续写入的，所以还没有写满一圈时，缓冲区中的下标要么已经存在，要么恰好是末尾
+    const std::size_t slot = std::size_t(position % m_capacity);
+    if (slot < ring.size()) {
+        ring[slot] = value;
+    } else {
+        ring.push_back(value);
+    }
+}
+
+//记录一次操作的实现
+void UndoHistory::record(const Board &board, std::uint8_t bit, GameState before) {
+    //被撤销的记录不能再重做，新的记录从这里开始覆盖它们
+    m_endCell = firstCellOf(m_current);
+    m_endRecord = m_current;
+
+    //失败时getChangedCells()还包含其余未翻开的地雷，它们没有被改变，只记录这次操作真正翻转了位的格子
+    const std::vector<int> &changed = board.getChangedCells();
+    const int cols = board.getCols();
+    std::size_t count = 0;
+    for (int cell : changed) {
+        if (bit == CellBits::Revealed && !board.getCell(cell / cols, cell % cols).isRevealed) continue;
+        ++count;
+    }
+    if (count > m_capacity) {
+        //整个缓冲区也放不下这一步，它和之前的操作都无法撤销
+        clear();
+        return;
+    }
+
+    //丢弃最早的记录，直到缓冲区中放得下这一步的格子和这条记录本身
+    while (m_firstRecord < m_endRecord
+           && (m_endCell + count - firstCellOf(m_firstRecord) > m_capacity || m_endRecord - m_firstRecord >= m_capacity)) {
+        ++m_firstRecord;
+    }
+
+    Record record;
+    record.firstCell = m_endCell;
+    record.count = std::uint32_t(count);
+    record.bit = bit;
+    record.before = std::uint8_t(before);
+    record.after = std::uint8_t(board.getGameState());
+    for (int cell : changed) {
+        if (bit == CellBits::Revealed && !board.getCell(cell / cols, cell % cols).isRevealed) continue;
+        store(m_cells, m_endCell++, cell);
+    }
+    store(m_records, m_endRecord++, record);
+    m_current = m_endRecord;
+}
+
+//撤销的实现
+bool UndoHistory::undo(Board &board) {
+    if (!canUndo()) return false;
+    const Record &record = recordAt(--m_current);
+    apply(board, record, GameState(record.before));
+    return true;
+}
+
+//重做的实现
+bool UndoHistory::redo(Board &board) {
+    if (!canRedo()) return false;
+    const Record &record = recordAt(m_current++);
+    apply(board, record, GameState(record.after));
+    return true;
+}
+
+//apply的实现
+void UndoHistory::apply(Board &board, const Record &record, GameState state) {
+    //记录的格子在环形缓冲区中可能绕回了开头，先复制成连续的一段再交给Board
+    m_scratch.clear();
+    for (std::uint64_t position = record.firstCell; position < record.firstCell + record.count; ++position) {
+        m_scratch.push_back(m_cells[std::size_t(position % m_capacity)]);
+    }
+    board.toggleCells(m_scratch, record.bit, state);
+}
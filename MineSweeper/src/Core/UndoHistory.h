@@ -0,0 +1,83 @@
+#ifndef MINESWEEPER_UNDOHISTORY_H
+#define MINESWEEPER_UNDOHISTORY_H
+
+/*
+UndoHistory为一局游戏提供撤销和重做，属于不依赖Qt的核心库
+它不保存棋盘的副本，每一步只记下一条增量记录：这一步翻转了哪些格子的哪一个位（翻开或插旗），以及操作前后的游戏状态
+- 翻开、双击、插旗只会让格子的Revealed或Flagged位从0变成1（插旗是取反），所以撤销和重做都只需把同一批格子的同一个位再取反一次，
+  计数器由Board::toggleCells随之增量更新，不需要另外保存
+- 地雷布局在首次翻开时确定后就不再改变：撤销首次翻开只会盖上翻开的格子，不会撤掉地雷，游戏保持在进行中状态
+- 所有记录的格子编号依次存放在一个环形缓冲区中，内存只随被改变的格子数增长，与棋盘大小和步数无关；
+  缓冲区写满时最早的记录被覆盖（能撤销的步数没有上限，只受缓冲区中能容纳的格子数限制）
+*/
+
+#include <cstddef>  //包含std::size_t
+#include <cstdint>  //包含固定宽度的整数类型
+#include <vector>  //包含std::vector，作为环形缓冲区
+#include "Board.h"  //包含Board、CellBits和GameState
+
+class UndoHistory {
+public:
+    //默认最多保存的格子编号数，足够撤销一般的一局中的全部操作
+    //每个格子编号4字节、每条记录16字节，即使每步只改变一个格子，写满时也只占约20MB
+    static constexpr std::size_t kDefaultCapacity = std::size_t(1) << 20;
+
+    //capacity是环形缓冲区最多保存的格子编号数
+    explicit UndoHistory(std::size_t capacity = kDefaultCapacity);
+
+    //丢弃全部记录（开始新的一局时调用）
+    void clear();
+
+    //记录刚刚在board上完成的一次操作（只应记录Board返回true的操作），before是操作之前的游戏状态
+    //bit是这次操作翻转的位：翻开和双击是CellBits::Revealed，插旗是CellBits::Flagged
+    //之前被撤销、还没有重做的记录全部作废；一次操作改变的格子比整个缓冲区还多时，之前的记录也无法再撤销，全部丢弃
+    void record(const Board &board, std::uint8_t bit, GameState before);
+
+    //撤销最近的一次操作，返回是否撤销了；之后board.getChangedCells()是被撤销的操作影响的格子
+    bool undo(Board &board);
+
+    //重做最近被撤销的一次操作，返回是否重做了
+    bool redo(Board &board);
+
+    bool canUndo() const { return m_current > m_firstRecord; }  //是否有可以撤销的操作
+    bool canRedo() const { return m_current < m_endRecord; }  //是否有可以重做的操作
+
+    //当前保存的全部记录占用的格子编号数
+    std::size_t getCellCount() const { return std::size_t(m_endCell - firstCellOf(m_firstRecord)); }
+
+private:
+    //一条增量记录，格子编号存放在m_cells中从firstCell开始的count个位置
+    struct Record {
+        std::uint64_t firstCell = 0;  //第一个格子编号的位置（单调递增，对容量取模后才是缓冲区中的下标）
+        std::uint32_t count = 0;  //格子数
+        std::uint8_t bit = 0;  //翻转的位
+        std::uint8_t before = 0;  //操作之前的游戏状态（GameState，按字节存放使每条记录只占16字节）
+        std::uint8_t after = 0;  //操作之后的游戏状态
+    };
+
+    //取出第index条记录（index是单调递增的记录序号）
+    Record &recordAt(std::uint64_t index) { return m_records[index % m_capacity]; }
+
+    //第index条记录的第一个格子编号的位置；index等于m_endRecord时是下一条记录的位置
+    std::uint64_t firstCellOf(std::uint64_t index) const {
+        return index == m_endRecord ? m_endCell : m_records[index % m_capacity].firstCell;
+    }
+
+    //在环形缓冲区中的单调递增位置position处写入value（缓冲区还没有达到容量时在末尾追加）
+    template <typename T>
+    void store(std::vector<T> &ring, std::uint64_t position, const T &value);
+
+    //把record中的格子复制到m_scratch，并在board上把它们的位取反，最后把游戏状态设为state
+    void apply(Board &board, const Record &record, GameState state);
+
+    std::size_t m_capacity;  //环形缓冲区的容量（格子编号数，也是记录数的上限，因为每条记录至少有一个格子）
+    std::vector<int> m_cells;  //所有记录的格子编号（行优先编号）
+    std::vector<Record> m_records;  //所有记录
+    std::uint64_t m_firstRecord = 0;  //最早的仍然保存着的记录序号
+    std::uint64_t m_current = 0;  //下一次撤销的是这之前的一条，下一次重做的是这一条
+    std::uint64_t m_endRecord = 0;  //最后一条记录之后的序号
+    std::uint64_t m_endCell = 0;  //最后一条记录的最后一个格子之后的位置
+    std::vector<int> m_scratch;  //撤销和重做时交给Board的格子列表，作为成员复用以避免每次都重新分配内存
+};
+
+#endif //MINESWEEPER_UNDOHISTORY_H
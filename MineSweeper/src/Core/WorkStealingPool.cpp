@@ -0,0 +1,122 @@
+#include "WorkStealingPool.h"
+#include <algorithm>  //包含std::max
+
+namespace {
+//当前线程所属的线程池和它在其中的编号，不是工作线程时为空
+thread_local const WorkStealingPool *t_pool = nullptr;
+thread_local int t_index = -1;
+}
+
+//WorkStealingPool构造函数的实现
+WorkStealingPool::WorkStealingPool(int threads) {
+    if (threads <= 0) {
+        threads = std::max(1, int(std::thread::hardware_concurrency()));
+    }
+    //先建好全部队列再启动线程，工作线程窃取时会访问所有队列
+    for (int i = 0; i < threads; ++i) {
+        m_workers.push_back(std::make_unique<Worker>());
+    }
+    for (int i = 0; i < threads; ++i) {
+        m_threads.emplace_back([this, i]() { run(i); });
+    }
+}
+
+//WorkStealingPool析构函数的实现
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+    for (std::thread &thread : m_threads) {
+        thread.join();
+    }
+}
+
+//提交任务的实现
+void WorkStealingPool::submit(Task task) {
+    ++m_unfinished;
+    //工作线程提交的任务（例如Strand接着执行下一批命令）放进自己的队列，外部线程提交的任务轮流分给各个队列
+    const int index = t_pool == this ? t_index : int(m_nextQueue.fetch_add(1, std::memory_order_relaxed) % m_workers.size());
+    {
+        std::lock_guard<std::mutex> lock(m_workers[index]->mutex);
+        m_workers[index]->tasks.push_back(std::move(task));
+    }
+    //先增加任务数再检查睡眠线程数，工作线程则先增加睡眠线程数再检查任务数，两边至少有一边能看到对方，不会漏掉唤醒
+    ++m_queued;
+    if (m_sleeping.load() > 0) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_wake.notify_one();
+    }
+}
+
+//等待空闲的实现
+void WorkStealingPool::waitForIdle() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idle.wait(lock, [this]() { return m_unfinished.load() == 0; });
+}
+
+//stats的实现
+WorkStealingPool::Stats WorkStealingPool::stats() const {
+    Stats stats;
+    for (const auto &worker : m_workers) {
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        stats.executed += worker->executed;
+        stats.stolen += worker->stolen;
+    }
+    return stats;
+}
+
+//pop的实现
+bool WorkStealingPool::pop(int index, Task &task) {
+    Worker &worker = *m_workers[index];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (worker.tasks.empty()) return false;
+    task = std::move(worker.tasks.front());
+    worker.tasks.pop_front();
+    ++worker.executed;
+    return true;
+}
+
+//steal的实现
+bool WorkStealingPool::steal(int index, Task &task) {
+    //从下一个线程开始依次查看，避免所有空闲线程都去窃取同一个队列
+    const int count = int(m_workers.size());
+    for (int offset = 1; offset < count; ++offset) {
+        Worker &victim = *m_workers[(index + offset) % count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.tasks.empty()) continue;
+        task = std::move(victim.tasks.back());
+        victim.tasks.pop_back();
+        ++victim.executed;
+        ++victim.stolen;
+        return true;
+    }
+    return false;
+}
+
+//工作线程主循环的实现
+void WorkStealingPool::run(int index) {
+    t_pool = this;
+    t_index = index;
+    Task task;
+    for (;;) {
+        if (pop(index, task) || steal(index, task)) {
+            --m_queued;
+            task();
+            task = nullptr;  //立即释放任务捕获的资源
+            if (--m_unfinished == 0) {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_idle.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        ++m_sleeping;
+        m_wake.wait(lock, [this]() { return m_stopping || m_queued.load() > 0; });
+        --m_sleeping;
+        //停止时先把剩下的任务执行完
+        if (m_stopping && m_queued.load() <= 0) return;
+    }
+}
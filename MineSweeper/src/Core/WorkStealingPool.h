@@ -0,0 +1,85 @@
+#ifndef MINESWEEPER_WORKSTEALINGPOOL_H
+#define MINESWEEPER_WORKSTEALINGPOOL_H
+
+/*
+WorkStealingPool是固定线程数的任务线程池，属于不依赖Qt的核心库，会话服务器用它运行成千上万局游戏
+- 每个工作线程有自己的任务队列：工作线程提交的任务放进自己的队列，外部线程提交的任务轮流放进各个队列，
+  提交和执行通常只接触一个队列，工作线程之间很少争用同一把锁
+- 工作线程从自己队列的队首取任务（先进先出，同一个线程上的会话轮流得到执行）；自己的队列空了时，从其他线程的队尾窃取任务
+- 所有队列都空了时工作线程睡眠，有新任务时只唤醒一个；没有睡眠的线程时提交任务不需要任何全局锁
+需要按顺序执行的一串任务（例如同一局游戏的命令）应通过Strand提交，见Strand.h
+*/
+
+#include <atomic>  //包含std::atomic，用于任务计数和睡眠线程计数
+#include <condition_variable>  //包含std::condition_variable，用于唤醒睡眠的工作线程和等待空闲
+#include <cstdint>  //包含固定宽度的整数类型
+#include <deque>  //包含std::deque，用作每个工作线程的任务队列
+#include <functional>  //包含std::function，用于保存任务
+#include <memory>  //包含std::unique_ptr
+#include <mutex>  //包含std::mutex
+#include <thread>  //包含std::thread
+#include <vector>  //包含std::vector
+
+class WorkStealingPool {
+public:
+    using Task = std::function<void()>;
+
+    //统计数据
+    struct Stats {
+        std::uint64_t executed = 0;  //已执行的任务数
+        std::uint64_t stolen = 0;  //其中从其他线程的队列中窃取来执行的任务数
+    };
+
+    //启动threads个工作线程，threads不大于0时使用硬件线程数
+    explicit WorkStealingPool(int threads = 0);
+
+    //执行完所有已提交的任务（包括执行过程中新提交的任务）后停止并等待所有工作线程
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool &) = delete;
+    WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+    //提交一个任务，它会在某个工作线程中执行；任务不应抛出异常
+    void submit(Task task);
+
+    //阻塞等待，直到所有已提交的任务（包括执行过程中新提交的任务）都执行完毕；不能在工作线程中调用
+    void waitForIdle();
+
+    //返回工作线程数
+    int getThreadCount() const { return int(m_threads.size()); }
+
+    //返回统计数据
+    Stats stats() const;
+
+private:
+    //一个工作线程的任务队列
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+        std::uint64_t executed = 0;  //由mutex保护
+        std::uint64_t stolen = 0;
+    };
+
+    //工作线程的主循环，index是线程编号
+    void run(int index);
+
+    //从第index个线程自己的队列队首取出一个任务
+    bool pop(int index, Task &task);
+
+    //从其他线程的队列队尾窃取一个任务
+    bool steal(int index, Task &task);
+
+    std::vector<std::unique_ptr<Worker>> m_workers;  //每个工作线程的队列，线程编号就是下标
+    std::vector<std::thread> m_threads;
+    std::atomic<unsigned> m_nextQueue{0};  //外部线程提交任务时下一个使用的队列
+    std::atomic<int> m_queued{0};  //队列中的任务数（提交之后、被取出之前）
+    std::atomic<std::int64_t> m_unfinished{0};  //已提交但还没有执行完的任务数，为0时线程池空闲
+    std::atomic<int> m_sleeping{0};  //正在睡眠（或即将睡眠）的工作线程数
+
+    std::mutex m_mutex;  //保护m_stopping，并与下面两个条件变量配合使用
+    std::condition_variable m_wake;  //有新任务或需要停止时唤醒工作线程
+    std::condition_variable m_idle;  //所有任务都执行完时唤醒waitForIdle
+    bool m_stopping = false;
+};
+
+#endif //MINESWEEPER_WORKSTEALINGPOOL_H
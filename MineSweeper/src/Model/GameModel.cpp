@@ -1,169 +1,134 @@
 #include "GameModel.h"
-#include <QRandomGenerator>  //包含Qt的随机数生成器，用于安全地随机放置地雷
-#include <QDebug>  //包含Qt的调试输出工具
+#include <QFile>  //包含QFile::encodeName，把文件路径转换成本地编码
+#include <QRandomGenerator>  //包含Qt的随机数生成器，只用于在调用者未指定种子时生成一个随机种子
+#include "../Core/BoardPool.h"  //包含预先生成布局的后台服务
 
 //GameModel的构造函数实现
-//初始化列表 `: QObject(parent)` 调用基类的构造函数，`m_gameState(GameState::Ready)` 初始化游戏状态为准备就绪
-GameModel::GameModel(QObject *parent) : QObject(parent), m_gameState(GameState::Ready){}
-
-//开始新游戏的实现
-void GameModel::startGame(int rows, int cols, int mines) {
-    //初始化或重置游戏的核心数据
-    m_rows = rows;
-    m_cols = cols;
-    m_mineCount = mines;  //设置行数、列数和地雷数
-    m_revealedCount = 0;  //重置已翻开格子计数
-    m_gameState = GameState::Ready;  //重新设置为准备状态
+//初始化列表 `: QObject(parent)` 调用基类的构造函数，Board默认处于准备状态
+GameModel::GameModel(QObject *parent) : QObject(parent) {}
+
+//开始新游戏（随机种子）的实现
+void GameModel::startGame(int rows, int cols, int mines, FirstClickPolicy policy) {
+    //每局只向全局生成器取一次种子，布雷过程本身使用快速的本地生成器
+    startGame(rows, cols, mines, QRandomGenerator::global()->generate64(), policy);
+
+    //随机的一局可以使用池中的布局；设置与上一局相同时池中已有的布局保留下来，不同时池会丢弃旧布局并开始为新设置生成
+    if (m_pool) {
+        m_pool->configure({m_board.getRows(), m_board.getCols(), m_board.getMineCount(), m_board.getFirstClickPolicy()});
+        m_usePool = true;
+    }
+}
 
-    //使用assign方法重置二维网格，创建一个新的rows x cols大小的棋盘，所有Cell都为默认值
-    m_grid.assign(m_rows, QVector<Cell>(m_cols));
+//开始新游戏（指定种子）的实现
+void GameModel::startGame(int rows, int cols, int mines, quint64 seed, FirstClickPolicy policy) {
+    m_board.startGame(rows, cols, mines, seed, policy);
+    m_journal.start(m_board.getRows(), m_board.getCols(), m_board.getMineCount(), seed, m_board.getFirstClickPolicy());
+    m_history.clear();
+    m_usePool = false;
 
     //发出modelChanged信号，通知ViewModel游戏状态已重置，UI需要完全刷新
     emit modelChanged();
 }
 
-//放置地雷的实现
-void GameModel::placeMines(int firstClickRow, int firstClickCol) {
-    int minesToPlace = m_mineCount;  //需要放置的地雷数量，初始为地雷总数
-    QRandomGenerator *rand = QRandomGenerator::global();  //获取全局随机数生成器实例
-
-    //循环直到所有地雷都已放置
-    while (minesToPlace > 0) {
-        int row = rand->bounded(m_rows);  //生成一个0到m_rows-1之间的随机行号
-        int col = rand->bounded(m_cols);  //生成一个0到m_cols-1之间的随机列号
-
-        //检查该位置是否可以放置地雷：必须是空地，且不能是玩家首次点击的位置
-        if (!m_grid[row][col].isMine && (row != firstClickRow || col != firstClickCol)) {
-            m_grid[row][col].isMine = true;  //在该位置放置一个地雷
-            minesToPlace--;  //待放置的地雷数减一
+//翻开格子的实现
+void GameModel::revealCell(int row, int col) {
+    //首次翻开时先尝试从池中取一个适用于这个位置的布局，取到后Board就不需要再布雷
+    if (m_usePool && m_board.getGameState() == GameState::Ready && row >= 0 && row < getRows() && col >= 0
+        && col < getCols() && !m_board.getCell(row, col).isFlagged) {
+        m_usePool = false;
+        BoardPool::Layout layout;
+        const BoardPool::Key key{m_board.getRows(), m_board.getCols(), m_board.getMineCount(), m_board.getFirstClickPolicy()};
+        if (m_pool->take(key, row, col, layout)) {
+            m_board.presetLayout(layout.isMine, layout.seed, layout.certified);
+            m_journal.recordLayout(layout.isMine, layout.seed);  //池中的布局不能由种子复现，需要完整地记下来
         }
     }
-    //地雷放置完毕后，计算所有格子周围的地雷数
-    calculateAdjacentMines();
-}
-
-//计算每个格子周围地雷数量的实现
-void GameModel::calculateAdjacentMines() {
-    //遍历每一个格子
-    for (int r = 0; r < m_rows; ++r) {
-        for (int c = 0; c < m_cols; ++c) {
-            if (m_grid[r][c].isMine) continue;  //如果当前格子是地雷，则跳过
-
-            int count = 0;
-            //遍历周围的8个格子
-            for (int dr = -1; dr <= 1; ++dr) {
-                for (int dc = -1; dc <= 1; ++dc) {
-                    if (dr == 0 && dc == 0) continue;  //跳过中心格子（自身）
-                    //如果相邻格子坐标有效且是地雷，则计数器加一
-                    if (isValid(r + dr, c + dc) && m_grid[r + dr][c + dc].isMine) {
-                        count++;
-                    }
-                }
-            }
-            m_grid[r][c].adjacentMines = count;  //更新当前格子的相邻地雷数
-        }
+    //坐标无效、格子已翻开/已标记或游戏已结束时Board不做任何事，也就不需要发出信号
+    const GameState before = m_board.getGameState();
+    if (m_board.revealCell(row, col)) {
+        recordMove(MoveJournal::Move::Reveal, row, col, before);
+        publishChanges();
     }
 }
 
-//翻开格子的实现
-void GameModel::revealCell(int row, int col) {
-    //边界检查和状态验证：如果坐标无效，或格子已翻开/已标记，或游戏已结束，则不执行任何操作
-    if (!isValid(row, col) || m_grid[row][col].isRevealed || m_grid[row][col].isFlagged || m_gameState == GameState::Won || m_gameState == GameState::Lost) {
-        return;
-    }
-
-    //如果这是第一次点击（游戏处于Ready状态）
-    if (m_gameState == GameState::Ready) {
-        placeMines(row, col);  //安全地放置地雷
-        m_gameState = GameState::Playing;  //游戏状态变为“进行中”
+//标记/取消标记旗帜的实现
+void GameModel::flagCell(int row, int col) {
+    const GameState before = m_board.getGameState();
+    if (m_board.flagCell(row, col)) {
+        recordMove(MoveJournal::Move::Flag, row, col, before);
+        publishChanges();
     }
+}
 
-    m_grid[row][col].isRevealed = true;  //将当前格子标记为“已翻开”
-
-    //检查是否踩到地雷
-    if (m_grid[row][col].isMine) {
-        m_gameState = GameState::Lost;  //游戏状态变为“失败”
-        emit gameOver(false);  //发出游戏结束信号，参数false表示失败
-        emit modelChanged();   //触发一次UI更新，以显示所有地雷的位置
-        return;
+//撤销的实现
+bool GameModel::undo() {
+    const bool wasOver = m_board.getGameState() == GameState::Won || m_board.getGameState() == GameState::Lost;
+    if (!m_history.undo(m_board)) {
+        return false;
     }
-
-    m_revealedCount++;  //已翻开的非地雷格子数加一
-
-    //如果翻开的是一个空白格（周围没有地雷）
-    if (m_grid[row][col].adjacentMines == 0) {
-        revealEmptyAdjacentCells(row, col);  //递归地翻开相邻的格子
+    m_journal.recordUndo();
+    if (wasOver) {
+        emit gameResumed();
     }
-
-    checkWinCondition();  //每次成功翻开后都检查是否胜利
-    emit modelChanged();  //发出信号，通知ViewModel更新UI
+    //撤销之后游戏一定处于进行中（或准备）状态，publishChanges只会发出cellsChanged
+    publishChanges();
+    return true;
 }
 
-//标记/取消标记旗帜的实现
-void GameModel::flagCell(int row, int col) {
-    //边界检查：如果坐标无效，或格子已翻开，或游戏已结束，则不执行任何操作
-    if (!isValid(row, col) || m_grid[row][col].isRevealed || m_gameState == GameState::Won || m_gameState == GameState::Lost) {
-        return;
+//重做的实现
+bool GameModel::redo() {
+    if (!m_history.redo(m_board)) {
+        return false;
     }
-
-    //切换标记状态
-    m_grid[row][col].isFlagged = !m_grid[row][col].isFlagged;
-    emit modelChanged();  //发出信号，通知ViewModel更新UI以显示/隐藏旗帜
+    m_journal.recordRedo();
+    publishChanges();
+    return true;
 }
 
-//getCell的实现
-const Cell& GameModel::getCell(int row, int col) const {
-    //直接返回对应格子的只读引用
-    return m_grid[row][col];
+//保存的实现
+bool GameModel::saveGame(const QString &path) {
+    return m_board.saveToFile(QFile::encodeName(path).toStdString());
 }
 
-//getFlagCount的实现
-int GameModel::getFlagCount() const {
-    int count = 0;
-    //遍历整个棋盘，统计被标记为旗帜的格子数量
-    for (int r = 0; r < m_rows; ++r) {
-        for (int c = 0; c < m_cols; ++c) {
-            if (m_grid[r][c].isFlagged) {
-                count++;
-            }
-        }
+//读档的实现
+bool GameModel::loadGame(const QString &path) {
+    if (!m_board.loadFromFile(QFile::encodeName(path).toStdString())) {
+        return false;
     }
-    return count;
+    m_journal.clear();
+    m_history.clear();
+    m_usePool = false;
+    emit modelChanged();  //和开始新的一局一样，整个棋盘都需要重新获取
+    return true;
 }
 
-//递归翻开空白区域的实现
-void GameModel::revealEmptyAdjacentCells(int row, int col) {
-    //遍历周围8个格子
-    for (int dr = -1; dr <= 1; ++dr) {
-        for (int dc = -1; dc <= 1; ++dc) {
-            if (dr == 0 && dc == 0) continue;
-            int newRow = row + dr;
-            int newCol = col + dc;
-            //如果相邻格子有效，且未被翻开也未被标记
-            if (isValid(newRow, newCol) && !m_grid[newRow][newCol].isRevealed && !m_grid[newRow][newCol].isFlagged) {
-                 if (!m_grid[newRow][newCol].isMine) {  //再次确认不是雷（虽然空白格周围肯定不是雷）
-                    m_grid[newRow][newCol].isRevealed = true;  //翻开它
-                    m_revealedCount++;
-                    //如果新翻开的格子也是空白格，则以它为中心继续递归
-                    if (m_grid[newRow][newCol].adjacentMines == 0) {
-                        revealEmptyAdjacentCells(newRow, newCol);
-                    }
-                }
-            }
-        }
+//双击的实现
+void GameModel::chordCell(int row, int col) {
+    const GameState before = m_board.getGameState();
+    if (m_board.chordCell(row, col)) {
+        recordMove(MoveJournal::Move::Chord, row, col, before);
+        publishChanges();
     }
 }
 
-//检查胜利条件的实现
-void GameModel::checkWinCondition() {
-    //胜利条件：已翻开的格子数等于总格子数减去地雷数
-    if (m_revealedCount == (m_rows * m_cols - m_mineCount)) {
-        m_gameState = GameState::Won;  //游戏状态变为“胜利”
+//recordMove的实现
+void GameModel::recordMove(MoveJournal::Move move, int row, int col, GameState before) {
+    //翻开和双击翻转的是已翻开位，插旗翻转的是旗帜位
+    m_history.record(m_board, move == MoveJournal::Move::Flag ? CellBits::Flagged : CellBits::Revealed, before);
+    m_journal.record(move, row, col);
+}
+
+//publishChanges的实现
+void GameModel::publishChanges() {
+    //游戏结束后Board不再接受任何改变棋盘的操作，所以只要操作后处于结束状态，就一定是本次操作结束了游戏
+    if (m_board.getGameState() == GameState::Lost) {
+        emit gameOver(false);  //发出游戏结束信号，参数false表示失败
+    } else if (m_board.getGameState() == GameState::Won) {
         emit gameOver(true);  //发出游戏结束信号，参数true表示胜利
     }
-}
 
-//检查坐标是否有效的实现
-bool GameModel::isValid(int row, int col) const {
-    return row >= 0 && row < m_rows && col >= 0 && col < m_cols;
+    //把Board记录的改变复制到复用的QVector中，容量足够时assign不会重新分配内存
+    const std::vector<int> &changed = m_board.getChangedCells();
+    m_changedCells.assign(changed.begin(), changed.end());
+    emit cellsChanged(m_changedCells);  //发出信号，通知ViewModel只更新本次被改变的格子
 }
\ No newline at end of file
@@ -3,29 +3,19 @@
 
 /*
 Model是整个应用的核心，封装了所有的数据和业务逻辑，并且与界面（View）完全无关
-在扫雷游戏中，GameModel负责管理棋盘状态、地雷位置、胜负判断等所有核心规则
+在扫雷游戏中，棋盘状态、地雷位置、胜负判断等所有核心规则都由不依赖Qt的Board实现（见Core/Board.h），
+GameModel只是Board外面的一层QObject适配器：把命令转发给Board，再把每次操作的结果转换成Qt信号通知ViewModel
 */
 
 #include <QObject>  //包含Qt的核心基类，GameModel继承自QObject以使用信号/槽机制
-#include <QVector>  //包含Qt的动态数组容器，用于高效地存储二维网格数据
-
-//定义了单个格子的所有状态信息，用于存储格子数据
-struct Cell {
-    bool isMine = false;  //标记这个格子是否是地雷
-    bool isRevealed = false;  //标记这个格子是否已被玩家翻开
-    bool isFlagged = false;  //标记这个格子是否已被玩家插上旗帜
-    int adjacentMines = 0;  //存储该格子周围8个相邻格子中的地雷总数
-};
+#include <QVector>  //包含Qt的动态数组容器，用于通过信号传递被改变的格子
+#include "../Core/Board.h"  //包含与Qt无关的核心规则引擎，以及Cell、GameState等核心数据类型
+#include "../Core/MoveJournal.h"  //包含记录每一步操作的日志
+#include "../Core/UndoHistory.h"  //包含撤销和重做使用的增量记录
 
-//定义了游戏可能处于的几种状态
-enum class GameState {
-    Ready,  //准备状态：游戏已初始化，但玩家还未进行第一次点击
-    Playing,  //进行中状态：玩家已开始点击，游戏正在进行中
-    Won,  //胜利状态：玩家成功翻开所有非地雷格子，游戏胜利
-    Lost  //失败状态玩家点到了地雷，游戏失败
-};
+class BoardPool;
 
-//GameModel类是游戏的核心逻辑和数据中心
+//GameModel类是核心规则引擎Board在Qt一侧的适配器
 //它继承自QObject，以能够发出信号，通知外界（ViewModel）其内部状态发生了变化
 class GameModel : public QObject {
     Q_OBJECT  //一个特殊的Qt宏，必须包含在使用信号/槽的类中，使得MOC（元对象编译器）能够处理这个类
@@ -38,8 +28,25 @@ public:
     //--- 公共接口 (Public API) ---
     //这些是ViewModel可以调用的方法，用于驱动游戏逻辑
 
+    //布雷使用的随机数生成器类型，替换成任何满足UniformRandomBitGenerator要求的64位生成器即可更换算法
+    using RandomEngine = Board::RandomEngine;
+
     //开始一局新游戏，并根据指定的参数初始化棋盘
-    void startGame(int rows, int cols, int mines);
+    //地雷数会被限制在[0, rows*cols-1]范围内；policy决定首次点击时需要留空的区域（生成器应付不了的棋盘上NoGuess会退回SafeArea，见Board::startGame）
+    //不指定种子时会随机生成一个，可通过getSeed()取回，用于复现这一局
+    void startGame(int rows, int cols, int mines, FirstClickPolicy policy = FirstClickPolicy::SafeCell);
+
+    //使用指定的64位种子开始一局新游戏：同样的参数、种子和首次点击位置，总是生成逐位相同的棋盘
+    void startGame(int rows, int cols, int mines, quint64 seed, FirstClickPolicy policy = FirstClickPolicy::SafeCell);
+
+    //设置预先生成布局的后台服务（不转移所有权，传入nullptr表示不使用）
+    //设置之后，不指定种子开始的游戏在首次翻开时优先从池中取用现成的布局，取不到时照常同步布雷；指定种子的游戏为了可复现，总是自己布雷
+    void setBoardPool(BoardPool *pool) { m_pool = pool; }
+
+    //NoGuess布局的生成器使用的线程数和取消标志，直接交给Board（见Board::setGeneratorThreads、Board::setGeneratorCancelFlag）
+    //布雷被取消时那次翻开什么也不做，也不发出信号
+    void setGeneratorThreads(int threads) { m_board.setGeneratorThreads(threads); }
+    void setGeneratorCancelFlag(const std::atomic<bool> *cancel) { m_board.setGeneratorCancelFlag(cancel); }
 
     //处理玩家翻开一个格子的逻辑
     void revealCell(int row, int col);
@@ -47,53 +54,85 @@ public:
     //处理玩家标记/取消标记一个格子的逻辑
     void flagCell(int row, int col);
 
+    //撤销最近的一次翻开、插旗或双击，撤销了时像一次普通操作一样发出cellsChanged，并返回true
+    //撤销的是结束了游戏的那一步时，先发出gameResumed；首次翻开布下的地雷不会被撤掉（见UndoHistory）
+    bool undo();
+
+    //重做最近被撤销的一次操作，重做了时发出的信号与原来那次操作相同（包括gameOver），并返回true
+    //撤销之后又进行了新的操作时，被撤销的操作不能再重做
+    bool redo();
+
+    bool canUndo() const { return m_history.canUndo(); }  //是否有可以撤销的操作
+    bool canRedo() const { return m_history.canRedo(); }  //是否有可以重做的操作
+
+    //把当前这一局保存到文件，返回是否成功（文件格式见Board::saveToFile）
+    //只有调用它时才会写文件：读档之后继续玩不会改变存档，直到再次保存
+    bool saveGame(const QString &path);
+
+    //读取存档继续其中的那一局，成功时发出modelChanged并返回true；失败时这一局保持不变
+    //文件以写时复制的方式被映射进来作为棋盘的存储，耗时与棋盘大小无关；存档中没有之前的操作，所以本局的操作日志为空，也不能撤销读档之前的操作
+    bool loadGame(const QString &path);
+
+    //处理玩家在已翻开的数字格上“双击”（中键，或左右键同时按下）的逻辑
+    //当该格子周围的旗帜数恰好等于它的数字时，一次性翻开周围所有未插旗的格子（包括由此引发的连锁翻开），
+    //整个操作只发出一次cellsChanged信号；旗帜数不符时不做任何事
+    void chordCell(int row, int col);
+
     //--- Getters (访问器) ---
     //提供对内部状态的只读访问(`const` 关键字表示这些函数不会修改类的任何成员变量)
-    int getRows() const { return m_rows; }  //返回棋盘的行数
-    int getCols() const { return m_cols; }  //返回棋盘的列数
-    int getMineCount() const { return m_mineCount; }  //返回总地雷数
-    int getFlagCount() const;  //返回当前已标记旗帜的数量
-    const Cell& getCell(int row, int col) const;  //返回指定位置格子的只读引用(避免数据拷贝)
-    GameState getGameState() const { return m_gameState; }  //返回当前的游戏状态
+    int getRows() const { return m_board.getRows(); }  //返回棋盘的行数
+    int getCols() const { return m_board.getCols(); }  //返回棋盘的列数
+    int getMineCount() const { return m_board.getMineCount(); }  //返回总地雷数
+    int getFlagCount() const { return m_board.getFlagCount(); }  //返回当前已标记旗帜的数量
+    int getRevealedCount() const { return m_board.getRevealedCount(); }  //返回已翻开的非地雷格子数量
+    int getRemainingSafeCount() const { return m_board.getRemainingSafeCount(); }  //返回尚未翻开的非地雷格子数量
+    double getPercentCleared() const { return m_board.getPercentCleared(); }  //返回已翻开的非地雷格子占全部非地雷格子的百分比（0~100）
+    Cell getCell(int row, int col) const { return m_board.getCell(row, col); }  //返回指定位置格子解码后的副本（Cell只有几个字节，按值返回的开销可以忽略）
+    GameState getGameState() const { return m_board.getGameState(); }  //返回当前的游戏状态
+    FirstClickPolicy getFirstClickPolicy() const { return m_board.getFirstClickPolicy(); }  //返回本局的首次点击保护策略
+    bool isLayoutCertified() const { return m_board.isLayoutCertified(); }  //返回NoGuess布局是否经过求解器验证
+    quint64 getSeed() const { return m_board.getSeed(); }  //返回本局布雷使用的种子
+
+    //返回内部的核心规则引擎，供只需要读取棋盘数据的代码直接使用
+    const Board &board() const { return m_board; }
+
+    //返回本局的操作日志：每局开始时重新开始记录，之后每一次改变了棋盘的操作都会追加进去
+    //把getBytes()保存下来，就可以用JournalReplayer逐位精确地重放这一局的任意时刻
+    const MoveJournal &journal() const { return m_journal; }
 
 signals:
     //--- 信号 ---
     //当模型的状态发生改变时，会发出这些信号,ViewModel可以连接到这些信号来接收通知
 
-    //当棋盘上的任何数据（如格子状态、标记等）发生变化时发出
-    //这是一个通用的“刷新”信号，通知监听者需要从Model重新获取数据来更新自己
+    //当整个棋盘需要重新获取时发出（目前只在startGame重置棋盘后发出）
+    //这是一个通用的“刷新”信号，通知监听者需要从Model重新获取全部数据来更新自己
     void modelChanged();
 
+    //当一次翻开或插旗操作改变了部分格子时发出，每次操作只发出一次
+    //cells是本次操作改变的所有格子，每个元素是行优先的一维编号 row * getCols() + col
+    //监听者只需要重新获取这些格子，代价与改变的格子数成正比，而与棋盘大小无关
+    void cellsChanged(const QVector<int> &cells);
+
     //当游戏结束时发出
     //`bool victory` 参数明确告诉监听者游戏是以胜利（true）还是失败（false）结束
     void gameOver(bool victory);
 
-private:
-    //--- 私有辅助函数 ---
-    //这些函数封装了内部逻辑，不直接暴露给外部
-
-    //在玩家首次点击后，根据点击位置安全地随机布置地雷
-    void placeMines(int firstClickRow, int firstClickCol);
+    //当撤销了结束游戏的那一步、游戏回到进行中时发出（在这次撤销的cellsChanged之前）
+    void gameResumed();
 
-    //计算并更新棋盘上每个非地雷格子周围的地雷数量
-    void calculateAdjacentMines();
-
-    //当玩家点开一个空白格（周围没有地雷）时，递归地自动翻开所有相邻的空白格
-    void revealEmptyAdjacentCells(int row, int col);
-
-    //检查是否满足胜利条件（所有非地雷格子都已被翻开）
-    void checkWinCondition();
-
-    //检查给定的坐标是否在棋盘的有效范围内
-    bool isValid(int row, int col) const;
-
-    //--- 核心数据成员 ---
-    int m_rows = 0;  //棋盘的行数
-    int m_cols = 0;  //棋盘的列数
-    int m_mineCount = 0;  //游戏设定的地雷总数
-    QVector<QVector<Cell>> m_grid;  //存储整个棋盘状态的二维动态数组
-    GameState m_gameState = GameState::Ready;  //当前游戏所处的状态
-    int m_revealedCount = 0;  //已经翻开的非地雷格子计数，用于快速判断胜利条件
+private:
+    //一次改变了棋盘的操作结束后，把Board记录的改变转换成信号：游戏因此结束时先发出gameOver，然后发出一次cellsChanged
+    void publishChanges();
+
+    //一次操作成功后，把它记进撤销记录和操作日志；before是操作之前的游戏状态
+    void recordMove(MoveJournal::Move move, int row, int col, GameState before);
+
+    Board m_board;  //核心规则引擎，保存整局游戏的全部数据
+    MoveJournal m_journal;  //本局的操作日志
+    UndoHistory m_history;  //本局的撤销记录
+    QVector<int> m_changedCells;  //通过cellsChanged信号发出的格子列表，作为成员复用以避免每次操作都重新分配内存
+    BoardPool *m_pool = nullptr;  //预先生成布局的后台服务，可以为空
+    bool m_usePool = false;  //本局是否从池中取用布局
 };
 
 #endif //MINESWEEPER_GAMEMODEL_H
\ No newline at end of file
@@ -0,0 +1,74 @@
+#include "GameSession.h"
+#include "../Core/Solver.h"  //回答提示请求
+
+//GameSession构造函数的实现
+GameSession::GameSession(int id, WorkStealingPool &pool, ISessionObserver *observer)
+    : m_id(id), m_observer(observer), m_strand(pool) {
+    if (!m_observer) return;
+    //不指定接收者的连接总是直接连接：信号在执行命令的工作线程中发出，观察者也就在这个线程中被调用
+    QObject::connect(&m_model, &GameModel::modelChanged, [this]() { m_observer->onNewGame(*this, m_model.board()); });
+    QObject::connect(&m_model, &GameModel::cellsChanged, [this](const QVector<int> &) {
+        //信号中的格子与Board记录的本次改变相同，直接使用后者，不需要再转换一次
+        m_observer->onCellsChanged(*this, m_model.board(), m_model.board().getChangedCells());
+    });
+}
+
+//GameSession析构函数的实现
+GameSession::~GameSession() = default;
+
+//execute的实现
+template <typename Command>
+void GameSession::execute(Command command) {
+    m_strand.post([this, command = std::move(command)]() {
+        command(m_model);
+        m_commandCount.fetch_add(1, std::memory_order_relaxed);
+    });
+}
+
+//--- IGameCommands 接口的实现 ---
+
+void GameSession::startNewGame(int rows, int cols, int mines, FirstClickPolicy policy) {
+    execute([rows, cols, mines, policy](GameModel &model) { model.startGame(rows, cols, mines, policy); });
+}
+
+void GameSession::startNewGame(int rows, int cols, int mines, quint64 seed) {
+    execute([rows, cols, mines, seed](GameModel &model) { model.startGame(rows, cols, mines, seed); });
+}
+
+void GameSession::revealCellRequest(int row, int col) {
+    execute([row, col](GameModel &model) { model.revealCell(row, col); });
+}
+
+void GameSession::toggleFlagRequest(int row, int col) {
+    execute([row, col](GameModel &model) { model.flagCell(row, col); });
+}
+
+void GameSession::chordCellRequest(int row, int col) {
+    execute([row, col](GameModel &model) { model.chordCell(row, col); });
+}
+
+void GameSession::undoRequest() {
+    execute([](GameModel &model) { model.undo(); });
+}
+
+void GameSession::redoRequest() {
+    execute([](GameModel &model) { model.redo(); });
+}
+
+void GameSession::hintRequest() {
+    execute([this](GameModel &model) {
+        if (!m_observer) return;
+        //会话中提示很少用到，不随每次操作维护求解器，需要时对当前棋盘重新推理一遍
+        Solver solver;
+        solver.reset(model.board());
+        const Solver::Hint hint = solver.hint(model.board());
+        m_observer->onHint(*this, hint.row, hint.col, hint.certain);
+    });
+}
+
+void GameSession::setViewport(const QRect &) {}
+
+//post的实现
+void GameSession::post(std::function<void(GameModel &)> command) {
+    execute(std::move(command));
+}
@@ -0,0 +1,85 @@
+#ifndef MINESWEEPER_GAMESESSION_H
+#define MINESWEEPER_GAMESESSION_H
+
+/*
+GameSession是会话服务器中的一局游戏：一个GameModel加上一个Strand（串行执行器），没有窗口、没有ViewModel，也不占用线程
+它实现了IGameCommands，所以可以像GUI中的ViewModel一样接收命令；每条命令被提交到自己的Strand，在线程池的某个工作线程中按顺序执行
+命令的结果不经过Qt的事件循环，而是在执行命令的工作线程中直接通知ISessionObserver（例如把结果写给网络客户端）
+
+GameModel是QObject，但会话中它的信号只直接连接到本对象，从不使用排队连接和定时器，所以可以在任何线程中使用，
+同一时刻只有一个工作线程在执行它的命令（由Strand保证）
+*/
+
+#include <atomic>  //包含std::atomic，用于统计已执行的命令数
+#include <functional>  //包含std::function
+#include <vector>  //包含std::vector
+#include "../Model/GameModel.h"  //包含会话运行的游戏模型
+#include "../Core/Strand.h"  //包含串行执行器
+#include "../common/IGameCommands.h"  //会话实现IGameCommands接口，接收来自客户端的命令
+
+class GameSession;
+
+//ISessionObserver是会话向外报告结果的接口（相当于没有界面时的IGameUI）
+//所有方法都在执行命令的工作线程中调用，同一个会话的调用不会同时发生；board只在调用期间有效，实现不应长时间阻塞
+class ISessionObserver {
+public:
+    virtual ~ISessionObserver() = default;
+
+    //开始了新的一局（棋盘尺寸可能改变），整个棋盘都需要重新获取
+    virtual void onNewGame(GameSession &session, const Board &board) = 0;
+
+    //一次操作（包括撤销和重做）改变了cells中的格子（行优先编号）；游戏因此结束或继续时可以从board的状态得知
+    virtual void onCellsChanged(GameSession &session, const Board &board, const std::vector<int> &cells) = 0;
+
+    //对提示请求的回答，没有可建议的格子时row和col为-1；certain表示是否是确定安全的格子
+    virtual void onHint(GameSession &session, int row, int col, bool certain) = 0;
+};
+
+class GameSession : public IGameCommands {
+public:
+    //id由SessionHost分配；命令在pool中执行，pool必须比会话活得更久；observer可以为空（例如基准测试）
+    GameSession(int id, WorkStealingPool &pool, ISessionObserver *observer = nullptr);
+
+    //丢弃还没有执行的命令，并等待正在执行的命令结束；不能在这个会话自己的命令中析构
+    ~GameSession() override;
+
+    GameSession(const GameSession &) = delete;
+    GameSession &operator=(const GameSession &) = delete;
+
+    //会话编号
+    int getId() const { return m_id; }
+
+    //已经执行完的命令数（包括没有改变棋盘的命令），可以在任何线程中读取
+    quint64 getCommandCount() const { return m_commandCount.load(std::memory_order_relaxed); }
+
+    //--- IGameCommands 接口的实现 ---
+    //所有命令都只是提交到Strand，立即返回
+    void startNewGame(int rows, int cols, int mines, FirstClickPolicy policy = FirstClickPolicy::SafeCell) override;
+    void revealCellRequest(int row, int col) override;
+    void toggleFlagRequest(int row, int col) override;
+    void chordCellRequest(int row, int col) override;
+    void undoRequest() override;
+    void redoRequest() override;
+    void hintRequest() override;
+    void setViewport(const QRect &cells) override;  //会话没有显示区域，每次都报告全部改变的格子，这个命令被忽略
+
+    //使用指定的种子开始新的一局（用于复现一局，以及基准测试）
+    void startNewGame(int rows, int cols, int mines, quint64 seed);
+
+    //提交一条直接操作GameModel的命令，它和其他命令一样按顺序在工作线程中执行（用于测试和统计）
+    void post(std::function<void(GameModel &)> command);
+
+private:
+    //把命令提交到Strand，执行后计入命令数
+    //command是以GameModel&为参数的可调用对象；按原类型捕获，常见的命令（this加上行列号）可以直接放进std::function内部，不分配内存
+    template <typename Command>
+    void execute(Command command);
+
+    int m_id;
+    ISessionObserver *m_observer;
+    GameModel m_model;  //只在Strand的任务中访问
+    std::atomic<quint64> m_commandCount{0};
+    Strand m_strand;  //最后声明、最先析构：析构时等待正在执行的命令结束，那时Model仍然有效
+};
+
+#endif //MINESWEEPER_GAMESESSION_H
@@ -0,0 +1,53 @@
+#include "SessionHost.h"
+#include <QMutexLocker>  //包含互斥锁的RAII封装
+
+//SessionHost构造函数的实现
+SessionHost::SessionHost(int threads) : m_pool(threads) {}
+
+//SessionHost析构函数的实现
+SessionHost::~SessionHost() {
+    //先把所有会话移出表再逐个销毁，销毁时会等待正在执行的命令，不需要持有锁
+    std::unordered_map<int, std::unique_ptr<GameSession>> sessions;
+    {
+        QMutexLocker locker(&m_mutex);
+        sessions.swap(m_sessions);
+    }
+    sessions.clear();
+}
+
+//打开会话的实现
+GameSession &SessionHost::openSession(ISessionObserver *observer) {
+    QMutexLocker locker(&m_mutex);
+    const int id = m_nextId++;
+    auto session = std::make_unique<GameSession>(id, m_pool, observer);
+    GameSession &result = *session;
+    m_sessions.emplace(id, std::move(session));
+    return result;
+}
+
+//关闭会话的实现
+void SessionHost::closeSession(int id) {
+    std::unique_ptr<GameSession> session;
+    {
+        QMutexLocker locker(&m_mutex);
+        const auto it = m_sessions.find(id);
+        if (it == m_sessions.end()) return;
+        session = std::move(it->second);
+        m_sessions.erase(it);
+    }
+    //在锁外销毁：等待这个会话正在执行的命令时，其他线程仍然可以打开和查找会话
+    session.reset();
+}
+
+//查找会话的实现
+GameSession *SessionHost::findSession(int id) const {
+    QMutexLocker locker(&m_mutex);
+    const auto it = m_sessions.find(id);
+    return it == m_sessions.end() ? nullptr : it->second.get();
+}
+
+//getSessionCount的实现
+int SessionHost::getSessionCount() const {
+    QMutexLocker locker(&m_mutex);
+    return int(m_sessions.size());
+}
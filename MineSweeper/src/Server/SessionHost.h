@@ -0,0 +1,55 @@
+#ifndef MINESWEEPER_SESSIONHOST_H
+#define MINESWEEPER_SESSIONHOST_H
+
+/*
+SessionHost管理同时进行的许多局游戏（会话），所有会话共用一个WorkStealingPool，线程数与会话数无关
+每个会话有自己的Strand，同一局的命令按顺序执行，不同局的命令在各个工作线程上并行执行；空闲的会话只占内存，不占线程
+打开和关闭会话可以在任何线程中进行，会话本身通过IGameCommands接收命令，见GameSession.h
+*/
+
+#include <QMutex>  //包含互斥锁，保护会话表
+#include <memory>  //包含std::unique_ptr
+#include <unordered_map>  //包含std::unordered_map，按编号保存会话
+#include "GameSession.h"
+
+class SessionHost {
+public:
+    //threads是线程池的工作线程数，不大于0时使用硬件线程数
+    explicit SessionHost(int threads = 0);
+
+    //关闭所有会话（丢弃还没有执行的命令），然后停止线程池
+    ~SessionHost();
+
+    SessionHost(const SessionHost &) = delete;
+    SessionHost &operator=(const SessionHost &) = delete;
+
+    //打开一个新的会话，observer接收它的结果（可以为空）；返回的引用在closeSession之前一直有效
+    GameSession &openSession(ISessionObserver *observer = nullptr);
+
+    //关闭会话：丢弃它还没有执行的命令，等待正在执行的命令结束后销毁它；编号不存在时什么也不做
+    //不能在会话自己的命令或观察者回调中调用
+    void closeSession(int id);
+
+    //按编号查找会话，不存在时返回nullptr
+    GameSession *findSession(int id) const;
+
+    //当前打开的会话数
+    int getSessionCount() const;
+
+    //所有会话全部已提交的命令执行完之前阻塞等待
+    void waitForIdle() { m_pool.waitForIdle(); }
+
+    //线程池的工作线程数
+    int getThreadCount() const { return m_pool.getThreadCount(); }
+
+    //线程池的统计数据（执行和窃取的任务数）
+    WorkStealingPool::Stats poolStats() const { return m_pool.stats(); }
+
+private:
+    WorkStealingPool m_pool;  //最先声明、最后析构：会话析构时还要等待线程池中正在执行的命令
+    mutable QMutex m_mutex;  //保护m_sessions和m_nextId
+    std::unordered_map<int, std::unique_ptr<GameSession>> m_sessions;
+    int m_nextId = 1;
+};
+
+#endif //MINESWEEPER_SESSIONHOST_H
@@ -0,0 +1,185 @@
+#include "SessionServer.h"
+#include <QByteArray>
+#include <QList>
+#include <QLocalSocket>  //包含本地套接字，每个连接一个
+
+namespace {
+//没有换行的一行最多允许的字节数，超过时认为客户端有问题并断开连接
+constexpr qint64 kMaxLineLength = 4096;
+
+//游戏状态在协议中的名字
+const char *stateName(GameState state) {
+    switch (state) {
+        case GameState::Ready: return "ready";
+        case GameState::Playing: return "playing";
+        case GameState::Won: return "won";
+        case GameState::Lost: return "lost";
+    }
+    return "ready";
+}
+
+//格子在协议中的字符：未翻开#，旗帜F，地雷*（失败后所有没插旗的雷都显示出来），翻开的格子是周围的雷数
+char glyphOf(const Board &board, int row, int col) {
+    const Cell cell = board.getCell(row, col);
+    if (cell.isRevealed) return cell.isMine ? '*' : char('0' + cell.adjacentMines);
+    if (cell.isFlagged) return 'F';
+    if (cell.isMine && board.getGameState() == GameState::Lost) return '*';
+    return '#';
+}
+
+//把fields[first]开始的count个字段解析成整数，有一个不是整数时返回false；调用者负责检查字段数
+bool parseInts(const QList<QByteArray> &fields, qsizetype first, int *values, qsizetype count) {
+    for (qsizetype i = 0; i < count; ++i) {
+        bool ok = false;
+        values[i] = fields[first + i].toInt(&ok);
+        if (!ok) return false;
+    }
+    return true;
+}
+}
+
+//Connection是一个客户端连接：拥有套接字和一个会话，并作为会话的观察者把结果写回套接字
+//它只使用函数对象形式的连接，不需要Q_OBJECT
+class SessionServer::Connection : public QObject, public ISessionObserver {
+public:
+    Connection(SessionServer &server, QLocalSocket *socket)
+        : QObject(&server), m_server(server), m_socket(socket), m_session(server.m_host.openSession(this)) {
+        m_socket->setParent(this);
+        connect(m_socket, &QLocalSocket::readyRead, this, [this]() { onReadyRead(); });
+        connect(m_socket, &QLocalSocket::disconnected, this, [this]() { m_server.removeConnection(this); });
+    }
+
+    //先关闭会话：它会等待正在执行的命令，此后不会再有观察者回调访问这个对象
+    ~Connection() override { m_server.m_host.closeSession(m_session.getId()); }
+
+    //--- ISessionObserver 接口的实现 ---
+    //在工作线程中把结果格式化好，再排队到主线程写入套接字
+
+    void onNewGame(GameSession &, const Board &board) override {
+        QByteArray reply = "game ";
+        reply += QByteArray::number(board.getRows()) + ' ' + QByteArray::number(board.getCols()) + ' '
+                 + QByteArray::number(board.getMineCount()) + '\n';
+        send(std::move(reply));
+    }
+
+    void onCellsChanged(GameSession &, const Board &board, const std::vector<int> &cells) override {
+        QByteArray reply = "cells ";
+        reply.reserve(qsizetype(32 + cells.size() * 10));
+        reply += stateName(board.getGameState());
+        reply += ' ' + QByteArray::number(board.getMineCount() - board.getFlagCount());
+        reply += ' ' + QByteArray::number(qsizetype(cells.size()));
+        const int cols = board.getCols();
+        for (const int index : cells) {
+            const int row = index / cols;
+            const int col = index % cols;
+            reply += ' ' + QByteArray::number(row) + ' ' + QByteArray::number(col) + ' ';
+            reply += glyphOf(board, row, col);
+        }
+        reply += '\n';
+        send(std::move(reply));
+    }
+
+    void onHint(GameSession &, int row, int col, bool certain) override {
+        const char *kind = certain ? "safe" : (row >= 0 ? "guess" : "none");
+        QByteArray reply = "hint ";
+        reply += QByteArray::number(row) + ' ' + QByteArray::number(col) + ' ' + kind + '\n';
+        send(std::move(reply));
+    }
+
+private:
+    //把一行回复排队到连接所在的主线程写出；连接先被销毁时排队的写入会被Qt丢弃
+    void send(QByteArray reply) {
+        QMetaObject::invokeMethod(this, [this, reply = std::move(reply)]() { m_socket->write(reply); },
+                                  Qt::QueuedConnection);
+    }
+
+    //读取所有完整的行并逐条执行
+    void onReadyRead() {
+        while (m_socket->canReadLine()) {
+            handleLine(m_socket->readLine().simplified());
+        }
+        if (m_socket->bytesAvailable() > kMaxLineLength) {
+            m_socket->write("error line too long\n");
+            m_socket->disconnectFromServer();
+        }
+    }
+
+    //执行一条命令，命令本身在会话的Strand中异步执行，这里只负责解析
+    void handleLine(const QByteArray &line) {
+        if (line.isEmpty()) return;
+        const QList<QByteArray> fields = line.split(' ');
+        const QByteArray &name = fields[0];
+        int values[3] = {};
+
+        if (name == "new" && (fields.size() == 4 || fields.size() == 5) && parseInts(fields, 1, values, 3)) {
+            if (values[0] < 1 || values[0] > kMaxSide || values[1] < 1 || values[1] > kMaxSide || values[2] < 0) {
+                writeLine("error board size out of range");
+                return;
+            }
+            if (fields.size() == 4) {
+                m_session.startNewGame(values[0], values[1], values[2]);
+                return;
+            }
+            bool ok = false;
+            const quint64 seed = fields[4].toULongLong(&ok);
+            if (ok) {
+                m_session.startNewGame(values[0], values[1], values[2], seed);
+                return;
+            }
+        } else if ((name == "r" || name == "f" || name == "c") && fields.size() == 3 && parseInts(fields, 1, values, 2)) {
+            if (name == "r") m_session.revealCellRequest(values[0], values[1]);
+            else if (name == "f") m_session.toggleFlagRequest(values[0], values[1]);
+            else m_session.chordCellRequest(values[0], values[1]);
+            return;
+        } else if (fields.size() == 1 && name == "u") {
+            m_session.undoRequest();
+            return;
+        } else if (fields.size() == 1 && name == "y") {
+            m_session.redoRequest();
+            return;
+        } else if (fields.size() == 1 && name == "h") {
+            m_session.hintRequest();
+            return;
+        }
+        writeLine("error bad command: " + line);
+    }
+
+    //在主线程中直接回复一行
+    void writeLine(const QByteArray &text) { m_socket->write(text + '\n'); }
+
+    SessionServer &m_server;
+    QLocalSocket *m_socket;
+    GameSession &m_session;
+};
+
+//SessionServer构造函数的实现
+SessionServer::SessionServer(SessionHost &host, QObject *parent) : QObject(parent), m_host(host) {
+    connect(&m_server, &QLocalServer::newConnection, this, &SessionServer::onNewConnection);
+}
+
+//SessionServer析构函数的实现
+SessionServer::~SessionServer() {
+    //连接的析构函数要通过m_host关闭会话，趁服务器的成员都还有效时先销毁它们
+    const QList<Connection *> connections = m_connections;
+    m_connections.clear();
+    for (Connection *connection : connections) delete connection;
+}
+
+//开始监听的实现
+bool SessionServer::listen(const QString &name) {
+    QLocalServer::removeServer(name);
+    return m_server.listen(name);
+}
+
+//接受新连接的实现
+void SessionServer::onNewConnection() {
+    while (QLocalSocket *socket = m_server.nextPendingConnection()) {
+        m_connections.append(new Connection(*this, socket));
+    }
+}
+
+//移除连接的实现
+void SessionServer::removeConnection(Connection *connection) {
+    //断开信号可能在连接自己的槽函数中发出，所以延迟到事件循环中再销毁
+    if (m_connections.removeOne(connection)) connection->deleteLater();
+}
@@ -0,0 +1,69 @@
+#ifndef MINESWEEPER_SESSIONSERVER_H
+#define MINESWEEPER_SESSIONSERVER_H
+
+/*
+SessionServer把SessionHost中的会话通过本地套接字（QLocalServer，Windows上是命名管道，其他平台是Unix域套接字）提供给客户端
+每个连接对应一个会话，连接断开时会话随之关闭；服务器本身只在主线程中读写套接字，命令在线程池中执行
+
+协议是按行的纯文本，每行一条，字段用空格分隔：
+客户端发送：
+  new R C M [SEED]   开始新的一局（R行C列M个雷，可选的种子用于复现）
+  r ROW COL          翻开格子
+  f ROW COL          插旗或取消插旗
+  c ROW COL          双击（翻开已满足旗数的数字格周围的格子）
+  u                  撤销
+  y                  重做
+  h                  请求提示
+服务器回复：
+  game R C M                          开始了新的一局，所有格子都是未翻开的
+  cells STATE LEFT N r c g ...        一次操作改变了N个格子；STATE是ready/playing/won/lost，LEFT是剩余雷数（雷数减旗数），
+                                      每个格子是行、列和一个字符：#未翻开，F旗帜，*地雷，0~8周围的雷数
+  hint ROW COL safe|guess|none        提示（none时行列为-1）
+  error 原因                          命令无法解析
+*/
+
+#include <QList>
+#include <QLocalServer>  //包含本地套接字服务器
+#include <QObject>
+#include <QString>
+#include "SessionHost.h"
+
+class SessionServer : public QObject {
+    Q_OBJECT
+
+public:
+    //新的一局允许的最大行数和列数，避免一个客户端占用过多内存
+    static constexpr int kMaxSide = 1024;
+
+    //会话在host中运行，host必须比服务器活得更久
+    explicit SessionServer(SessionHost &host, QObject *parent = nullptr);
+    ~SessionServer() override;
+
+    //在name上开始监听，同名的残留套接字（例如上次异常退出留下的）会先被删除；返回是否成功
+    bool listen(const QString &name);
+
+    //实际监听的完整地址（Unix上是套接字文件的路径）
+    QString fullServerName() const { return m_server.fullServerName(); }
+
+    //最近一次失败的原因
+    QString errorString() const { return m_server.errorString(); }
+
+    //当前的连接数
+    int getConnectionCount() const { return int(m_connections.size()); }
+
+private slots:
+    //接受所有等待中的连接，为每个连接打开一个会话
+    void onNewConnection();
+
+private:
+    class Connection;
+
+    //连接断开后把它从列表中移除，并在回到事件循环后销毁
+    void removeConnection(Connection *connection);
+
+    SessionHost &m_host;
+    QLocalServer m_server;
+    QList<Connection *> m_connections;  //所有连接，由服务器负责销毁
+};
+
+#endif //MINESWEEPER_SESSIONSERVER_H
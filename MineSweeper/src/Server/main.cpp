@@ -0,0 +1,47 @@
+/*
+minesweeper-host是会话服务器：没有窗口，在一个进程里同时运行许多局游戏，客户端通过本地套接字连接，每个连接一局
+它是GUI程序之外的另一个组合根：GameModel和IGameCommands与GUI中的完全相同，只是命令来自套接字，由线程池执行
+
+用法：
+  minesweeper-host [--name NAME] [--threads N]
+
+--name是本地套接字的名字（默认minesweeper），--threads是工作线程数（默认使用硬件线程数）
+协议见SessionServer.h，例如在Linux上可以用 socat - UNIX-CONNECT:/tmp/minesweeper 手动试玩
+*/
+
+#include <QCoreApplication>  //包含没有GUI的应用程序类，提供事件循环
+#include <cstdio>  //包含printf等格式化输出函数
+#include <cstdlib>  //包含atoi
+#include <cstring>  //包含strcmp
+#include "SessionHost.h"
+#include "SessionServer.h"
+
+//程序的入口函数
+int main(int argc, char *argv[]) {
+    QCoreApplication application(argc, argv);
+
+    QString name = QStringLiteral("minesweeper");
+    int threads = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--name") == 0 && i + 1 < argc) {
+            name = QString::fromLocal8Bit(argv[++i]);
+        } else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = std::atoi(argv[++i]);
+        } else {
+            std::fprintf(stderr, "usage: minesweeper-host [--name NAME] [--threads N]\n");
+            return 1;
+        }
+    }
+
+    //线程池（在SessionHost中）必须比服务器和它的所有会话活得更久，所以最先创建
+    SessionHost host(threads);
+    SessionServer server(host);
+    if (!server.listen(name)) {
+        std::fprintf(stderr, "cannot listen on %s: %s\n", qPrintable(name), qPrintable(server.errorString()));
+        return 1;
+    }
+    std::printf("listening on %s with %d worker threads\n", qPrintable(server.fullServerName()), host.getThreadCount());
+    std::fflush(stdout);
+
+    return application.exec();
+}
@@ -0,0 +1,445 @@
+#include "BoardWidget.h"
+#include <QKeyEvent>  //包含Qt的键盘事件类，用于处理缩放快捷键
+#include <QMouseEvent>  //包含Qt的鼠标事件类
+#include <QPaintEvent>  //包含Qt的绘制事件类，用于获取需要重绘的区域
+#include <QPainter>  //包含Qt的绘图类
+#include <QScrollBar>  //包含Qt的滚动条类
+#include <QWheelEvent>  //包含Qt的滚轮事件类，用于Ctrl+滚轮缩放
+#include "../Core/Profiler.h"  //记录每次重绘的耗时
+
+//--- 小地图 ---
+//小地图只是BoardWidget内部使用的辅助控件：按比例画出整个棋盘的轮廓、缓存区域和当前可见区域，
+//点击或拖动时让棋盘滚动到对应位置；它不需要信号/槽，所以没有Q_OBJECT，直接回调所属的BoardWidget
+class BoardMiniMap : public QWidget {
+public:
+    //小地图的最大边长（像素）
+    static constexpr int MaxExtent = 140;
+
+    BoardMiniMap(BoardWidget *board, QWidget *parent) : QWidget(parent), m_board(board) {}
+
+    //棋盘尺寸变化时，按棋盘的长宽比调整小地图大小
+    void updateExtent() {
+        const QSize size = m_board->boardSize();
+        const int longest = qMax(1, qMax(size.width(), size.height()));
+        resize(qMax(8, MaxExtent * size.width() / longest), qMax(8, MaxExtent * size.height() / longest));
+    }
+
+protected:
+    void paintEvent(QPaintEvent *) override {
+        QPainter painter(this);
+        painter.fillRect(rect(), QColor(0x80, 0x80, 0x80, 200));
+        painter.setPen(Qt::white);
+        const QRect visible = m_board->visibleCells();
+        painter.drawRect(toMap(visible).adjusted(0, 0, -1, -1));
+    }
+
+    void mousePressEvent(QMouseEvent *event) override { jumpTo(event->position().toPoint()); }
+    void mouseMoveEvent(QMouseEvent *event) override { jumpTo(event->position().toPoint()); }
+
+private:
+    //把格子区域换算成小地图上的像素矩形
+    QRect toMap(const QRect &cells) const {
+        const QSize size = m_board->boardSize();
+        if (size.isEmpty()) return QRect();
+        const int left = cells.left() * width() / size.width();
+        const int top = cells.top() * height() / size.height();
+        const int right = (cells.right() + 1) * width() / size.width();
+        const int bottom = (cells.bottom() + 1) * height() / size.height();
+        return QRect(left, top, qMax(2, right - left), qMax(2, bottom - top));
+    }
+
+    //让棋盘滚动到小地图上某个像素位置对应的格子
+    void jumpTo(const QPoint &pos) {
+        const QSize size = m_board->boardSize();
+        if (width() <= 0 || height() <= 0) return;
+        m_board->centerOnCell(pos.y() * size.height() / height(), pos.x() * size.width() / width());
+    }
+
+    BoardWidget *m_board;
+};
+
+//构造函数的实现
+BoardWidget::BoardWidget(QWidget *parent) : QAbstractScrollArea(parent) {
+    //每次重绘都会用贴图完整覆盖需要重绘的区域，Qt不必先替我们擦除背景
+    viewport()->setAttribute(Qt::WA_OpaquePaintEvent);
+    setFocusPolicy(Qt::StrongFocus);  //接收键盘焦点，以便响应缩放快捷键
+
+    m_miniMap = new BoardMiniMap(this, viewport());
+    m_miniMap->hide();
+}
+
+//设置棋盘尺寸的实现
+void BoardWidget::setBoardSize(const QSize &size) {
+    m_rows = size.height();
+    m_cols = size.width();
+    m_pressedCell = -1;
+    m_chordCell = -1;
+    m_hintCell = -1;
+    //丢弃旧棋盘的缓存，新棋盘上所有格子都是未翻开状态，直到收到新的外观为止
+    m_window = QRect();
+    m_windowVisuals.clear();
+
+    horizontalScrollBar()->setValue(0);
+    verticalScrollBar()->setValue(0);
+    m_miniMap->updateExtent();
+    updateScrollBars();
+    updateGeometry();  //棋盘尺寸变化会改变sizeHint，通知外层布局
+    ensureWindow();
+    viewport()->update();
+}
+
+//更新单个格子外观的实现
+void BoardWidget::setCellVisual(int row, int col, CellVisual visual) {
+    //不在缓存区域内的格子不可见，直接忽略，等它滚动进来时会重新请求
+    if (!m_window.contains(col, row)) return;
+    m_windowVisuals[(row - m_window.top()) * m_window.width() + (col - m_window.left())] = visual;
+    if (row * m_cols + col == m_hintCell) m_hintCell = -1;  //提示的格子已经变了（例如被翻开），不再突出显示
+    viewport()->update(cellRect(row, col));  //只重绘这一个格子
+}
+
+//批量应用格子更新的实现
+void BoardWidget::applyUpdates(std::span<const CellUpdateInfo> updates) {
+    //记录所有被更新格子的行列范围，最后只请求重绘一次包含它们的最小矩形
+    int top = m_rows, left = m_cols, bottom = -1, right = -1;
+    for (const CellUpdateInfo &info : updates) {
+        if (!m_window.contains(info.col, info.row)) continue;
+        m_windowVisuals[(info.row - m_window.top()) * m_window.width() + (info.col - m_window.left())] = info.visual;
+        if (info.row * m_cols + info.col == m_hintCell) m_hintCell = -1;
+        top = qMin(top, info.row);
+        bottom = qMax(bottom, info.row);
+        left = qMin(left, info.col);
+        right = qMax(right, info.col);
+    }
+    if (bottom >= 0) {
+        viewport()->update(QRect(cellRect(top, left).topLeft(), cellRect(bottom, right).bottomRight()));
+    }
+}
+
+//突出显示提示格子的实现
+void BoardWidget::setHintCell(int row, int col) {
+    if (m_hintCell >= 0) {
+        viewport()->update(cellRect(m_hintCell / m_cols, m_hintCell % m_cols));
+    }
+    m_hintCell = (row >= 0 && row < m_rows && col >= 0 && col < m_cols) ? row * m_cols + col : -1;
+    if (m_hintCell < 0) return;
+    if (!visibleCells().contains(col, row)) {
+        centerOnCell(row, col);
+    }
+    viewport()->update(cellRect(row, col));
+}
+
+//放大的实现
+void BoardWidget::zoomIn() {
+    setZoomLevel(m_zoomLevel + 1, viewport()->rect().center());
+}
+
+//缩小的实现
+void BoardWidget::zoomOut() {
+    setZoomLevel(m_zoomLevel - 1, viewport()->rect().center());
+}
+
+//使指定格子位于视口中央的实现
+void BoardWidget::centerOnCell(int row, int col) {
+    const int size = cellSize();
+    horizontalScrollBar()->setValue(col * size + size / 2 - viewport()->width() / 2);
+    verticalScrollBar()->setValue(row * size + size / 2 - viewport()->height() / 2);
+}
+
+//visibleCells的实现
+QRect BoardWidget::visibleCells() const {
+    const int size = cellSize();
+    const int x = horizontalScrollBar()->value();
+    const int y = verticalScrollBar()->value();
+    const int firstCol = x / size;
+    const int firstRow = y / size;
+    const int lastCol = qMin(m_cols - 1, (x + viewport()->width() - 1) / size);
+    const int lastRow = qMin(m_rows - 1, (y + viewport()->height() - 1) / size);
+    if (lastCol < firstCol || lastRow < firstRow) return QRect();
+    return QRect(firstCol, firstRow, lastCol - firstCol + 1, lastRow - firstRow + 1);
+}
+
+//sizeHint的实现
+QSize BoardWidget::sizeHint() const {
+    //小棋盘时窗口恰好能完整显示整个棋盘；大棋盘时限制初始大小，其余部分通过滚动查看
+    const int frame = 2 * frameWidth();
+    return QSize(qMin(m_cols * cellSize(), 960) + frame, qMin(m_rows * cellSize(), 720) + frame);
+}
+
+//cellAt的实现
+int BoardWidget::cellAt(const QPoint &pos) const {
+    const int x = pos.x() + horizontalScrollBar()->value();
+    const int y = pos.y() + verticalScrollBar()->value();
+    if (pos.x() < 0 || pos.y() < 0 || x < 0 || y < 0) return -1;
+    const int row = y / cellSize();
+    const int col = x / cellSize();
+    if (row >= m_rows || col >= m_cols) return -1;
+    return row * m_cols + col;
+}
+
+//cellRect的实现
+QRect BoardWidget::cellRect(int row, int col) const {
+    const int size = cellSize();
+    return QRect(col * size - horizontalScrollBar()->value(), row * size - verticalScrollBar()->value(), size, size);
+}
+
+//chordRect的实现
+QRect BoardWidget::chordRect(int cell) const {
+    const int row = cell / m_cols;
+    const int col = cell % m_cols;
+    return QRect(cellRect(row - 1, col - 1).topLeft(), cellRect(row + 1, col + 1).bottomRight());
+}
+
+//更新滚动条范围的实现
+void BoardWidget::updateScrollBars() {
+    const int size = cellSize();
+    const QSize view = viewport()->size();
+    horizontalScrollBar()->setRange(0, qMax(0, m_cols * size - view.width()));
+    horizontalScrollBar()->setPageStep(view.width());
+    horizontalScrollBar()->setSingleStep(size);
+    verticalScrollBar()->setRange(0, qMax(0, m_rows * size - view.height()));
+    verticalScrollBar()->setPageStep(view.height());
+    verticalScrollBar()->setSingleStep(size);
+
+    //整个棋盘都能看到时不需要小地图
+    const bool needsMiniMap = m_cols * size > view.width() || m_rows * size > view.height();
+    m_miniMap->setVisible(needsMiniMap);
+    m_miniMap->move(view.width() - m_miniMap->width() - 8, view.height() - m_miniMap->height() - 8);
+}
+
+//确保缓存区域覆盖可见区域的实现
+void BoardWidget::ensureWindow() {
+    const QRect visible = visibleCells();
+    if (visible.isEmpty() || m_window.contains(visible)) return;
+
+    //以可见区域为中心，四周各多留WindowMargin个格子，并限制在棋盘范围内
+    const QRect window = visible.adjusted(-WindowMargin, -WindowMargin, WindowMargin, WindowMargin)
+                             .intersected(QRect(0, 0, m_cols, m_rows));
+
+    //新旧缓存区域重叠部分的外观直接沿用，其余格子先显示为未翻开，等待接收者发来真实的外观
+    QVector<CellVisual> visuals(window.width() * window.height(), CellVisual::Hidden);
+    const QRect overlap = window.intersected(m_window);
+    for (int r = overlap.top(); r <= overlap.bottom() && !overlap.isEmpty(); ++r) {
+        for (int c = overlap.left(); c <= overlap.right(); ++c) {
+            visuals[(r - window.top()) * window.width() + (c - window.left())] =
+                m_windowVisuals[(r - m_window.top()) * m_window.width() + (c - m_window.left())];
+        }
+    }
+    m_window = window;
+    m_windowVisuals = std::move(visuals);
+
+    emit viewportChanged(m_window);
+}
+
+//切换缩放级别的实现
+void BoardWidget::setZoomLevel(int level, const QPoint &anchor) {
+    level = qBound(0, level, int(std::size(ZoomLevels)) - 1);
+    if (level == m_zoomLevel) return;
+
+    //记录锚点下的棋盘像素位置（按旧的格子大小），缩放后把它放回同一个锚点
+    const double boardX = double(anchor.x() + horizontalScrollBar()->value()) / cellSize();
+    const double boardY = double(anchor.y() + verticalScrollBar()->value()) / cellSize();
+    m_zoomLevel = level;
+    m_atlas = QPixmap();  //格子大小变了，贴图集需要重建
+    updateScrollBars();
+    horizontalScrollBar()->setValue(int(boardX * cellSize()) - anchor.x());
+    verticalScrollBar()->setValue(int(boardY * cellSize()) - anchor.y());
+    ensureWindow();
+    viewport()->update();
+}
+
+//构建贴图集的实现
+//每种外观状态的样子与原先按钮上的样式表保持一致
+void BoardWidget::buildAtlas() {
+    const int size = cellSize();
+    //按屏幕的设备像素比例渲染，保证高分屏上的文字依然清晰
+    const qreal ratio = devicePixelRatioF();
+    m_atlas = QPixmap(QSize(CellVisualCount * size, size) * ratio);
+    m_atlas.setDevicePixelRatio(ratio);
+    m_atlas.fill(Qt::transparent);
+
+    QPainter painter(&m_atlas);
+    //字号随格子大小缩放，默认的30像素格子使用12号字
+    painter.setFont(QFont("Arial", qMax(4, size * 12 / 30), QFont::Bold));
+    const QColor numberColors[] = {Qt::blue, Qt::darkGreen, Qt::red, Qt::darkBlue,
+                                   QColor(165, 42, 42), Qt::black, Qt::black, Qt::black};
+
+    for (int i = 0; i < CellVisualCount; ++i) {
+        const auto visual = static_cast<CellVisual>(i);
+        const QRect rect(i * size, 0, size, size);
+        if (visual == CellVisual::Hidden || visual == CellVisual::Flagged) {
+            //未翻开的格子：灰色背景加上凸起的立体边框
+            painter.fillRect(rect, QColor(0xc0, 0xc0, 0xc0));
+            painter.setPen(Qt::white);
+            painter.drawLine(rect.topLeft(), rect.topRight());
+            painter.drawLine(rect.topLeft(), rect.bottomLeft());
+            painter.setPen(QColor(0x80, 0x80, 0x80));
+            painter.drawLine(rect.bottomLeft(), rect.bottomRight());
+            painter.drawLine(rect.topRight(), rect.bottomRight());
+            if (visual == CellVisual::Flagged) {
+                painter.drawText(rect, Qt::AlignCenter, "🚩");
+            }
+        } else if (visual == CellVisual::Mine) {
+            painter.fillRect(rect, Qt::red);
+            painter.drawText(rect, Qt::AlignCenter, "💣");
+        } else {
+            //已翻开的格子：浅灰色背景加细边框，数字格按数字使用不同的颜色
+            painter.fillRect(rect, QColor(0xe0, 0xe0, 0xe0));
+            painter.setPen(QColor(0x80, 0x80, 0x80));
+            painter.drawRect(rect.adjusted(0, 0, -1, -1));
+            const int number = i - static_cast<int>(CellVisual::Revealed0);
+            if (number > 0) {
+                painter.setPen(numberColors[number - 1]);
+                painter.drawText(rect, Qt::AlignCenter, QString::number(number));
+            }
+        }
+    }
+}
+
+//绘制事件的实现
+void BoardWidget::paintEvent(QPaintEvent *event) {
+    MINESWEEPER_PROFILE_SCOPE(ProfileZone::Paint);
+    if (m_atlas.isNull() || m_atlas.devicePixelRatio() != devicePixelRatioF()) {
+        buildAtlas();  //首次绘制、缩放后，或窗口被移到了像素比例不同的屏幕上
+    }
+
+    QPainter painter(viewport());
+    const QRect dirty = event->rect();
+    //视口中超出棋盘范围的部分（棋盘比视口小时）用窗口背景色填充
+    painter.fillRect(dirty, palette().window().color());
+
+    //只绘制与需要重绘区域相交的格子，代价只与可见区域有关
+    const int size = cellSize();
+    const int x = horizontalScrollBar()->value();
+    const int y = verticalScrollBar()->value();
+    const int firstRow = qMax(0, (dirty.top() + y) / size);
+    const int lastRow = qMin(m_rows - 1, (dirty.bottom() + y) / size);
+    const int firstCol = qMax(0, (dirty.left() + x) / size);
+    const int lastCol = qMin(m_cols - 1, (dirty.right() + x) / size);
+    const qreal ratio = m_atlas.devicePixelRatio();
+
+    for (int r = firstRow; r <= lastRow; ++r) {
+        for (int c = firstCol; c <= lastCol; ++c) {
+            CellVisual visual = CellVisual::Hidden;
+            if (m_window.contains(c, r)) {
+                visual = m_windowVisuals[(r - m_window.top()) * m_window.width() + (c - m_window.left())];
+            }
+            //左键按住未翻开的格子时，把它画成凹陷（已翻开的空白）的样子，模拟按钮被按下的效果
+            //双击按下期间，被按住的格子周围3x3范围内未翻开的格子都画成凹陷的样子，提示松开后会翻开哪些格子
+            const bool chordPressed = m_chordCell >= 0 && qAbs(r - m_chordCell / m_cols) <= 1 && qAbs(c - m_chordCell % m_cols) <= 1;
+            if ((r * m_cols + c == m_pressedCell || chordPressed) && visual == CellVisual::Hidden) {
+                visual = CellVisual::Revealed0;
+            }
+            const QRectF source(static_cast<int>(visual) * size * ratio, 0, size * ratio, size * ratio);
+            painter.drawPixmap(QRectF(cellRect(r, c)), m_atlas, source);
+        }
+    }
+
+    //提示的格子画一圈醒目的边框
+    if (m_hintCell >= 0) {
+        const QRect hint = cellRect(m_hintCell / m_cols, m_hintCell % m_cols);
+        if (hint.intersects(dirty)) {
+            painter.setPen(QPen(QColor(0x00, 0xa0, 0x00), qMax(2, size / 10)));
+            painter.drawRect(hint.adjusted(1, 1, -1, -1));
+        }
+    }
+}
+
+//鼠标按下事件的实现
+void BoardWidget::mousePressEvent(QMouseEvent *event) {
+    const int cell = cellAt(event->position().toPoint());
+    if (cell < 0) return;
+
+    //中键按下，或者在已按住左/右键的情况下再按下另一个键，进入双击状态，松开时才真正发出请求
+    const Qt::MouseButtons bothButtons = Qt::LeftButton | Qt::RightButton;
+    if (event->button() == Qt::MiddleButton || (event->buttons() & bothButtons) == bothButtons) {
+        if (m_pressedCell >= 0) {
+            viewport()->update(cellRect(m_pressedCell / m_cols, m_pressedCell % m_cols));
+            m_pressedCell = -1;
+        }
+        m_chordCell = cell;
+        viewport()->update(chordRect(cell));
+        return;
+    }
+
+    if (event->button() == Qt::RightButton) {
+        //右键按下时立即插旗/取消插旗
+        emit cellFlagRequested(cell / m_cols, cell % m_cols);
+    } else if (event->button() == Qt::LeftButton) {
+        //左键要等松开时才翻开，与普通按钮的行为一致；按下期间先把格子画成被按下的样子
+        m_pressedCell = cell;
+        viewport()->update(cellRect(cell / m_cols, cell % m_cols));
+    }
+}
+
+//鼠标松开事件的实现
+void BoardWidget::mouseReleaseEvent(QMouseEvent *event) {
+    //左右键双击时，第一个松开的按键已经发出了请求，剩下按键的松开直接忽略
+    if (m_ignoreRelease) {
+        m_ignoreRelease = (event->buttons() & (Qt::LeftButton | Qt::RightButton)) != 0;
+        return;
+    }
+
+    if (m_chordCell >= 0) {
+        const int chord = m_chordCell;
+        m_chordCell = -1;
+        viewport()->update(chordRect(chord));
+        m_ignoreRelease = (event->buttons() & (Qt::LeftButton | Qt::RightButton)) != 0;
+        //与单击相同：只有在同一个格子上按下并松开才算一次双击
+        if (cellAt(event->position().toPoint()) == chord) {
+            emit cellChordRequested(chord / m_cols, chord % m_cols);
+        }
+        return;
+    }
+
+    if (event->button() != Qt::LeftButton || m_pressedCell < 0) return;
+
+    const int pressed = m_pressedCell;
+    m_pressedCell = -1;
+    viewport()->update(cellRect(pressed / m_cols, pressed % m_cols));
+    //只有在同一个格子上按下并松开才算一次点击，按下后把鼠标移走再松开则取消
+    if (cellAt(event->position().toPoint()) == pressed) {
+        emit cellRevealRequested(pressed / m_cols, pressed % m_cols);
+    }
+}
+
+//滚轮事件的实现：按住Ctrl时以鼠标位置为中心缩放，否则正常滚动
+void BoardWidget::wheelEvent(QWheelEvent *event) {
+    if (event->modifiers() & Qt::ControlModifier) {
+        const int steps = event->angleDelta().y() / 120;
+        if (steps != 0) {
+            setZoomLevel(m_zoomLevel + steps, event->position().toPoint());
+        }
+        event->accept();
+        return;
+    }
+    QAbstractScrollArea::wheelEvent(event);
+}
+
+//键盘事件的实现：Ctrl+加号/减号缩放，Ctrl+0恢复默认大小
+void BoardWidget::keyPressEvent(QKeyEvent *event) {
+    if (event->modifiers() & Qt::ControlModifier) {
+        switch (event->key()) {
+            case Qt::Key_Plus:
+            case Qt::Key_Equal: zoomIn(); return;
+            case Qt::Key_Minus: zoomOut(); return;
+            case Qt::Key_0: setZoomLevel(DefaultZoomLevel, viewport()->rect().center()); return;
+            default: break;
+        }
+    }
+    QAbstractScrollArea::keyPressEvent(event);
+}
+
+//尺寸变化事件的实现
+void BoardWidget::resizeEvent(QResizeEvent *event) {
+    QAbstractScrollArea::resizeEvent(event);
+    updateScrollBars();
+    ensureWindow();  //视口变大后可能需要更大的缓存区域
+}
+
+//滚动事件的实现
+void BoardWidget::scrollContentsBy(int, int) {
+    //所有格子都是按滚动偏移实时绘制的，滚动后整体重绘视口即可（代价与可见格子数成正比）
+    ensureWindow();
+    viewport()->update();
+    m_miniMap->update();
+}
@@ -0,0 +1,120 @@
+#ifndef MINESWEEPER_BOARDWIDGET_H
+#define MINESWEEPER_BOARDWIDGET_H
+
+/*
+BoardWidget是棋盘的自绘控件，属于View层
+整个棋盘只是一个带滚动条的控件：它只缓存当前可见区域（外加一圈余量）内每个格子的外观状态（CellVisual，每格1字节），
+在paintEvent中从一张预先渲染好的贴图集里把对应的小图拷贝到格子的位置上，
+鼠标点击的位置通过简单的除法换算成行列号，再以信号的形式交给MainWindow转发
+当可见区域移出缓存的范围时，控件通过viewportChanged信号请求新区域的外观，
+所以无论棋盘有多大，创建、滚动和重绘的代价都只与屏幕上能看到的格子数有关
+*/
+
+#include <QAbstractScrollArea>  //包含Qt的滚动区域基类，提供滚动条和视口
+#include <QPixmap>  //包含QPixmap，用于存放预先渲染好的格子贴图集
+#include <QVector>  //包含Qt的动态数组容器，用于缓存可见区域内每个格子的外观状态
+#include <span>  //包含std::span，用于一次性接收一整段格子更新
+#include "../Common/IGameUI.h"  //包含CellVisual和CellUpdateInfo的定义
+
+class BoardMiniMap;
+
+class BoardWidget : public QAbstractScrollArea {
+    Q_OBJECT
+
+public:
+    explicit BoardWidget(QWidget *parent = nullptr);
+
+    //重新设置棋盘尺寸（宽度为列数，高度为行数），所有格子恢复为未翻开状态
+    void setBoardSize(const QSize &size);
+
+    //更新单个格子的外观，格子不在缓存区域内时直接忽略
+    void setCellVisual(int row, int col, CellVisual visual);
+
+    //一次性应用一批格子更新，只重绘包含所有被更新格子的最小矩形区域
+    void applyUpdates(std::span<const CellUpdateInfo> updates);
+
+    //突出显示提示的格子（row为-1时取消），格子不在视口内时把它滚动到视口中央；该格子的外观下一次更新时提示自动消失
+    void setHintCell(int row, int col);
+
+    //放大/缩小一级，保持视口中心的格子位置不变
+    void zoomIn();
+    void zoomOut();
+
+    //当前每个格子在屏幕上的边长（像素）
+    int cellSize() const { return ZoomLevels[m_zoomLevel]; }
+
+    //滚动棋盘，使指定格子位于视口中央
+    void centerOnCell(int row, int col);
+
+    //棋盘的行列数
+    QSize boardSize() const { return QSize(m_cols, m_rows); }
+
+    //当前在视口中可见的格子范围（行列坐标，x为列、y为行）
+    QRect visibleCells() const;
+
+    QSize sizeHint() const override;
+
+signals:
+    //玩家左键点击了一个格子（在同一个格子上按下并松开）
+    void cellRevealRequested(int row, int col);
+
+    //玩家右键点击了一个格子
+    void cellFlagRequested(int row, int col);
+
+    //玩家在一个格子上中键点击，或同时按下左右键后松开
+    void cellChordRequested(int row, int col);
+
+    //缓存的格子区域发生了变化（x为列、y为行），接收者需要把该区域内所有格子的外观发送过来
+    void viewportChanged(const QRect &cells);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+    void wheelEvent(QWheelEvent *event) override;
+    void keyPressEvent(QKeyEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void scrollContentsBy(int dx, int dy) override;
+
+private:
+    //可选的缩放级别（格子边长，像素），默认使用30像素
+    static constexpr int ZoomLevels[] = {6, 10, 15, 20, 30, 40};
+    static constexpr int DefaultZoomLevel = 4;
+    //缓存区域在可见区域四周额外多保留的格子数，小范围滚动时不需要重新请求外观
+    static constexpr int WindowMargin = 16;
+
+    //把视口内的像素坐标换算成格子的一维编号（row * cols + col），不在棋盘内时返回-1
+    int cellAt(const QPoint &pos) const;
+
+    //返回指定格子在视口中占据的矩形区域（已扣除滚动偏移）
+    QRect cellRect(int row, int col) const;
+
+    //返回以指定格子（一维编号）为中心的3x3区域在视口中占据的矩形，用于重绘双击按下的效果
+    QRect chordRect(int cell) const;
+
+    //根据棋盘尺寸、缩放级别和视口大小重新设置滚动条范围
+    void updateScrollBars();
+
+    //检查可见区域是否仍在缓存区域内，不在时以可见区域为中心重新确定缓存区域并请求其外观
+    void ensureWindow();
+
+    //切换到指定的缩放级别，锚点（视口内的像素位置）下的格子保持不动
+    void setZoomLevel(int level, const QPoint &anchor);
+
+    //预先把所有外观状态按当前格子大小各画一遍，横向排成一张贴图集
+    void buildAtlas();
+
+    int m_rows = 0;  //棋盘行数
+    int m_cols = 0;  //棋盘列数
+    int m_zoomLevel = DefaultZoomLevel;  //当前缩放级别在ZoomLevels中的下标
+    QRect m_window;  //缓存的格子区域（x为列、y为行）
+    QVector<CellVisual> m_windowVisuals;  //缓存区域内每个格子的外观状态，按缓存区域的行优先存储
+    QPixmap m_atlas;  //贴图集：第i个小图对应第i种外观状态
+    int m_pressedCell = -1;  //左键按下但尚未松开的格子编号，按下期间该格子画成凹陷的样子
+    int m_chordCell = -1;  //中键（或左右键同时）按下但尚未松开的格子编号，按下期间它周围未翻开的格子画成凹陷的样子
+    bool m_ignoreRelease = false;  //左右键双击已经在第一个按键松开时发出，第二个按键的松开需要忽略
+    int m_hintCell = -1;  //正在突出显示的提示格子编号，-1表示没有
+    BoardMiniMap *m_miniMap = nullptr;  //右下角的小地图，显示整个棋盘的轮廓和当前可见区域，可点击跳转
+};
+
+#endif //MINESWEEPER_BOARDWIDGET_H
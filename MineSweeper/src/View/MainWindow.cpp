@@ -1,8 +1,10 @@
 #include "MainWindow.h"
 #include "ui_MainWindow.h"  //必须包含由uic从.ui文件生成的头文件，它定义了`Ui::MainWindow`类
 #include <QMessageBox>  //包含Qt的消息框类，用于显示游戏结束对话框
-#include <QMouseEvent>  //包含Qt的鼠标事件类，用于在事件过滤器中判断鼠标按键
-#include <QPushButton>  //包含Qt的按钮类
+#include <QShortcut>  //包含Qt的快捷键类，用于撤销/重做和F3切换统计浮层
+#include "BoardWidget.h"  //包含自绘的棋盘控件
+#include "StatsOverlay.h"  //包含性能统计浮层
+#include "../Core/Profiler.h"  //记录View应用更新的耗时
 
 //构造函数的实现
 MainWindow::MainWindow(QWidget *parent)
@@ -13,12 +15,46 @@ MainWindow::MainWindow(QWidget *parent)
     ui->setupUi(this);
     setWindowTitle("Minesweeper");  //设置窗口标题
 
+    //创建自绘的棋盘控件，并放入.ui文件中为棋盘预留的网格布局里
+    m_board = new BoardWidget(ui->grids);
+    ui->gridLayout->addWidget(m_board, 0, 0);
+
+    //棋盘控件把鼠标点击换算成行列号后发出信号，MainWindow通过m_commands接口把它们转换成命令
+    connect(m_board, &BoardWidget::cellRevealRequested, this, [this](int row, int col) {
+        if (m_commands) m_commands->revealCellRequest(row, col);
+    });
+    connect(m_board, &BoardWidget::cellFlagRequested, this, [this](int row, int col) {
+        if (m_commands) m_commands->toggleFlagRequest(row, col);
+    });
+    connect(m_board, &BoardWidget::cellChordRequested, this, [this](int row, int col) {
+        if (m_commands) m_commands->chordCellRequest(row, col);
+    });
+    //棋盘滚动或缩放后，告诉ViewModel现在需要哪一块区域的格子
+    connect(m_board, &BoardWidget::viewportChanged, this, [this](const QRect &cells) {
+        if (m_commands) m_commands->setViewport(cells);
+    });
+
+    //撤销和重做使用平台的标准快捷键（Windows/Linux上是Ctrl+Z和Ctrl+Y/Ctrl+Shift+Z，macOS上是Cmd+Z和Cmd+Shift+Z）
+    auto *undoShortcut = new QShortcut(QKeySequence::Undo, this);
+    connect(undoShortcut, &QShortcut::activated, this, [this]() {
+        if (m_commands) m_commands->undoRequest();
+    });
+    auto *redoShortcut = new QShortcut(QKeySequence::Redo, this);
+    connect(redoShortcut, &QShortcut::activated, this, [this]() {
+        if (m_commands) m_commands->redoRequest();
+    });
+
+    //性能统计浮层默认隐藏，玩家反馈卡顿时可以按F3查看各个环节的耗时
+    m_stats = new StatsOverlay(m_board);
+    m_stats->hide();
+    auto *statsShortcut = new QShortcut(QKeySequence(Qt::Key_F3), this);
+    connect(statsShortcut, &QShortcut::activated, this, [this]() { m_stats->setVisible(!m_stats->isVisible()); });
+
     //View是一个被动的接收者，其更新完全由IGameUI接口的方法驱动
 }
 
 //析构函数的实现
 MainWindow::~MainWindow() {
-    clearBoard();  //清理棋盘上的按钮
     delete ui;  //删除ui对象，释放其管理的Designer创建的所有控件
 }
 
@@ -31,69 +67,27 @@ void MainWindow::setCommands(IGameCommands* commands) {
     on_newGameButton_clicked();
 }
 
-//清理棋盘的实现
-void MainWindow::clearBoard() {
-    for (auto& row : m_cellButtons) {
-        for (auto* button : row) {
-            //从布局中移除控件（如果不移除，控件在视觉上会消失，但仍在布局的管理之下）
-            ui->gridLayout->removeWidget(button);
-            //显式删除动态创建的QPushButton对象，释放内存
-            delete button;
-        }
-    }
-    //清空存储指针的向量
-    m_cellButtons.clear();
-}
-
 //--- IGameUI 接口的实现 ---
 
 //当棋盘尺寸变化时的实现
 void MainWindow::onBoardSizeChanged(const QSize& newSize) {
-    clearBoard();  //先清除旧的棋盘
-    const int rows = newSize.height();
-    const int cols = newSize.width();
-    m_cellButtons.resize(rows);  //调整行数
-
-    for (int r = 0; r < rows; ++r) {
-        m_cellButtons[r].resize(cols);  //调整列数
-        for (int c = 0; c < cols; ++c) {
-            //为每个格子动态创建一个新的QPushButton
-            //将this作为父对象，这样当MainWindow被销毁时，这些按钮也会被Qt的对象树机制自动清理（作为安全保障）
-            QPushButton *button = new QPushButton(this);
-            button->setFixedSize(30, 30);  //设置格子大小为固定30×30像素
-            button->setFont(QFont("Arial", 12, QFont::Bold));  //设置字体、字号、粗体
-
-            //将按钮的左键点击信号连接到一个Lambda表达式
-            //Lambda捕获this指针和当前的行列号(r, c)，当按钮被点击时，它会通过m_commands接口发出“翻开格子”的命令
-            connect(button, &QPushButton::clicked, this, [this, r, c]() {
-                if (m_commands) m_commands->revealCellRequest(r, c);
-            });
-
-            //为按钮安装事件过滤器，让MainWindow可以“监视”它的事件，从而捕获右键点击
-            button->installEventFilter(this);
-            //使用QObject的动态属性来将行列信息“附加”到按钮上，方便在事件过滤器中读取
-            button->setProperty("row", r);
-            button->setProperty("col", c);
-
-            //将新创建的按钮添加到.ui文件中定义的网格布局中
-            ui->gridLayout->addWidget(button, r, c);
-            //将按钮指针存入我们的二维向量中，以便后续通过行列号访问
-            m_cellButtons[r][c] = button;
-        }
-    }
+    //棋盘控件只需要重新分配每个格子的外观状态，不再创建和销毁任何子控件
+    m_board->setBoardSize(newSize);
+    //小棋盘时让窗口恰好容纳整个棋盘；大棋盘时窗口保持在合理大小，其余部分通过滚动和缩放查看
+    adjustSize();
 }
 
 //更新单个格子外观的实现
 void MainWindow::onCellUpdated(const CellUpdateInfo &info) {
-    //边界检查，确保行列号有效
-    if (info.row < m_cellButtons.size() && info.col < m_cellButtons[info.row].size()) {
-        QPushButton* button = m_cellButtons[info.row][info.col];
-        //根据ViewModel准备好的信息，直接更新按钮的文本、样式和启用状态
-        //View在这里只做最简单的“执行”工作，不包含任何逻辑判断
-        button->setText(info.text);
-        button->setStyleSheet(info.styleSheet);
-        button->setEnabled(info.enabled);
-    }
+    //View在这里只做最简单的“执行”工作：把ViewModel决定好的外观状态交给棋盘控件绘制
+    m_board->setCellVisual(info.row, info.col, info.visual);
+}
+
+//批量更新格子外观的实现
+void MainWindow::onCellsUpdated(std::span<const CellUpdateInfo> updates) {
+    MINESWEEPER_PROFILE_SCOPE(ProfileZone::ApplyView);
+    //棋盘控件一次性记录所有格子的新外观，并只请求重绘一次包含它们的区域
+    m_board->applyUpdates(updates);
 }
 
 //显示游戏结束对话框的实现
@@ -112,40 +106,36 @@ void MainWindow::updateStatusLabel(const QString& text) {
     ui->statusLabel->setText(text);
 }
 
+//显示提示的实现
+void MainWindow::onShowHint(int row, int col, const QString &message) {
+    //在棋盘上突出显示建议的格子，说明文字显示在状态栏中，几秒后自动消失
+    m_board->setHintCell(row, col);
+    ui->statusbar->showMessage(message, 5000);
+}
+
 //--- UI 槽函数的实现 ---
 
 //“New Game”按钮点击事件的槽函数
 void MainWindow::on_newGameButton_clicked(){
     //如果命令接口指针有效，则通过它发出“开始新游戏”的命令
     if (m_commands) {
-        m_commands->startNewGame(10, 10, 15); // 使用默认难度。
+        m_commands->startNewGame(m_settings.rows, m_settings.cols, m_settings.mines, m_settings.policy);  //使用当前选择的难度和首次点击策略
     }
 }
 
-//事件过滤器的实现
-//标准的QPushButton只提供了一个clicked()信号。这个信号通常由鼠标左键点击触发，它并没有提供专用于右键点击的内置信号
-//为响应右键点击，可以子类化QPushButton（继承），但这样会增加类的数量
-//也可以使用事件过滤器，不用修改QPushButton，而是让另一个对象（通常是父窗口，即这里的MainWindow）来监视按钮的事件，如果发现是右键点击，则进行拦截与处理（先于button自己的事件处理函数被调用）
-bool MainWindow::eventFilter(QObject *watched, QEvent *event) {
-    //检查事件类型是否是鼠标按下
-    if (event->type() == QEvent::MouseButtonPress) {
-        //检查事件源对象是否是一个QPushButton
-        if (auto *button = qobject_cast<QPushButton*>(watched)) {
-            //将通用事件安全地转换为鼠标事件
-            auto *mouseEvent = static_cast<QMouseEvent*>(event);
-            //检查是否是右键
-            if (mouseEvent->button() == Qt::RightButton) {
-                //从按钮的动态属性中读回行列信息
-                int row = button->property("row").toInt();
-                int col = button->property("col").toInt();
-                //通过命令接口发出“插旗”的命令
-                if (m_commands) m_commands->toggleFlagRequest(row, col);
-                //返回true，表示事件已被处理，不需要再传递给按钮自身，这可以防止右键点击时按钮出现“按下”的视觉效果
-                return true;
-            }
-        }
+//“Board...”按钮点击事件的槽函数
+void MainWindow::on_boardButton_clicked() {
+    NewGameDialog dialog(this);
+    dialog.setSettings(m_settings);
+    if (dialog.exec() == QDialog::Accepted) {
+        m_settings = dialog.settings();
+        on_newGameButton_clicked();
+    }
+}
+
+//“Hint”按钮点击事件的槽函数
+void MainWindow::on_hintButton_clicked() {
+    if (m_commands) {
+        m_commands->hintRequest();
     }
-    //对于所有其他我们不关心的事件，调用基类的实现，让Qt按默认方式处理
-    //事件会继续被传递给它原本的目标——button，然后button会按照它自己的标准流程来处理这个事件
-    return QMainWindow::eventFilter(watched, event);
 }
\ No newline at end of file
@@ -10,14 +10,15 @@
 */
 
 #include <QMainWindow>  //包含Qt的主窗口基类，提供了应用程序主窗口的标准框架
-#include <QVector>  //包含Qt的动态数组容器，用于存储指向扫雷格子的按钮指针
 #include "../common/IGameUI.h"
 #include "../common/IGameCommands.h"
+#include "NewGameDialog.h"  //包含棋盘设置，MainWindow记住玩家最近一次选择的设置
 
 //--- 前向声明 ---
 //可以减少头文件的物理依赖，加快编译速度
 //因为在这里我们只需要用到这些类的指针或引用，而不需要知道它们的完整定义
-class QPushButton;
+class BoardWidget;
+class StatsOverlay;
 
 //标准的Qt样板代码，用于处理.ui文件生成的类
 QT_BEGIN_NAMESPACE
@@ -45,13 +46,11 @@ public:
 public:
     void onBoardSizeChanged(const QSize& newSize) override;
     void onCellUpdated(const CellUpdateInfo& info) override;
+    void onCellsUpdated(std::span<const CellUpdateInfo> updates) override;
     void onShowGameOverDialog(const QString& message) override;
     void updateFlagsLabel(int flags) override;
     void updateStatusLabel(const QString& text) override;
-
-protected:
-    //重写QObject的事件过滤器方法，用于捕获和处理子控件的特定事件（此处为右键点击）
-    bool eventFilter(QObject *watched, QEvent *event) override;
+    void onShowHint(int row, int col, const QString& message) override;
 
 private slots:
     //--- 槽函数 ---
@@ -59,19 +58,27 @@ private slots:
     //它的命名遵循Qt的自动连接约定 (on_<objectName>_<signalName>)，所以无需手动connect
     void on_newGameButton_clicked();
 
-private:
-    //私有辅助函数，用于清理和删除所有动态创建的格子按钮
-    void clearBoard();
+    //响应“Board...”按钮，弹出对话框选择难度（或自定义棋盘大小）和首次点击策略，确定后按新的设置开始一局
+    void on_boardButton_clicked();
+
+    //响应“Hint”按钮（或H键），向ViewModel请求提示
+    void on_hintButton_clicked();
 
+private:
     //--- 私有成员变量 ---
     Ui::MainWindow *ui;  //指向由Designer生成的UI类的指针，通过它，可以访问在.ui文件中定义的所有控件
 
     //指向命令接口的指针，当用户操作时，View会通过这个指针发出命令
     IGameCommands* m_commands = nullptr;
 
-    //二维动态数组，用于存储所有动态生成的扫雷格子按钮的指针
-    //这使得我们可以方便地通过行列索引来访问和管理每一个格子按钮
-    QVector<QVector<QPushButton*>> m_cellButtons;
+    //自绘的棋盘控件，整个棋盘只有这一个控件，不再为每个格子创建按钮
+    BoardWidget* m_board = nullptr;
+
+    //浮在棋盘上的性能统计浮层，按F3显示/隐藏
+    StatsOverlay* m_stats = nullptr;
+
+    //当前的棋盘设置，“New Game”按钮按这个设置开始新的一局
+    NewGameDialog::Settings m_settings;
 };
 
 #endif // MAINWINDOW_H
\ No newline at end of file
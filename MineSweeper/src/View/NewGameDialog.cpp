@@ -0,0 +1,122 @@
+#include "NewGameDialog.h"
+#include "../Core/NoGuessGenerator.h"  //包含NoGuessGenerator::canGenerate
+#include <QComboBox>  //包含下拉框，用于选择预设难度
+#include <QDialogButtonBox>  //包含标准的确定/取消按钮
+#include <QFormLayout>  //包含表单布局，每行一个标签和一个输入框
+#include <QSpinBox>  //包含数字输入框
+#include <QStandardItemModel>  //包含下拉框默认使用的数据模型，用于禁用其中的一项
+#include <algorithm>  //包含std::max
+#include <iterator>  //包含std::size
+
+namespace {
+//预设难度
+struct Preset {
+    const char *name;
+    NewGameDialog::Settings settings;
+};
+
+//经典的三种难度，以及用来浏览超大棋盘的两种（地雷密度与高级接近）
+constexpr Preset kPresets[] = {
+    {"Beginner (9x9, 10 mines)", {9, 9, 10}},
+    {"Intermediate (16x16, 40 mines)", {16, 16, 40}},
+    {"Expert (16x30, 99 mines)", {16, 30, 99}},
+    {"Huge (1000x1000, 200000 mines)", {1000, 1000, 200000}},
+    {"Giant (10000x10000, 20000000 mines)", {10000, 10000, 20000000}},
+};
+}
+
+//构造函数的实现
+NewGameDialog::NewGameDialog(QWidget *parent) : QDialog(parent) {
+    setWindowTitle("New Game");
+
+    m_preset = new QComboBox(this);
+    for (const Preset &preset : kPresets) m_preset->addItem(preset.name);
+    m_preset->addItem("Custom");
+
+    m_rows = new QSpinBox(this);
+    m_rows->setRange(1, MaxSide);
+    m_cols = new QSpinBox(this);
+    m_cols->setRange(1, MaxSide);
+    m_mines = new QSpinBox(this);
+    m_mines->setRange(0, 0);
+    m_policy = new QComboBox(this);
+    m_policy->addItem("Safe first cell");
+    m_policy->addItem("Safe opening (3x3)");
+    m_policy->addItem("No guessing (solver-certified)");
+
+    auto *buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, this);
+    connect(buttons, &QDialogButtonBox::accepted, this, &QDialog::accept);
+    connect(buttons, &QDialogButtonBox::rejected, this, &QDialog::reject);
+
+    auto *layout = new QFormLayout(this);
+    layout->addRow("Difficulty:", m_preset);
+    layout->addRow("Rows:", m_rows);
+    layout->addRow("Columns:", m_cols);
+    layout->addRow("Mines:", m_mines);
+    layout->addRow("First click:", m_policy);
+    layout->addRow(buttons);
+
+    connect(m_preset, &QComboBox::currentIndexChanged, this, &NewGameDialog::onPresetChanged);
+    connect(m_rows, &QSpinBox::valueChanged, this, &NewGameDialog::updateMineLimit);
+    connect(m_cols, &QSpinBox::valueChanged, this, &NewGameDialog::updateMineLimit);
+    connect(m_rows, &QSpinBox::valueChanged, this, &NewGameDialog::updatePolicyLimit);
+    connect(m_cols, &QSpinBox::valueChanged, this, &NewGameDialog::updatePolicyLimit);
+    connect(m_mines, &QSpinBox::valueChanged, this, &NewGameDialog::updatePolicyLimit);
+    setSettings(Settings());
+}
+
+//setSettings的实现
+void NewGameDialog::setSettings(const Settings &settings) {
+    m_rows->setValue(settings.rows);
+    m_cols->setValue(settings.cols);
+    updateMineLimit();
+    m_mines->setValue(settings.mines);
+    m_policy->setCurrentIndex(int(settings.policy));
+    updatePolicyLimit();
+
+    int index = int(std::size(kPresets));  //自定义
+    for (int i = 0; i < int(std::size(kPresets)); ++i) {
+        const Settings &preset = kPresets[i].settings;
+        if (preset.rows == settings.rows && preset.cols == settings.cols && preset.mines == settings.mines) index = i;
+    }
+    m_preset->setCurrentIndex(index);
+    onPresetChanged(index);  //下标没有改变时不会发出信号，这里直接同步输入框的可编辑状态
+}
+
+//settings的实现
+NewGameDialog::Settings NewGameDialog::settings() const {
+    return {m_rows->value(), m_cols->value(), m_mines->value(), FirstClickPolicy(m_policy->currentIndex())};
+}
+
+//onPresetChanged的实现
+void NewGameDialog::onPresetChanged(int index) {
+    const bool custom = index < 0 || index >= int(std::size(kPresets));
+    if (!custom) {
+        const Settings &preset = kPresets[index].settings;
+        m_rows->setValue(preset.rows);
+        m_cols->setValue(preset.cols);
+        updateMineLimit();
+        m_mines->setValue(preset.mines);
+    }
+    m_rows->setEnabled(custom);
+    m_cols->setEnabled(custom);
+    m_mines->setEnabled(custom);
+}
+
+//updateMineLimit的实现
+void NewGameDialog::updateMineLimit() {
+    //行数和列数都不超过MaxSide，乘积不会溢出int
+    m_mines->setMaximum(std::max(0, m_rows->value() * m_cols->value() - 1));
+}
+
+
+//updatePolicyLimit的实现
+void NewGameDialog::updatePolicyLimit() {
+    const bool feasible = NoGuessGenerator::canGenerate(m_rows->value(), m_cols->value(), m_mines->value());
+    if (auto *model = qobject_cast<QStandardItemModel *>(m_policy->model())) {
+        model->item(int(FirstClickPolicy::NoGuess))->setEnabled(feasible);
+    }
+    if (!feasible && m_policy->currentIndex() == int(FirstClickPolicy::NoGuess)) {
+        m_policy->setCurrentIndex(int(FirstClickPolicy::SafeArea));
+    }
+}
@@ -0,0 +1,59 @@
+#ifndef MINESWEEPER_NEWGAMEDIALOG_H
+#define MINESWEEPER_NEWGAMEDIALOG_H
+
+/*
+NewGameDialog是选择棋盘设置的对话框，属于View层
+玩家可以选择初级、中级、高级等预设难度，也可以选择自定义并直接输入行数、列数和地雷数（最大10000x10000）
+首次点击的保护策略与难度分开选择，其中“不需要猜”的棋盘保证只靠推理就能赢（比赛中使用）；
+它只能用于生成器应付得了的棋盘（见NoGuessGenerator::canGenerate），超大或者太密的棋盘上这一项不可选
+对话框只负责收集设置，开始新游戏仍然由MainWindow通过IGameCommands发出命令
+*/
+
+#include <QDialog>  //包含Qt的对话框基类
+#include "../Core/Board.h"  //包含FirstClickPolicy
+
+class QComboBox;
+class QSpinBox;
+
+class NewGameDialog : public QDialog {
+    Q_OBJECT
+
+public:
+    //一局游戏的棋盘设置
+    struct Settings {
+        int rows = 10;
+        int cols = 10;
+        int mines = 15;
+        FirstClickPolicy policy = FirstClickPolicy::SafeCell;
+    };
+
+    //行数和列数的上限：10000x10000的棋盘连同哨兵格子约1亿个字节
+    static constexpr int MaxSide = 10000;
+
+    explicit NewGameDialog(QWidget *parent = nullptr);
+
+    //显示对话框之前设置初始值（与某个预设相同时选中该预设，否则选中自定义）
+    void setSettings(const Settings &settings);
+
+    //玩家选择的设置
+    Settings settings() const;
+
+private slots:
+    //选择了某个预设：把它的设置填进输入框；选择自定义时允许编辑输入框
+    void onPresetChanged(int index);
+
+    //行数或列数改变后，地雷数的上限随之改变（至少要留下一个安全格子）
+    void updateMineLimit();
+
+    //棋盘设置改变后，生成器应付不了时禁用“不需要猜”，已经选中的改成“首次点击周围3x3安全”
+    void updatePolicyLimit();
+
+private:
+    QComboBox *m_preset = nullptr;  //预设难度，最后一项是自定义
+    QSpinBox *m_rows = nullptr;
+    QSpinBox *m_cols = nullptr;
+    QSpinBox *m_mines = nullptr;
+    QComboBox *m_policy = nullptr;  //首次点击的保护策略，按FirstClickPolicy的顺序排列
+};
+
+#endif //MINESWEEPER_NEWGAMEDIALOG_H
@@ -0,0 +1,55 @@
+#include "StatsOverlay.h"
+#include "../Core/Profiler.h"  //统计数据的来源
+
+//构造函数的实现
+StatsOverlay::StatsOverlay(QWidget *parent) : QLabel(parent) {
+    setAttribute(Qt::WA_TransparentForMouseEvents);  //鼠标事件穿透到下面的棋盘
+    setStyleSheet("background-color: rgba(0, 0, 0, 170); color: white; font-family: monospace; padding: 6px;");
+    move(8, 8);
+    connect(&m_timer, &QTimer::timeout, this, &StatsOverlay::refresh);
+}
+
+//showEvent的实现
+void StatsOverlay::showEvent(QShowEvent *event) {
+    QLabel::showEvent(event);
+    raise();  //保持在棋盘的其他子控件（例如小地图）之上
+    refresh();
+    m_timer.start(RefreshIntervalMs);
+}
+
+//hideEvent的实现
+void StatsOverlay::hideEvent(QHideEvent *event) {
+    QLabel::hideEvent(event);
+    m_timer.stop();
+}
+
+//refresh的实现
+void StatsOverlay::refresh() {
+#if MINESWEEPER_PROFILING
+    const Profiler::Snapshot snapshot = Profiler::instance().snapshot();
+    QString text = QString::asprintf("%-14s %7s %9s %9s %9s", "zone (ms)", "calls", "last", "avg", "max");
+    for (int i = 0; i < ProfileZoneCount; ++i) {
+        const Profiler::Stats &stats = snapshot.zones[i];
+        const double average = stats.calls > 0 ? double(stats.total) / double(stats.calls) : 0.0;
+        text += QString::asprintf("\n%-14s %7llu %9.3f %9.3f %9.3f", Profiler::name(ProfileZone(i)),
+                                  static_cast<unsigned long long>(stats.calls), double(stats.last) / 1e6,
+                                  average / 1e6, double(stats.max) / 1e6);
+    }
+    text += QString::asprintf("\n\n%-14s %7s %9s %9s %9s", "counter", "calls", "last", "avg", "max");
+    for (int i = 0; i < ProfileCounterCount; ++i) {
+        const Profiler::Stats &stats = snapshot.counters[i];
+        const double average = stats.calls > 0 ? double(stats.total) / double(stats.calls) : 0.0;
+        text += QString::asprintf("\n%-14s %7llu %9llu %9.1f %9llu", Profiler::name(ProfileCounter(i)),
+                                  static_cast<unsigned long long>(stats.calls),
+                                  static_cast<unsigned long long>(stats.last), average,
+                                  static_cast<unsigned long long>(stats.max));
+    }
+    if (Profiler::instance().isTracing()) {
+        text += "\n\ntracing to MINESWEEPER_TRACE";
+    }
+    setText(text);
+#else
+    setText("Profiling is disabled in this build (MINESWEEPER_PROFILING=OFF).");
+#endif
+    adjustSize();
+}
@@ -0,0 +1,35 @@
+#ifndef MINESWEEPER_STATSOVERLAY_H
+#define MINESWEEPER_STATSOVERLAY_H
+
+/*
+StatsOverlay是浮在棋盘左上角的性能统计浮层，属于View层，按F3显示/隐藏
+显示期间每隔一段时间读取一次Profiler的快照，列出每个计时区段的次数、最近一次、平均和最大耗时，以及每个计数器的数值
+它不拦截鼠标事件，点击会直接落到下面的棋盘上
+*/
+
+#include <QLabel>  //包含Qt的标签类，浮层只是一段等宽的文字
+#include <QTimer>  //包含定时器，用于定期刷新统计
+
+class StatsOverlay : public QLabel {
+    Q_OBJECT
+
+public:
+    explicit StatsOverlay(QWidget *parent = nullptr);
+
+protected:
+    //只在显示期间刷新，隐藏时停止定时器
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
+private slots:
+    //读取Profiler的快照并更新显示的文字
+    void refresh();
+
+private:
+    //刷新的间隔（毫秒）
+    static constexpr int RefreshIntervalMs = 500;
+
+    QTimer m_timer;
+};
+
+#endif //MINESWEEPER_STATSOVERLAY_H
@@ -1,18 +1,72 @@
 #include "GameViewModel.h"
+#include <algorithm>  //包含std::max
+#include "../Core/Profiler.h"  //记录翻译格子的耗时和交给View的更新数
+
+namespace {
+//异步模式下把改变交给View的最小间隔（毫秒），约等于60帧每秒的一帧
+constexpr int kFrameIntervalMs = 16;
+}
 
 //GameViewModel的构造函数实现
 GameViewModel::GameViewModel(GameModel& model, QObject *parent)
     : QObject(parent), m_model(model) {
     //--- 核心连接逻辑 ---
     //在构造函数中，建立ViewModel和Model之间的信号/槽连接，这样，一旦ViewModel被创建，它就会自动开始“监听”Model
+    connectModel();
+
+    //异步模式下的帧定时器：每次只触发一次，由scheduleFrame按需启动
+    m_frameTimer.setSingleShot(true);
+    connect(&m_frameTimer, &QTimer::timeout, this, &GameViewModel::flushModelChanges);
+}
 
+//connectModel的实现
+void GameViewModel::connectModel() {
     //将Model的modelChanged信号连接到ViewModel的onModelChanged槽
     //当Model的数据发生任何变化时，onModelChanged函数就会被调用
     connect(&m_model, &GameModel::modelChanged, this, &GameViewModel::onModelChanged);
 
+    //将Model的cellsChanged信号连接到ViewModel的onCellsChanged槽
+    //每次翻开或插旗后，只有被改变的那些格子会被重新翻译
+    connect(&m_model, &GameModel::cellsChanged, this, &GameViewModel::onCellsChanged);
+
     //将Model的gameOver信号连接到ViewModel的onGameOver槽
     //当Model判断游戏结束时，onGameOver函数就会被调用
     connect(&m_model, &GameModel::gameOver, this, &GameViewModel::onGameOver);
+
+    //撤销了结束游戏的那一步时，状态文字要回到进行中
+    connect(&m_model, &GameModel::gameResumed, this, &GameViewModel::onGameResumed);
+}
+
+//disconnectModel的实现
+void GameViewModel::disconnectModel() {
+    disconnect(&m_model, &GameModel::modelChanged, this, &GameViewModel::onModelChanged);
+    disconnect(&m_model, &GameModel::cellsChanged, this, &GameViewModel::onCellsChanged);
+    disconnect(&m_model, &GameModel::gameOver, this, &GameViewModel::onGameOver);
+    disconnect(&m_model, &GameModel::gameResumed, this, &GameViewModel::onGameResumed);
+}
+
+//setAsynchronous的实现
+void GameViewModel::setAsynchronous(bool enabled) {
+    if (enabled == bool(m_executor)) return;
+
+    if (enabled) {
+        //此时Model还在当前线程中、没有任何命令在执行，可以直接复制一份镜像
+        disconnectModel();
+        m_mirror = m_model.board();
+        m_executor = std::make_unique<ModelExecutor>(m_model);
+        //changesPending在工作线程中发出，显式使用QueuedConnection让scheduleFrame在GUI线程中执行
+        connect(m_executor.get(), &ModelExecutor::changesPending, this, &GameViewModel::scheduleFrame,
+                Qt::QueuedConnection);
+        m_sinceFlush.start();
+        return;
+    }
+
+    //已提交的命令全部执行完、Model回到当前线程后，把最后一批改变交给View，再恢复同步模式
+    m_frameTimer.stop();
+    m_executor->waitForIdle();
+    flushModelChanges();
+    m_executor.reset();
+    connectModel();
 }
 
 //setUI方法的实现
@@ -24,77 +78,310 @@ void GameViewModel::setUI(IGameUI* ui) {
 //--- IGameCommands 接口的实现 ---
 
 //startNewGame命令的实现
-void GameViewModel::startNewGame(int rows, int cols, int mines) {
+void GameViewModel::startNewGame(int rows, int cols, int mines, FirstClickPolicy policy) {
+    //异步模式下提交到工作线程，尚未执行的旧命令随之作废；新棋盘在下一帧同步过来后才通知UI
+    if (m_executor) {
+        m_executor->postNewGame([rows, cols, mines, policy](GameModel &model) { model.startGame(rows, cols, mines, policy); });
+        return;
+    }
+
     //ViewModel将业务逻辑委托给Model处理
-    m_model.startGame(rows, cols, mines);
+    m_model.startGame(rows, cols, mines, policy);
 
     //在 Model初始化后，ViewModel主动向UI发送初始化的渲染指令
+    announceNewGame();
+}
+
+//announceNewGame的实现
+void GameViewModel::announceNewGame() {
     if (m_ui) {
         m_ui->updateStatusLabel("Game in progress...");
         //QSize的构造(宽度, 高度)对应(列数, 行数)
-        m_ui->onBoardSizeChanged(QSize(cols, rows));
+        m_ui->onBoardSizeChanged(QSize(board().getCols(), board().getRows()));
     }
 }
 
 //revealCellRequest命令的实现
 void GameViewModel::revealCellRequest(int row, int col) {
+    //异步模式下提交到工作线程，结果在之后的某一帧到达flushModelChanges
+    if (m_executor) {
+        m_executor->post([row, col](GameModel &model) { model.revealCell(row, col); });
+        return;
+    }
     //这是一个简单的“直通”命令：直接将View的请求转发给Model的相应方法
     m_model.revealCell(row, col);
 }
 
 //toggleFlagRequest命令的实现
 void GameViewModel::toggleFlagRequest(int row, int col) {
+    if (m_executor) {
+        m_executor->post([row, col](GameModel &model) { model.flagCell(row, col); });
+        return;
+    }
     //同样，直接将View的插旗请求转发给Model
     m_model.flagCell(row, col);
 }
 
+//chordCellRequest命令的实现
+void GameViewModel::chordCellRequest(int row, int col) {
+    if (m_executor) {
+        m_executor->post([row, col](GameModel &model) { model.chordCell(row, col); });
+        return;
+    }
+    //同样直接转发给Model，周围所有格子的翻开结果会合并成一次cellsChanged信号到达onCellsChanged
+    m_model.chordCell(row, col);
+}
+
+//undoRequest命令的实现
+void GameViewModel::undoRequest() {
+    if (m_executor) {
+        m_executor->post([](GameModel &model) { model.undo(); });
+        return;
+    }
+    //被撤销的格子同样通过cellsChanged信号到达onCellsChanged，和一次普通操作一样只更新这些格子
+    m_model.undo();
+}
+
+//redoRequest命令的实现
+void GameViewModel::redoRequest() {
+    if (m_executor) {
+        m_executor->post([](GameModel &model) { model.redo(); });
+        return;
+    }
+    m_model.redo();
+}
+
+//hintRequest命令的实现
+void GameViewModel::hintRequest() {
+    if (!m_ui) return;
+
+    //求解器只需检查上次提示之后改变过的格子附近，之后通常只需取出一个已推理出的安全格子
+    syncSolver();
+    const Solver::Hint hint = m_solver.hint(board());
+    if (hint.row < 0) {
+        m_ui->onShowHint(-1, -1, "No hint available.");
+    } else if (hint.certain) {
+        m_ui->onShowHint(hint.row, hint.col, QString("Hint: (%1, %2) is safe.").arg(hint.row + 1).arg(hint.col + 1));
+    } else {
+        //没有确定安全的格子，只能建议地雷概率最低的格子
+        m_ui->onShowHint(hint.row, hint.col, QString("Hint: no safe cell, (%1, %2) has the lowest risk (%3% mine).")
+                                                 .arg(hint.row + 1).arg(hint.col + 1).arg(hint.mineProbability * 100.0, 0, 'f', 1));
+    }
+}
+
+//setViewport命令的实现
+void GameViewModel::setViewport(const QRect &cells) {
+    //只保留落在棋盘范围内的部分
+    m_viewport = cells.intersected(QRect(0, 0, board().getCols(), board().getRows()));
+    m_hasViewport = true;
+    if (!m_ui) return;
+
+    //新进入视野的格子此前没有发送过，把整块区域的当前状态发送一次
+    sendRegion(m_viewport);
+}
+
 //--- 槽函数的实现 ---
 
 //onModelChanged槽的实现
 void GameViewModel::onModelChanged() {
+    //新的一局，求解器之前的推理结果全部作废，到下一次提示时再从头推理
+    m_solverStale = true;
+    clearSolverPending();
+    m_minesLaid = board().getGameState() != GameState::Ready;
+
     //如果没有关联的 UI，则不执行任何操作
     if (!m_ui) return;
 
+    //更新旗帜数量标签
+    updateFlags();
+
+    //只翻译View正在显示的区域；View没有设置过显示区域时翻译整个棋盘
+    const QRect bounds(0, 0, board().getCols(), board().getRows());
+    sendRegion(m_hasViewport ? m_viewport.intersected(bounds) : bounds);
+}
+
+//onCellsChanged槽的实现
+void GameViewModel::onCellsChanged(const QVector<int> &) {
+    //信号中的格子与Board记录的本次改变相同，直接使用后者，与异步模式共用同一段处理逻辑
+    applyCellChanges(m_model.board().getChangedCells());
+}
+
+//scheduleFrame槽的实现
+void GameViewModel::scheduleFrame() {
+    //同一帧内的多次提醒只安排一次；距离上一帧不足一帧间隔时，等到间隔满了再取，保证每帧最多更新一次View
+    if (!m_executor || m_frameTimer.isActive()) return;
+    m_frameTimer.start(std::max(0, kFrameIntervalMs - int(m_sinceFlush.elapsed())));
+}
+
+//flushModelChanges槽的实现
+void GameViewModel::flushModelChanges() {
+    if (!m_executor) return;
+    //工作线程正在执行命令（例如一次很大的连锁翻开）时不等待，下一帧再试，GUI线程始终保持响应
+    if (!m_executor->takeChanges(m_mirror, m_changes)) {
+        m_frameTimer.start(kFrameIntervalMs);
+        return;
+    }
+    m_sinceFlush.restart();
+
+    //与同步模式中信号的顺序相同：新的一局先整体刷新，游戏结束先于格子更新
+    if (m_changes.reset) {
+        onModelChanged();
+        announceNewGame();
+    }
+    if (m_changes.resumed) {
+        onGameResumed();
+    }
+    if (m_changes.gameOver) {
+        onGameOver(m_changes.victory);
+    }
+    if (!m_changes.cells.empty()) {
+        applyCellChanges(m_changes.cells);
+    }
+}
+
+//applyCellChanges的实现
+void GameViewModel::applyCellChanges(const std::vector<int> &cells) {
+    //求解器到下一次提示时只重新检查这些格子附近的数字，这里只记下它们
+    if (!m_solverStale) {
+        const std::size_t cellCount = std::size_t(board().getRows()) * board().getCols();
+        m_solverPendingBits.resize((cellCount + 63) / 64);
+        for (int cell : cells) {
+            std::uint64_t &word = m_solverPendingBits[std::size_t(cell) >> 6];
+            const std::uint64_t bit = std::uint64_t(1) << (cell & 63);
+            if (word & bit) continue;
+            word |= bit;
+            m_solverPending.push_back(cell);
+        }
+        //改变了的格子太多时，从头推理并不比逐个检查慢，也不必再为它们占用内存
+        if (m_solverPending.size() > cellCount / 4) {
+            m_solverStale = true;
+            clearSolverPending();
+        }
+    }
+
+    if (!m_ui) return;
+
+    updateFlags();
+
+    //首次翻开刚刚布了雷：要求不需要猜、生成器却没能找到这样的布局时，告诉玩家这一局可能需要猜
+    if (!m_minesLaid && board().getGameState() != GameState::Ready) {
+        m_minesLaid = true;
+        if (board().getGameState() == GameState::Playing && board().getFirstClickPolicy() == FirstClickPolicy::NoGuess
+            && !board().isLayoutCertified()) {
+            m_ui->updateStatusLabel("No guess-free layout was found; this board may need guessing.");
+        }
+    }
+
+    //只翻译本次操作改变了的格子，cells中的元素是行优先的一维编号
+    //不在View显示区域内的格子直接跳过，等它们滚动进视野时由setViewport补发
+    {
+        MINESWEEPER_PROFILE_SCOPE(ProfileZone::Translate);  //只计翻译本身，交给View之后的耗时计入ApplyView
+        const int cols = board().getCols();
+        m_updateBuffer.clear();
+        m_updateBuffer.reserve(qsizetype(cells.size()));
+        for (int cell : cells) {
+            const int row = cell / cols;
+            const int col = cell % cols;
+            if (isInViewport(row, col)) {
+                m_updateBuffer.append(translateCell(row, col));
+            }
+        }
+    }
+    if (m_updateBuffer.isEmpty()) return;
+    MINESWEEPER_PROFILE_COUNT(ProfileCounter::UpdatesEmitted, m_updateBuffer.size());
+    //一次操作（哪怕是一次翻开上百万个格子的连锁反应）只调用一次UI接口
+    m_ui->onCellsUpdated(std::span<const CellUpdateInfo>(m_updateBuffer.constData(), m_updateBuffer.size()));
+}
+
+//syncSolver的实现
+void GameViewModel::syncSolver() {
+    if (m_solverStale) {
+        m_solver.reset(board());
+        m_solverStale = false;
+    } else if (!m_solverPending.empty()) {
+        m_solver.update(board(), m_solverPending);
+    }
+    clearSolverPending();
+}
+
+//clearSolverPending的实现
+void GameViewModel::clearSolverPending() {
+    for (int cell : m_solverPending) m_solverPendingBits[std::size_t(cell) >> 6] = 0;
+    m_solverPending.clear();
+}
+
+//sendRegion的实现
+void GameViewModel::sendRegion(const QRect &cells) {
+    //遍历区域中的每一个格子，将其状态“翻译”成UI更新指令，先全部放入缓冲区
+    m_updateBuffer.clear();
+    if (cells.isEmpty()) return;
+    {
+        MINESWEEPER_PROFILE_SCOPE(ProfileZone::Translate);
+        m_updateBuffer.reserve(cells.width() * cells.height());
+        for (int r = cells.top(); r <= cells.bottom(); ++r) {
+            for (int c = cells.left(); c <= cells.right(); ++c) {
+                m_updateBuffer.append(translateCell(r, c));
+            }
+        }
+    }
+    MINESWEEPER_PROFILE_COUNT(ProfileCounter::UpdatesEmitted, m_updateBuffer.size());
+    //整块区域的更新指令一次性发送给UI
+    m_ui->onCellsUpdated(std::span<const CellUpdateInfo>(m_updateBuffer.constData(), m_updateBuffer.size()));
+}
+
+//isInViewport的实现
+bool GameViewModel::isInViewport(int row, int col) const {
+    return !m_hasViewport || m_viewport.contains(col, row);
+}
+
+//updateFlags的实现
+void GameViewModel::updateFlags() {
     //从Model获取摘要信息（剩余旗帜数）
-    const int flags = m_model.getMineCount() - m_model.getFlagCount();
+    const int flags = board().getMineCount() - board().getFlagCount();
     //通过UI接口更新对应的标签
     m_ui->updateFlagsLabel(flags);
+}
 
-    //遍历Model中的每一个格子，将其状态“翻译”成UI更新指令
-    for (int r = 0; r < m_model.getRows(); ++r) {
-        for (int c = 0; c < m_model.getCols(); ++c) {
-            //从Model获取格子数据
-            const Cell& cell = m_model.getCell(r, c);
-
-            //创建一个DTO对象来打包所有UI更新信息，先为其设置一个默认值（未翻开的灰色格子）
-            CellUpdateInfo info{r, c, "", "background-color: #c0c0c0;", true};
-
-            //根据Model的状态，决定格子的具体外观（ViewModel的“翻译”工作）
-            if (m_model.getGameState() == GameState::Lost && cell.isMine) {
-                info.text = "💣";
-                info.styleSheet = "background-color: red;";
-            } else if (cell.isFlagged) {
-                info.text = "🚩";
-            } else if (cell.isRevealed) {
-                info.enabled = false;  //已翻开的格子不可再点击
-                info.styleSheet = "background-color: #e0e0e0; border: 1px solid #808080;";
-                if (cell.adjacentMines > 0) {
-                    info.text = QString::number(cell.adjacentMines);
-                    //根据数字设置不同的颜色
-                    switch (cell.adjacentMines) {
-                        case 1: info.styleSheet += "color: blue;"; break;
-                        case 2: info.styleSheet += "color: green;"; break;
-                        case 3: info.styleSheet += "color: red;"; break;
-                        case 4: info.styleSheet += "color: darkblue;"; break;
-                        case 5: info.styleSheet += "color: brown;"; break;
-                        default: info.styleSheet += "color: black;"; break;
-                    }
-                }
-            }
-            //为每个格子都通过UI接口发送一个更新指令
-            m_ui->onCellUpdated(info);
+//visualStyle的实现
+const CellVisualStyle& GameViewModel::visualStyle(CellVisual visual) {
+    //外观表只在第一次使用时构建一次，之后所有格子更新都只是查表
+    //表中的QString在被复制进CellUpdateInfo时只会增加引用计数（隐式共享），不会分配新的内存
+    static const std::array<CellVisualStyle, CellVisualCount> table = [] {
+        std::array<CellVisualStyle, CellVisualCount> styles;
+        styles[int(CellVisual::Hidden)] = {QString(), "background-color: #c0c0c0;", true};
+        styles[int(CellVisual::Flagged)] = {"🚩", "background-color: #c0c0c0;", true};
+        styles[int(CellVisual::Mine)] = {"💣", "background-color: red;", true};
+
+        //已翻开的格子不可再点击，数字格根据数字设置不同的颜色
+        const QString revealed = "background-color: #e0e0e0; border: 1px solid #808080;";
+        const char *numberColors[] = {"blue", "green", "red", "darkblue", "brown", "black", "black", "black"};
+        styles[int(CellVisual::Revealed0)] = {QString(), revealed, false};
+        for (int n = 1; n <= 8; ++n) {
+            styles[int(CellVisual::Revealed0) + n] = {QString::number(n), revealed + "color: " + numberColors[n - 1] + ";", false};
         }
+        return styles;
+    }();
+    return table[static_cast<int>(visual)];
+}
+
+//translateCell的实现
+CellUpdateInfo GameViewModel::translateCell(int row, int col) const {
+    //从Model获取格子数据
+    const Cell cell = board().getCell(row, col);
+
+    //根据Model的状态，决定格子处于哪种外观状态（ViewModel的“翻译”工作）
+    CellVisual visual = CellVisual::Hidden;  //默认是未翻开的灰色格子
+    if (board().getGameState() == GameState::Lost && cell.isMine) {
+        visual = CellVisual::Mine;
+    } else if (cell.isFlagged) {
+        visual = CellVisual::Flagged;
+    } else if (cell.isRevealed) {
+        visual = static_cast<CellVisual>(static_cast<int>(CellVisual::Revealed0) + cell.adjacentMines);
     }
+
+    //文字、样式和是否可点击都直接从外观表中取得，整个过程不分配任何内存
+    const CellVisualStyle &style = visualStyle(visual);
+    return CellUpdateInfo{row, col, style.text, style.styleSheet, style.enabled, visual};
 }
 
 //onGameOver槽的实现
@@ -110,4 +397,10 @@ void GameViewModel::onGameOver(bool victory) {
         m_ui->updateStatusLabel("You Lost! :(");
         m_ui->onShowGameOverDialog("Boom! You hit a mine.");
     }
+}
+
+//onGameResumed槽的实现
+void GameViewModel::onGameResumed() {
+    if (!m_ui) return;
+    m_ui->updateStatusLabel("Game in progress...");
 }
\ No newline at end of file
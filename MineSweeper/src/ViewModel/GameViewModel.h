@@ -9,9 +9,24 @@ ViewModel是MVVM架构的“中枢”，是Model和View之间的桥梁和协调
 
 #include <QObject>  //包含Qt的核心基类，以使用信号/槽机制来监听Model
 #include <QSize>  //包含QSize，这是Model和View之间传递棋盘尺寸的数据类型
+#include <QRect>  //包含QRect，用于记录View当前显示的格子区域
+#include <QTimer>  //包含定时器，用于异步模式下把改变按帧合并后再交给View
+#include <QElapsedTimer>  //包含计时器，用于计算距离上一帧的时间
+#include <memory>  //包含std::unique_ptr
+#include <vector>  //包含std::vector，用于记录求解器还没有看到的格子
 #include "../Model/GameModel.h"  //ViewModel需要知道Model的公共接口和信号定义才能与之交互
+#include "../Core/Solver.h"  //ViewModel使用求解器为玩家提供提示
+#include "ModelExecutor.h"  //异步模式下在工作线程中运行Model
 #include "../common/IGameCommands.h"  //ViewModel需要实现IGameCommands接口，以响应来自View的请求
 #include "../common/IGameUI.h"  //ViewModel需要通过IGameUI接口向View发送指令
+#include <array>  //包含std::array，用于存放固定大小的外观表
+
+//一种外观状态对应的全部显示信息，是外观表中的一项
+struct CellVisualStyle {
+    QString text;  //格子上显示的文本
+    QString styleSheet;  //格子的样式表
+    bool enabled;  //格子是否可点击
+};
 
 //GameViewModel类是连接Model和View的桥梁
 //它从QObject继承，以使用信号/槽机制连接到Model
@@ -28,23 +43,89 @@ public:
     //参数是一个指向IGameUI接口的指针，这使得ViewModel只知道它在和一个“UI契约”对话，而不知道具体的UI类是什么（如MainWindow）
     void setUI(IGameUI* ui);
 
+    //设置是否在工作线程中运行Model（默认不使用，所有操作都在调用者线程中同步完成）
+    //异步模式下命令被提交到工作线程按顺序执行，开始新的一局会丢弃之前尚未执行的命令；
+    //结果攒成一批，每帧（约16毫秒）最多交给View一次，ViewModel读取的是每帧同步一次的镜像棋盘，不会与工作线程争用Model
+    void setAsynchronous(bool enabled);
+
+    //返回某种外观状态对应的显示信息，表在第一次调用时构建，之后永远不变
+    //所有CellUpdateInfo中的text和styleSheet都与这张表中的字符串共享同一份数据
+    static const CellVisualStyle& visualStyle(CellVisual visual);
+
     //--- IGameCommands 接口的实现声明 ---
     //override关键字告诉编译器，这些函数意在覆盖基类（IGameCommands）中的纯虚函数
-    void startNewGame(int rows, int cols, int mines) override;
+    void startNewGame(int rows, int cols, int mines, FirstClickPolicy policy = FirstClickPolicy::SafeCell) override;
     void revealCellRequest(int row, int col) override;
     void toggleFlagRequest(int row, int col) override;
+    void chordCellRequest(int row, int col) override;
+    void undoRequest() override;
+    void redoRequest() override;
+    void hintRequest() override;
+    void setViewport(const QRect &cells) override;
 
 private slots:
     //--- 槽函数 ---
     //这些是私有的槽函数，专门用于响应来自GameModel的信号
     //当GameModel发出相应的信号时，Qt的信号/槽机制会自动调用这些函数
-    void onModelChanged();  //连接到GameModel::modelChanged()信号
+    void onModelChanged();  //连接到GameModel::modelChanged()信号，重新翻译整个棋盘
+    void onCellsChanged(const QVector<int> &cells);  //连接到GameModel::cellsChanged()信号，只翻译被改变的格子
     void onGameOver(bool victory);  //连接到GameModel::gameOver(bool)信号
+    void onGameResumed();  //连接到GameModel::gameResumed()信号
+    void scheduleFrame();  //异步模式下工作线程攒下了新的改变，安排在下一帧取走
+    void flushModelChanges();  //异步模式下每帧一次：把工作线程攒下的改变同步到镜像棋盘并交给View
 
 private:
+    //--- 私有辅助函数 ---
+    //ViewModel读取棋盘数据的来源：同步模式下是Model中的棋盘，异步模式下是GUI线程自己的镜像棋盘
+    const Board &board() const { return m_executor ? m_mirror : m_model.board(); }
+
+    //建立或断开Model信号到本对象槽函数的连接（异步模式下Model的信号改由ModelExecutor在工作线程中记录）
+    void connectModel();
+    void disconnectModel();
+
+    //新的一局开始后通知UI：更新状态文字和棋盘尺寸
+    void announceNewGame();
+
+    //一次或一批操作改变了cells中的格子：记下求解器还没有看到的格子，并把View显示区域内的格子翻译后交给UI
+    void applyCellChanges(const std::vector<int> &cells);
+
+    //提示之前让求解器跟上棋盘：新的一局（或改变太多时）从头推理，否则只把上次提示之后改变过的格子交给它
+    void syncSolver();
+
+    //清空还没有交给求解器的格子
+    void clearSolverPending();
+
+    //把Model中一个格子的状态“翻译”成UI能直接使用的更新指令
+    CellUpdateInfo translateCell(int row, int col) const;
+
+    //翻译一块矩形区域内的所有格子，并作为一批发送给UI
+    void sendRegion(const QRect &cells);
+
+    //判断格子是否在View当前显示的区域内
+    bool isInViewport(int row, int col) const;
+
+    //从Model获取剩余旗帜数，并通知UI更新旗帜标签
+    void updateFlags();
+
     //--- 私有成员变量 ---
     GameModel& m_model;  //存储对注入的Model的引用，使用引用可以确保总有一个有效的Model对象
     IGameUI* m_ui = nullptr;  //存储一个指向UI接口的指针，初始化为nullptr以确保安全
+    //求解器只在玩家请求提示时才推理，平时（GUI线程的每一帧）只记下改变过的格子，超大棋盘上的操作不会因此变慢
+    Solver m_solver;  //用于回答提示请求的求解器
+    bool m_solverStale = true;  //求解器需要从头推理（新的一局，或者攒下的改变太多），此时不记录改变
+    std::vector<int> m_solverPending;  //上次提示之后改变过的格子（行优先编号，不重复）
+    std::vector<std::uint64_t> m_solverPendingBits;  //每个格子一位，表示是否已在m_solverPending中，用于去重
+    QRect m_viewport;  //View当前显示的格子区域
+    bool m_hasViewport = false;  //View是否设置过显示区域，没有设置过时整个棋盘都需要更新
+    bool m_minesLaid = false;  //本局是否已经布雷，用于在首次翻开之后检查一次布局是否经过验证
+    QVector<CellUpdateInfo> m_updateBuffer;  //打包发送给UI的格子更新指令，作为成员复用以避免每次操作都重新分配内存
+
+    //--- 异步模式 ---
+    std::unique_ptr<ModelExecutor> m_executor;  //在工作线程中运行Model，为空表示同步模式
+    Board m_mirror;  //Model中棋盘的镜像，每帧同步一次，只在GUI线程中读取
+    ModelExecutor::Changes m_changes;  //每帧取走的改变，作为成员复用
+    QTimer m_frameTimer;  //单次定时器，到下一帧时触发flushModelChanges
+    QElapsedTimer m_sinceFlush;  //距离上一次把改变交给View的时间
 };
 
 #endif //MINESWEEPER_GAMEVIEWMODEL_H
\ No newline at end of file
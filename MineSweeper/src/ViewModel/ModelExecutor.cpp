@@ -0,0 +1,132 @@
+#include "ModelExecutor.h"
+#include <QMutexLocker>  //包含互斥锁的RAII封装
+
+//ModelExecutor的构造函数实现
+ModelExecutor::ModelExecutor(GameModel &model, QObject *parent)
+    : QObject(parent), m_model(model), m_guiThread(model.thread()) {
+    m_dirty.assign(std::size_t(m_model.getRows()) * m_model.getCols(), 0);
+
+    //Model的信号在工作线程中发出，使用DirectConnection在发出的线程中直接记录，不经过任何事件队列
+    connect(&m_model, &GameModel::modelChanged, this, [this]() { recordReset(); }, Qt::DirectConnection);
+    connect(&m_model, &GameModel::cellsChanged, this, [this](const QVector<int> &cells) { recordCells(cells); },
+            Qt::DirectConnection);
+    connect(&m_model, &GameModel::gameOver, this, [this](bool victory) { recordGameOver(victory); }, Qt::DirectConnection);
+    connect(&m_model, &GameModel::gameResumed, this, [this]() { recordResumed(); }, Qt::DirectConnection);
+
+    m_model.setGeneratorCancelFlag(&m_cancelGeneration);
+    m_model.moveToThread(&m_thread);
+    m_thread.start();
+}
+
+//ModelExecutor的析构函数实现
+ModelExecutor::~ModelExecutor() {
+    //正在生成的布局不必等它生成完
+    m_cancelGeneration = true;
+    //这条命令排在所有已提交的命令之后，执行到它时其他命令都已完成；Model只能由它当前所在的线程移走
+    QMetaObject::invokeMethod(&m_model, [this]() {
+        m_model.setGeneratorCancelFlag(nullptr);  //取消标志随ModelExecutor一起销毁
+        m_model.moveToThread(m_guiThread);
+    }, Qt::BlockingQueuedConnection);
+    m_thread.quit();
+    m_thread.wait();
+}
+
+//提交命令的实现
+void ModelExecutor::post(std::function<void(GameModel &)> command) {
+    const quint64 generation = m_generation.load();
+    //投递给Model的事件按投递顺序在工作线程中逐个处理，所以命令的执行顺序与提交顺序相同
+    QMetaObject::invokeMethod(&m_model, [this, generation, command = std::move(command)]() {
+        QMutexLocker locker(&m_mutex);
+        if (generation != m_generation.load()) return;  //提交之后又开始了新的一局，这条命令已经过期
+        command(m_model);
+    }, Qt::QueuedConnection);
+}
+
+//提交新的一局的实现
+void ModelExecutor::postNewGame(std::function<void(GameModel &)> command) {
+    ++m_generation;
+    //此前提交的命令中可能有一次首次翻开正在生成NoGuess布局（大棋盘上需要好几秒），通知它放弃
+    m_cancelGeneration = true;
+    post([this, command = std::move(command)](GameModel &model) {
+        m_cancelGeneration = false;  //执行到这里时被取消的布雷已经结束
+        command(model);
+    });
+}
+
+//等待空闲的实现
+void ModelExecutor::waitForIdle() {
+    //一条空命令排在所有已提交的命令之后，它执行完时其他命令也都已完成
+    QMetaObject::invokeMethod(&m_model, []() {}, Qt::BlockingQueuedConnection);
+}
+
+//取走改变的实现
+bool ModelExecutor::takeChanges(Board &mirror, Changes &changes) {
+    if (!m_mutex.tryLock()) return false;
+
+    const Board &board = m_model.board();
+    changes.reset = m_reset;
+    changes.resumed = m_resumed;
+    changes.gameOver = m_gameOver;
+    changes.victory = m_victory;
+    //新的一局，或者首次点击刚刚布好雷（所有格子的地雷位都变了）时整体复制，其余时候只复制被改变的格子
+    //布雷之前的插旗也只复制被改变的格子，超大棋盘上不会每帧复制整个棋盘
+    if (m_reset || (mirror.getGameState() == GameState::Ready && board.getGameState() != GameState::Ready)) {
+        mirror = board;
+    } else {
+        mirror.syncFrom(board, m_cells);
+    }
+    //两个缓冲区互相交换，稳定状态下不分配内存
+    changes.cells.clear();
+    changes.cells.swap(m_cells);
+    for (int cell : changes.cells) m_dirty[cell] = 0;
+    m_reset = false;
+    m_resumed = false;
+    m_gameOver = false;
+    m_notified = false;
+
+    m_mutex.unlock();
+    return true;
+}
+
+//记录新的一局的实现
+void ModelExecutor::recordReset() {
+    //之前攒下的改变都属于上一局，全部丢弃
+    m_reset = true;
+    m_resumed = false;
+    m_gameOver = false;
+    m_cells.clear();
+    m_dirty.assign(std::size_t(m_model.getRows()) * m_model.getCols(), 0);
+    notify();
+}
+
+//记录被改变的格子的实现
+void ModelExecutor::recordCells(const QVector<int> &cells) {
+    for (int cell : cells) {
+        if (m_dirty[cell]) continue;
+        m_dirty[cell] = 1;
+        m_cells.push_back(cell);
+    }
+    notify();
+}
+
+//记录游戏结束的实现
+void ModelExecutor::recordGameOver(bool victory) {
+    m_gameOver = true;
+    m_victory = victory;
+    notify();
+}
+
+//记录游戏回到进行中的实现
+void ModelExecutor::recordResumed() {
+    //这一批中之前的游戏结束已被撤销，不需要再交给View
+    m_gameOver = false;
+    m_resumed = true;
+    notify();
+}
+
+//notify的实现
+void ModelExecutor::notify() {
+    if (m_notified) return;
+    m_notified = true;
+    emit changesPending();
+}
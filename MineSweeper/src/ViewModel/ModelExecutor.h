@@ -0,0 +1,83 @@
+#ifndef MINESWEEPER_MODELEXECUTOR_H
+#define MINESWEEPER_MODELEXECUTOR_H
+
+/*
+ModelExecutor让GameModel在一个专门的工作线程中运行，GUI线程只负责提交命令和显示结果
+布雷、整盘重算、上百万个格子的连锁翻开都在工作线程中完成，期间窗口照常重绘和响应输入
+
+- 命令按提交的顺序在工作线程中逐个执行；开始新的一局时，此前提交但还没有执行的命令全部作废，不会再作用到新的棋盘上，
+  正在生成的NoGuess布局也会被取消（那次翻开什么也不做），新的一局不必等它生成完
+- 命令执行时Model发出的信号在工作线程中直接记录下来：被改变的格子合并去重，多次操作的结果攒成一批
+- GUI线程在每一帧调用takeChanges把攒下的改变一次性同步到自己的镜像棋盘上；工作线程正在执行命令时立即返回，本帧跳过，GUI线程从不等待
+*/
+
+#include <QObject>  //包含Qt的核心基类
+#include <QMutex>  //包含互斥锁，保护Model和攒下的改变
+#include <QThread>  //包含Qt的线程类，Model在其中运行
+#include <atomic>  //包含std::atomic，用于判断命令是否已经过期
+#include <functional>  //包含std::function，用于保存提交的命令
+#include <vector>  //包含std::vector
+#include "../Model/GameModel.h"
+
+class ModelExecutor : public QObject {
+    Q_OBJECT
+
+public:
+    //一批攒下的改变
+    struct Changes {
+        bool reset = false;  //期间开始了新的一局（镜像棋盘已被整体替换，需要全部刷新）
+        bool resumed = false;  //期间撤销了结束游戏的那一步（之后又结束时gameOver也为true，应先处理resumed）
+        bool gameOver = false;  //期间游戏结束了
+        bool victory = false;  //游戏结束时是否胜利
+        std::vector<int> cells;  //期间被改变的全部格子（行优先编号，不重复）
+    };
+
+    //把model移到新建的工作线程中并启动线程；此后只能通过post/postNewGame操作model
+    explicit ModelExecutor(GameModel &model, QObject *parent = nullptr);
+
+    //等待已提交的命令全部执行完毕，把model移回GUI线程，然后停止工作线程
+    ~ModelExecutor() override;
+
+    //提交一条命令，它会在工作线程中按提交顺序执行；如果执行之前又开始了新的一局，这条命令会被丢弃
+    void post(std::function<void(GameModel &)> command);
+
+    //提交开始新的一局的命令：此前提交但还没有执行的命令全部作废，正在执行的布雷被取消
+    void postNewGame(std::function<void(GameModel &)> command);
+
+    //阻塞等待，直到此前提交的命令全部执行完毕
+    void waitForIdle();
+
+    //把攒下的改变同步到mirror并写入changes（changes中原有的内容被清空），返回true
+    //工作线程正在执行命令时什么也不做并返回false，调用者应在下一帧重试
+    bool takeChanges(Board &mirror, Changes &changes);
+
+signals:
+    //上一次takeChanges之后第一次出现新的改变时发出（在工作线程中发出），提醒GUI线程在下一帧取走
+    void changesPending();
+
+private:
+    //以下函数在工作线程中执行命令的过程中被调用，此时m_mutex已被锁定
+    void recordReset();
+    void recordCells(const QVector<int> &cells);
+    void recordGameOver(bool victory);
+    void recordResumed();
+    void notify();
+
+    GameModel &m_model;
+    QThread m_thread;  //Model所在的工作线程
+    QThread *m_guiThread;  //创建者所在的线程，析构时Model被移回这里
+    std::atomic<quint64> m_generation{0};  //开始新的一局的次数，命令执行时与提交时不同就说明已经过期
+    std::atomic<bool> m_cancelGeneration{false};  //交给Model的布雷取消标志，开始新的一局时置位，新的一局开始执行时清除
+
+    //--- 以下成员由m_mutex保护 ---
+    QMutex m_mutex;  //命令执行期间一直锁定，takeChanges只在命令之间同步镜像
+    bool m_reset = false;
+    bool m_resumed = false;
+    bool m_gameOver = false;
+    bool m_victory = false;
+    bool m_notified = false;  //是否已经发出过changesPending而GUI线程还没有取走
+    std::vector<int> m_cells;  //攒下的被改变的格子
+    std::vector<quint8> m_dirty;  //每个格子是否已在m_cells中，用于去重
+};
+
+#endif //MINESWEEPER_MODELEXECUTOR_H
@@ -5,6 +5,9 @@ main函数是应用程序的入口点
 */
 
 #include <QApplication>  //包含Qt应用程序类，管理GUI应用程序的控制流和主要设置
+#include <QRandomGenerator>  //包含Qt的随机数生成器，用于为布局池生成种子
+#include "Core/BoardPool.h"
+#include "Core/Profiler.h"
 #include "View/MainWindow.h"
 #include "Model/GameModel.h"
 #include "ViewModel/GameViewModel.h"
@@ -14,13 +17,26 @@ int main(int argc, char *argv[]) {
     //1.创建QApplication实例，这是所有Qt GUI应用程序的第一步，它负责事件循环、窗口管理等
     QApplication application(argc, argv);
 
+    //设置环境变量MINESWEEPER_TRACE为文件路径时，记录热点路径的跟踪事件，退出时写成Chrome的trace-event JSON
+    const QString tracePath = qEnvironmentVariable("MINESWEEPER_TRACE");
+    if (!tracePath.isEmpty()) {
+        Profiler::instance().setTracing(true);
+    }
+
     //--- 组合根 (Composition Root) ---
     //在这里，我们创建并组装应用程序的所有部分，这段代码是整个架构的“粘合剂”
 
     //2.创建各个层的具体实例
     //按照依赖关系，先创建最核心的Model，然后是ViewModel，最后是View
+    //布局池用一个后台线程为新游戏对话框中选择的设置（包括不需要猜的棋盘和超大棋盘）预先生成布局，首次点击时直接取用，耗时的布雷模式也不会让界面卡顿
+    //玩家改变设置时，池会取消还没生成完的旧布局
+    //它必须比使用它的Model活得更久，所以最先创建
+    BoardPool boardPool(QRandomGenerator::global()->generate64());
     GameModel model;  //创建Model实例
+    model.setBoardPool(&boardPool);
+    model.setGeneratorThreads(0);  //池里没有现成的布局时，首次点击在工作线程中用全部硬件线程生成不需要猜的布局，开始新的一局会取消它
     GameViewModel viewModel(model);  //创建ViewModel实例，并将Model的引用“注入”到其构造函数中
+    viewModel.setAsynchronous(true);  //Model在工作线程中运行，很大的连锁翻开也不会让窗口卡住
     MainWindow window;  //创建View（MainWindow）实例，此时它是一个孤立的窗口
 
     //3.执行依赖注入，将各个层通过接口连接起来
@@ -39,5 +55,9 @@ int main(int argc, char *argv[]) {
 
     //5.启动Qt的事件循环
     //程序将在这里等待并处理事件（如鼠标点击、键盘输入等），直到应用程序退出，`application.exec()` 的返回值是退出码
-    return application.exec();
+    const int result = application.exec();
+    if (!tracePath.isEmpty() && !Profiler::instance().writeChromeTrace(tracePath.toStdString())) {
+        qWarning("cannot write trace to %s", qPrintable(tracePath));
+    }
+    return result;
 }
\ No newline at end of file
@@ -0,0 +1,502 @@
+#include <QTest>  //包含Qt测试框架，QBENCHMARK宏也由它提供
+#include <QElapsedTimer>  //包含高精度计时器，只测量每次迭代中被测的那部分操作
+#include <QTemporaryDir>  //存档的基准测试把文件写在临时目录里
+#include "BenchReport.h"  //包含基准测试共用的JSON结果输出
+#include "../src/Model/GameModel.h"  //包含被测量的GameModel类
+#include "../src/Core/BitPlanes.h"  //包含与逐格访问对比的位平面表示
+#include "../src/Core/Solver.h"  //包含按提示对局时使用的求解器
+
+//性能基准测试类：与TestGameModel不同，这里不验证正确性，只测量关键操作的耗时
+//运行方式：直接执行BenchModel，QtTest会为每个数据行打印每次迭代的平均耗时（可加 -median 5 等参数获得更稳定的结果）
+//设置环境变量MINESWEEPER_BENCH_JSON为文件路径时，全部结果还会以JSON格式写入该文件（见BenchReport.h）
+//只想测量某一项时，可以像其他QtTest程序一样指定函数名和数据行，例如 BenchModel benchStartGame "9x9 15%"
+class BenchGameModel : public QObject {
+    Q_OBJECT
+
+private slots:
+    void cleanupTestCase();  //所有测量完成后写出JSON结果
+
+    void benchStartGame_data();  //为开局的基准测试提供不同规模和密度的棋盘
+    void benchStartGame();       //测量开局（分配并清空棋盘）的耗时
+
+    void benchPlaceMines_data();  //为布雷的基准测试提供不同规模和密度的棋盘
+    void benchPlaceMines();       //测量首次点击时布雷和计算周围地雷数的耗时（密集棋盘走calculateAdjacentMines的批量路径）
+
+    void benchFirstClickCascade_data();  //为首次点击连锁翻开的基准测试提供不同规模的棋盘
+    void benchFirstClickCascade();       //测量首次点击引发的整片连锁翻开的耗时
+
+    void benchFlagToggle_data();  //为插旗的基准测试提供不同规模和密度的棋盘
+    void benchFlagToggle();       //测量插旗/取消插旗的耗时
+
+    void benchRandomPlay_data();  //为随机对局的基准测试提供不同规模和密度的棋盘
+    void benchRandomPlay();       //测量按随机顺序下完一整局（从开局直到胜利）的耗时
+
+    void benchSaveLoad_data();  //为存档的基准测试提供不同规模的棋盘
+    void benchSaveLoad();       //测量读档，以及改动一个格子后再次保存的耗时（两者都应与棋盘大小无关）
+
+    void benchSolveWithHints_data();  //为按提示对局的基准测试提供不同的首次点击策略
+    void benchSolveWithHints();       //测量在高级棋盘上完全按求解器的提示下完若干局的耗时（NoGuess还包括生成不需要猜的布局）
+
+    void benchBitPlanes_data();  //为整盘查询的基准测试提供不同规模的棋盘和查询种类
+    void benchBitPlanes();       //对同一个下到一半的棋盘，分别用逐格访问Cell和位平面完成整盘查询，比较两者的耗时
+
+private:
+    //一个数据行的测量结果：QBENCHMARK可能会多次执行循环体，所有执行都计入
+    struct Sample {
+        qint64 nanoseconds = 0;  //被测操作的总耗时（不含准备工作）
+        qint64 iterations = 0;  //执行的迭代次数
+        qint64 operations = 0;  //全部迭代中被测操作处理的单位数（格子、地雷、旗帜或点击）
+    };
+
+    //为数据驱动的基准测试添加行数、列数和地雷数三列，以及全部规模与密度组合的数据行
+    static void addBoardRows();
+
+    //把当前数据行的测量结果加入m_results；unit说明operations的单位
+    void addResult(const char *benchmark, int rows, int cols, int mines, const char *unit, const Sample &sample);
+
+    QJsonArray m_results;  //全部测量结果，在cleanupTestCase中写出
+};
+
+namespace {
+//固定种子，保证每次运行测量的都是同样的棋盘
+constexpr quint64 kSeed = 20240101;
+
+//插旗测量中最多使用的格子数
+constexpr int kMaxFlagCells = 4096;
+
+//测量的棋盘规模：初级、高级、中等、大、超大
+constexpr int kSizes[][2] = {{9, 9}, {16, 30}, {128, 128}, {1024, 1024}, {4096, 4096}};
+
+//测量的地雷密度（百分比）：与Board.cpp中的kDenseBoardRatio一致，20%及以上走整盘重算的路径，以下走逐颗增量的路径
+constexpr int kDensities[] = {5, 15, 25};
+
+//返回全部格子编号的一个随机排列（Fisher-Yates洗牌，固定种子）
+QVector<int> shuffledCells(int cellCount) {
+    QVector<int> order(cellCount);
+    for (int cell = 0; cell < cellCount; ++cell) order[cell] = cell;
+    Board::RandomEngine rng(kSeed);
+    for (int i = cellCount - 1; i > 0; --i) {
+        std::swap(order[i], order[int(boundedRandom(rng, std::uint32_t(i + 1)))]);
+    }
+    return order;
+}
+
+//--- 整盘查询的逐格版本：通过getCell逐个访问Cell，是位平面版本的比较基准 ---
+
+//Cell网格上某个格子周围的地雷数（不使用Board预先算好的数字，与位平面的neighborCounts做同样的事）
+int gridMinesAround(const Board &board, int row, int col) {
+    int count = 0;
+    for (int dr = -1; dr <= 1; ++dr) {
+        for (int dc = -1; dc <= 1; ++dc) {
+            const int r = row + dr, c = col + dc;
+            if ((dr || dc) && r >= 0 && r < board.getRows() && c >= 0 && c < board.getCols()) {
+                count += board.getCell(r, c).isMine;
+            }
+        }
+    }
+    return count;
+}
+
+//在Cell网格上执行一种查询，返回结果的大小（防止被优化掉，也用来核对两种版本的结果）
+qint64 gridQuery(const Board &board, const QString &query, std::vector<int> &cells, std::vector<std::uint8_t> &counts) {
+    const int rows = board.getRows(), cols = board.getCols();
+    qint64 result = 0;
+    cells.clear();
+    if (query == "neighborCounts") counts.assign(std::size_t(rows) * cols, 0);
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < cols; ++c) {
+            const Cell cell = board.getCell(r, c);
+            if (query == "winCheck") {
+                if (!cell.isMine && !cell.isRevealed) return 0;
+            } else if (query == "flagsOnMines") {
+                result += cell.isMine && cell.isFlagged;
+            } else if (query == "neighborCounts") {
+                counts[std::size_t(r) * cols + c] = std::uint8_t(gridMinesAround(board, r, c));
+            } else if (query == "hiddenMines") {
+                if (cell.isMine && !cell.isRevealed) cells.push_back(r * cols + c);
+            } else if (!cell.isRevealed && !cell.isFlagged) {  //frontier
+                bool nearNumber = false;
+                for (int dr = -1; dr <= 1 && !nearNumber; ++dr) {
+                    for (int dc = -1; dc <= 1; ++dc) {
+                        const int nr = r + dr, nc = c + dc;
+                        if ((dr || dc) && nr >= 0 && nr < rows && nc >= 0 && nc < cols) {
+                            const Cell neighbor = board.getCell(nr, nc);
+                            if (neighbor.isRevealed && !neighbor.isMine) {
+                                nearNumber = true;
+                                break;
+                            }
+                        }
+                    }
+                }
+                if (nearNumber) cells.push_back(r * cols + c);
+            }
+        }
+    }
+    if (query == "winCheck") return 1;
+    if (query == "neighborCounts") return qint64(counts.size());
+    return query == "flagsOnMines" ? result : qint64(cells.size());
+}
+
+//用位平面执行同一种查询
+qint64 planesQuery(const BitPlanes &planes, const QString &query, std::vector<int> &cells, std::vector<std::uint8_t> &counts) {
+    if (query == "winCheck") return planes.allSafeRevealed() ? 1 : 0;
+    if (query == "flagsOnMines") return planes.countFlagsOnMines();
+    if (query == "neighborCounts") {
+        planes.neighborCounts(BitPlanes::Plane::Mine, counts);
+        return qint64(counts.size());
+    }
+    if (query == "hiddenMines") planes.hiddenMines(cells);
+    else planes.frontier(cells);
+    return qint64(cells.size());
+}
+}
+
+//写出JSON结果的实现
+void BenchGameModel::cleanupTestCase() {
+    writeBenchReport("BenchModel", m_results);
+}
+
+//添加数据行的实现
+void BenchGameModel::addBoardRows() {
+    QTest::addColumn<int>("rows");
+    QTest::addColumn<int>("cols");
+    QTest::addColumn<int>("mines");
+
+    for (const auto &size : kSizes) {
+        for (int density : kDensities) {
+            const int mines = int(qint64(size[0]) * size[1] * density / 100);
+            QTest::addRow("%dx%d %d%%", size[0], size[1], density) << size[0] << size[1] << mines;
+        }
+    }
+}
+
+//记录测量结果的实现
+void BenchGameModel::addResult(const char *benchmark, int rows, int cols, int mines, const char *unit, const Sample &sample) {
+    if (sample.iterations == 0) return;
+
+    QJsonObject result;
+    result["benchmark"] = QString::fromLatin1(benchmark);
+    result["tag"] = QString::fromLatin1(QTest::currentDataTag());
+    result["rows"] = rows;
+    result["cols"] = cols;
+    result["mines"] = mines;
+    result["density"] = double(mines) / (double(rows) * cols);
+    result["iterations"] = sample.iterations;
+    result["nsPerIteration"] = double(sample.nanoseconds) / double(sample.iterations);
+    result["unit"] = QString::fromLatin1(unit);
+    result["unitsPerIteration"] = double(sample.operations) / double(sample.iterations);
+    result["nsPerUnit"] = sample.operations > 0 ? double(sample.nanoseconds) / double(sample.operations) : 0.0;
+    m_results.append(result);
+}
+
+void BenchGameModel::benchStartGame_data() {
+    addBoardRows();
+}
+
+//测量开局：只计入startGame本身，单位是格子
+void BenchGameModel::benchStartGame() {
+    QFETCH(int, rows);
+    QFETCH(int, cols);
+    QFETCH(int, mines);
+
+    GameModel model;
+    Sample sample;
+    QElapsedTimer timer;
+    QBENCHMARK {
+        timer.start();
+        model.startGame(rows, cols, mines, kSeed);
+        sample.nanoseconds += timer.nsecsElapsed();
+        ++sample.iterations;
+        sample.operations += qint64(rows) * cols;
+    }
+    addResult("startGame", rows, cols, mines, "cell", sample);
+}
+
+void BenchGameModel::benchPlaceMines_data() {
+    addBoardRows();
+}
+
+//测量布雷：每次迭代重新开局（不计时），然后只布雷不翻开，单位是地雷
+//布雷包括计算周围地雷数：稀疏棋盘在放置每颗地雷时增量计算，密集棋盘放完后由calculateAdjacentMines整盘重算
+void BenchGameModel::benchPlaceMines() {
+    QFETCH(int, rows);
+    QFETCH(int, cols);
+    QFETCH(int, mines);
+
+    Board board;
+    Sample sample;
+    QElapsedTimer timer;
+    QBENCHMARK {
+        board.startGame(rows, cols, mines, kSeed);
+        timer.start();
+        board.layMines(rows / 2, cols / 2);
+        sample.nanoseconds += timer.nsecsElapsed();
+        ++sample.iterations;
+        sample.operations += board.getMineCount();
+    }
+    addResult("placeMines", rows, cols, mines, "mine", sample);
+}
+
+//数据行：全部规模与密度的组合，再加上没有地雷的超大棋盘（一次点击翻开整个棋盘）
+void BenchGameModel::benchFirstClickCascade_data() {
+    addBoardRows();
+
+    QTest::newRow("1000x1000, no mines") << 1000 << 1000 << 0;  //一次点击连锁翻开100万个格子
+    QTest::newRow("4000x4000, no mines") << 4000 << 4000 << 0;  //一次点击连锁翻开1600万个格子
+    QTest::newRow("4000x4000, 1% mines") << 4000 << 4000 << 160000;  //稀疏棋盘，旧的递归实现在这里会栈溢出
+}
+
+//测量首次点击：每次迭代重新开局（不计时，否则第二次迭代时棋盘已全部翻开），计入布雷和连锁翻开，单位是翻开的格子
+void BenchGameModel::benchFirstClickCascade() {
+    QFETCH(int, rows);
+    QFETCH(int, cols);
+    QFETCH(int, mines);
+
+    GameModel model;
+    Sample sample;
+    QElapsedTimer timer;
+    QBENCHMARK {
+        model.startGame(rows, cols, mines, kSeed);
+        timer.start();
+        model.revealCell(rows / 2, cols / 2);
+        sample.nanoseconds += timer.nsecsElapsed();
+        ++sample.iterations;
+        sample.operations += model.getRevealedCount();
+    }
+    addResult("firstClickCascade", rows, cols, mines, "revealedCell", sample);
+}
+
+void BenchGameModel::benchFlagToggle_data() {
+    addBoardRows();
+}
+
+//测量插旗：首次点击之后，在最多kMaxFlagCells个未翻开的格子上各插一次旗再取消，单位是一次插旗或取消
+//每次迭代结束时旗帜都被取消，棋盘回到原样，所以准备工作只需要做一次
+void BenchGameModel::benchFlagToggle() {
+    QFETCH(int, rows);
+    QFETCH(int, cols);
+    QFETCH(int, mines);
+
+    GameModel model;
+    model.startGame(rows, cols, mines, kSeed);
+    model.revealCell(rows / 2, cols / 2);
+    QVector<int> cells;
+    for (int cell = 0; cell < rows * cols && cells.size() < kMaxFlagCells; ++cell) {
+        if (!model.getCell(cell / cols, cell % cols).isRevealed) cells.append(cell);
+    }
+
+    Sample sample;
+    QElapsedTimer timer;
+    QBENCHMARK {
+        timer.start();
+        for (int cell : cells) model.flagCell(cell / cols, cell % cols);
+        for (int cell : cells) model.flagCell(cell / cols, cell % cols);
+        sample.nanoseconds += timer.nsecsElapsed();
+        ++sample.iterations;
+        sample.operations += 2 * cells.size();
+    }
+    addResult("flagToggle", rows, cols, mines, "toggle", sample);
+}
+
+void BenchGameModel::benchRandomPlay_data() {
+    addBoardRows();
+}
+
+//测量一整局：从开局开始，首次点击棋盘中央，之后按随机顺序逐个处理还没有翻开、没有插旗的格子，直到胜利，单位是点击
+//真正随机地点击几乎总是在两三步之内踩雷，测不到一整局的开销，所以这里的玩家知道答案：遇到地雷插旗，否则翻开
+//这样每一局都会走完布雷、连锁翻开、零散的翻开和插旗直到胜利的全过程；点击顺序使用固定种子，每次迭代下的都是同一盘棋
+void BenchGameModel::benchRandomPlay() {
+    QFETCH(int, rows);
+    QFETCH(int, cols);
+    QFETCH(int, mines);
+
+    const QVector<int> order = shuffledCells(rows * cols);
+    GameModel model;
+    Sample sample;
+    QElapsedTimer timer;
+    QBENCHMARK {
+        timer.start();
+        model.startGame(rows, cols, mines, kSeed);
+        model.revealCell(rows / 2, cols / 2);
+        qint64 clicks = 1;
+        for (int cell : order) {
+            if (model.getGameState() != GameState::Playing) break;
+            const Cell state = model.getCell(cell / cols, cell % cols);
+            if (state.isRevealed || state.isFlagged) continue;
+            if (state.isMine) {
+                model.flagCell(cell / cols, cell % cols);
+            } else {
+                model.revealCell(cell / cols, cell % cols);
+            }
+            ++clicks;
+        }
+        sample.nanoseconds += timer.nsecsElapsed();
+        ++sample.iterations;
+        sample.operations += clicks;
+    }
+    addResult("randomPlay", rows, cols, mines, "click", sample);
+}
+
+void BenchGameModel::benchSaveLoad_data() {
+    QTest::addColumn<int>("rows");
+    QTest::addColumn<int>("cols");
+    QTest::addColumn<int>("mines");
+
+    //存档的耗时与地雷密度无关，只使用15%一种密度
+    for (const auto &size : kSizes) {
+        const int mines = int(qint64(size[0]) * size[1] * 15 / 100);
+        QTest::addRow("%dx%d", size[0], size[1]) << size[0] << size[1] << mines;
+    }
+}
+
+//测量存档：先开局、翻开中央并第一次保存（不计时）
+//然后每次迭代分别测量读档（映射文件并读出中央的一个格子），以及插一面旗后再次保存（整个棋盘写进临时文件后替换存档），单位都是次
+void BenchGameModel::benchSaveLoad() {
+    QFETCH(int, rows);
+    QFETCH(int, cols);
+    QFETCH(int, mines);
+
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    const QString path = directory.filePath("board.msb");
+    {
+        GameModel model;
+        model.startGame(rows, cols, mines, kSeed);
+        model.revealCell(rows / 2, cols / 2);
+        QVERIFY(model.saveGame(path));
+    }
+
+    GameModel model;
+    Sample load;
+    Sample save;
+    QElapsedTimer timer;
+    qint64 flags = 0;
+    QBENCHMARK {
+        timer.start();
+        model.loadGame(path);
+        model.getCell(rows / 2, cols / 2);
+        load.nanoseconds += timer.nsecsElapsed();
+        ++load.iterations;
+        ++load.operations;
+
+        //每次在不同的位置插旗，被修改的页面不总是同一个
+        const int cell = int(flags++ * 7919 % (qint64(rows) * cols));
+        model.flagCell(cell / cols, cell % cols);
+        timer.start();
+        model.saveGame(path);
+        save.nanoseconds += timer.nsecsElapsed();
+        ++save.iterations;
+        ++save.operations;
+    }
+    addResult("loadGame", rows, cols, mines, "load", load);
+    addResult("resaveGame", rows, cols, mines, "save", save);
+}
+
+void BenchGameModel::benchSolveWithHints_data() {
+    QTest::addColumn<int>("policy");
+    QTest::addColumn<int>("games");
+    //SafeArea的布局是随机的，一半左右的对局需要猜；NoGuess每局都能只靠推理赢下，但首次点击时要先生成并验证布局
+    QTest::newRow("16x30 safeArea") << int(FirstClickPolicy::SafeArea) << 100;
+    QTest::newRow("16x30 noGuess") << int(FirstClickPolicy::NoGuess) << 20;
+}
+
+//每次迭代用种子0~games-1各下一局：每一步取一个提示并翻开它，之后增量更新求解器，直到游戏结束，单位是步
+void BenchGameModel::benchSolveWithHints() {
+    QFETCH(int, policy);
+    QFETCH(int, games);
+    constexpr int rows = 16, cols = 30, mines = 99;
+
+    Sample sample;
+    QElapsedTimer timer;
+    QBENCHMARK {
+        timer.start();
+        for (quint64 seed = 0; seed < quint64(games); ++seed) {
+            Board board;
+            Solver solver;
+            board.startGame(rows, cols, mines, seed, FirstClickPolicy(policy));
+            solver.reset(board);
+            while (board.getGameState() == GameState::Ready || board.getGameState() == GameState::Playing) {
+                const Solver::Hint hint = solver.hint(board);
+                if (hint.row < 0) break;
+                board.revealCell(hint.row, hint.col);
+                solver.update(board, board.getChangedCells());
+                ++sample.operations;
+            }
+        }
+        sample.nanoseconds += timer.nsecsElapsed();
+        ++sample.iterations;
+    }
+    addResult("solveWithHints", rows, cols, mines, "move", sample);
+}
+
+void BenchGameModel::benchBitPlanes_data() {
+    QTest::addColumn<int>("rows");
+    QTest::addColumn<int>("cols");
+    QTest::addColumn<int>("mines");
+    QTest::addColumn<QString>("query");
+
+    //查询的耗时只与格子数有关，只使用15%一种密度
+    const char *queries[] = {"capture", "winCheck", "flagsOnMines", "neighborCounts", "frontier", "hiddenMines"};
+    for (const auto &size : kSizes) {
+        const int mines = int(qint64(size[0]) * size[1] * 15 / 100);
+        for (const char *query : queries) {
+            QTest::addRow("%dx%d %s", size[0], size[1], query) << size[0] << size[1] << mines << QString::fromLatin1(query);
+        }
+    }
+}
+
+//棋盘先按benchRandomPlay的方式下到一半（一半的格子已经翻开或插旗），这时边界最长，胜利检查也要看完整个棋盘才能确定
+//capture测量全盘构建位平面本身的耗时（只有位平面版本）；其余每种查询在同一个棋盘上分别用Cell网格和位平面执行，单位是格子
+void BenchGameModel::benchBitPlanes() {
+    QFETCH(int, rows);
+    QFETCH(int, cols);
+    QFETCH(int, mines);
+    QFETCH(QString, query);
+
+    GameModel model;
+    model.startGame(rows, cols, mines, kSeed);
+    model.revealCell(rows / 2, cols / 2);
+    const QVector<int> order = shuffledCells(rows * cols);
+    for (int i = 0; i < order.size() / 2 && model.getGameState() == GameState::Playing; ++i) {
+        const int cell = order[i];
+        const Cell state = model.getCell(cell / cols, cell % cols);
+        if (state.isRevealed || state.isFlagged) continue;
+        if (state.isMine) model.flagCell(cell / cols, cell % cols);
+        else model.revealCell(cell / cols, cell % cols);
+    }
+    const Board &board = model.board();
+    const qint64 cellCount = qint64(rows) * cols;
+
+    BitPlanes planes;
+    planes.capture(board);
+    std::vector<int> cells;
+    std::vector<std::uint8_t> counts;
+    Sample grid;
+    Sample bits;
+    QElapsedTimer timer;
+    QBENCHMARK {
+        if (query == "capture") {
+            timer.start();
+            planes.capture(board);
+            bits.nanoseconds += timer.nsecsElapsed();
+        } else {
+            timer.start();
+            const qint64 expected = gridQuery(board, query, cells, counts);
+            grid.nanoseconds += timer.nsecsElapsed();
+            timer.start();
+            const qint64 actual = planesQuery(planes, query, cells, counts);
+            bits.nanoseconds += timer.nsecsElapsed();
+            QCOMPARE(actual, expected);
+            ++grid.iterations;
+            grid.operations += cellCount;
+        }
+        ++bits.iterations;
+        bits.operations += cellCount;
+    }
+    const std::string name = query.toStdString();
+    addResult((name + "/grid").c_str(), rows, cols, mines, "cell", grid);
+    addResult((name + "/planes").c_str(), rows, cols, mines, "cell", bits);
+}
+
+QTEST_MAIN(BenchGameModel)
+#include "BenchGameModel.moc"
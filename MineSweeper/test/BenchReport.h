@@ -0,0 +1,56 @@
+#ifndef MINESWEEPER_BENCHREPORT_H
+#define MINESWEEPER_BENCHREPORT_H
+
+/*
+基准测试程序共用的JSON结果输出
+设置环境变量MINESWEEPER_BENCH_JSON为文件路径时，基准测试把全部结果写入该文件，便于在不同版本、不同数据布局之间比较
+环境变量MINESWEEPER_BENCH_LABEL可以为这次运行附加一个标签（例如提交号或数据布局的名字），原样写入JSON
+*/
+
+#include <QDateTime>  //包含QDateTime，用于在结果中记录测量时间
+#include <QFile>  //包含QFile，用于写出JSON结果
+#include <QJsonArray>  //包含JSON数组
+#include <QJsonDocument>  //包含JSON文档，用于序列化结果
+#include <QJsonObject>  //包含JSON对象
+#include <QSysInfo>  //包含QSysInfo，用于记录CPU架构和操作系统
+#include <QtGlobal>  //包含qEnvironmentVariable、qVersion
+
+//把results连同运行环境写入MINESWEEPER_BENCH_JSON指定的文件；没有设置该环境变量时什么也不做
+//benchmark是基准测试程序的名字，比较工具据此区分不同程序写出的文件
+inline void writeBenchReport(const char *benchmark, const QJsonArray &results) {
+    const QString path = qEnvironmentVariable("MINESWEEPER_BENCH_JSON");
+    if (path.isEmpty()) return;
+
+    QJsonObject root;
+    root["schema"] = 1;  //格式变化时递增，比较工具据此判断能否直接比较
+    root["benchmark"] = QString::fromLatin1(benchmark);
+    root["label"] = qEnvironmentVariable("MINESWEEPER_BENCH_LABEL");
+    root["timestamp"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    root["qtVersion"] = QString::fromLatin1(qVersion());
+#if defined(__clang__)
+    root["compiler"] = QStringLiteral("clang " __clang_version__);
+#elif defined(__GNUC__)
+    root["compiler"] = QStringLiteral("gcc " __VERSION__);
+#elif defined(_MSC_VER)
+    root["compiler"] = QStringLiteral("msvc %1").arg(_MSC_VER);
+#else
+    root["compiler"] = QStringLiteral("unknown");
+#endif
+#ifdef NDEBUG
+    root["build"] = QStringLiteral("release");
+#else
+    root["build"] = QStringLiteral("debug");
+#endif
+    root["cpu"] = QSysInfo::currentCpuArchitecture();
+    root["os"] = QSysInfo::prettyProductName();
+    root["results"] = results;
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning("cannot write benchmark results to %s", qPrintable(path));
+        return;
+    }
+    file.write(QJsonDocument(root).toJson());
+}
+
+#endif //MINESWEEPER_BENCHREPORT_H
@@ -0,0 +1,223 @@
+#include <QTest>  //包含Qt测试框架，QBENCHMARK宏也由它提供
+#include <QElapsedTimer>  //包含高精度计时器，只测量提交和执行命令的部分
+#include <algorithm>  //包含std::max、std::min
+#include <atomic>  //包含std::atomic，各个会话在不同的工作线程中累加落子数
+#include <cstdlib>  //包含std::abs
+#include <thread>  //包含std::thread::hardware_concurrency
+#include <vector>
+#include "BenchReport.h"  //包含基准测试共用的JSON结果输出
+#include "../src/Core/Board.h"  //生成脚本时在本地下同一局
+#include "../src/Server/SessionHost.h"  //包含被测量的SessionHost
+
+//会话服务器的性能基准测试：许多局游戏同时进行时，命令吞吐量随工作线程数的变化
+//运行方式：直接执行BenchSessionHost；数据行是“线程数/会话数”，例如 BenchSessionHost benchThroughput "4t/4096s"
+//设置环境变量MINESWEEPER_BENCH_JSON为文件路径时，全部结果还会以JSON格式写入该文件（见BenchReport.h）
+class BenchSessionHost : public QObject {
+    Q_OBJECT
+
+private slots:
+    void cleanupTestCase();  //所有测量完成后写出JSON结果
+
+    void benchThroughput_data();  //为吞吐量的基准测试提供不同的线程数和会话数
+    void benchThroughput();       //测量所有会话各下完一段脚本的总耗时，报告每秒执行的命令数和落子数
+
+private:
+    QJsonArray m_results;  //全部测量结果，在cleanupTestCase中写出
+};
+
+namespace {
+//每局都是高级难度的棋盘，种子固定，保证每次运行测量的都是同样的对局
+constexpr int kRows = 16;
+constexpr int kCols = 30;
+constexpr int kMines = 99;
+constexpr quint64 kSeed = 20240101;
+
+//每局在首次点击之后的脚本命令数（对局提前赢下时更少）
+constexpr int kScriptCommands = 60;
+
+//测量的会话数：少量、中等、大量（远多于线程数）
+constexpr int kSessionCounts[] = {16, 256, 4096};
+
+//一条脚本命令
+struct Command {
+    enum Kind { Reveal, Flag, Chord } kind;
+    int row;
+    int col;
+};
+
+//从第start个格子开始按行优先循环查找第一个满足pick的格子，找不到时返回-1；起点随步数跳动，命令不会都集中在棋盘的一角
+template <typename Pick>
+int findCell(const Board &board, int start, Pick &&pick) {
+    const int cells = board.getRows() * board.getCols();
+    for (int i = 0; i < cells; ++i) {
+        const int cell = (start + i) % cells;
+        if (pick(cell / board.getCols(), cell % board.getCols())) return cell;
+    }
+    return -1;
+}
+
+//在本地的Board上用同样的种子下同一局（与会话中的棋盘逐位相同），生成首次点击之后的脚本
+//脚本扮演一个知道答案的玩家：只翻开安全的格子、只在地雷上插旗、只双击旗帜数已经等于数字的格子，
+//所以每条命令在会话中都确实改变棋盘（是一次落子），对局不会失败，也不会因为踩雷而让后面的命令全部空转
+std::vector<Command> makeScript(quint64 seed) {
+    Board board;
+    board.startGame(kRows, kCols, kMines, seed);
+    board.revealCell(kRows / 2, kCols / 2);
+    const auto cellAt = [&](int r, int c) { return board.getCell(r, c); };
+    const auto isHiddenSafe = [&](int r, int c) {
+        const Cell cell = cellAt(r, c);
+        return !cell.isRevealed && !cell.isFlagged && !cell.isMine;
+    };
+    //周围未插旗的地雷数和未翻开的安全格子数
+    const auto around = [&](int r, int c, int &unflaggedMines, int &hiddenSafe) {
+        unflaggedMines = hiddenSafe = 0;
+        for (int nr = std::max(0, r - 1); nr <= std::min(kRows - 1, r + 1); ++nr) {
+            for (int nc = std::max(0, c - 1); nc <= std::min(kCols - 1, c + 1); ++nc) {
+                unflaggedMines += cellAt(nr, nc).isMine && !cellAt(nr, nc).isFlagged;
+                hiddenSafe += isHiddenSafe(nr, nc);
+            }
+        }
+    };
+
+    std::vector<Command> script;
+    for (int k = 1; k <= kScriptCommands && board.getGameState() == GameState::Playing; ++k) {
+        const int start = k * 37;
+        Command command{Command::Reveal, 0, 0};
+        int cell = -1;
+        if (k % 9 == 0) {
+            //双击：找一个周围还有未翻开的安全格子的数字格；旗帜还没插满时先在它周围的一颗地雷上插旗（作为这一步）
+            cell = findCell(board, start, [&](int r, int c) {
+                int unflaggedMines = 0, hiddenSafe = 0;
+                around(r, c, unflaggedMines, hiddenSafe);
+                return cellAt(r, c).isRevealed && cellAt(r, c).adjacentMines > 0 && hiddenSafe > 0;
+            });
+            if (cell >= 0) {
+                int unflaggedMines = 0, hiddenSafe = 0;
+                around(cell / kCols, cell % kCols, unflaggedMines, hiddenSafe);
+                if (unflaggedMines == 0) {
+                    command.kind = Command::Chord;
+                } else {
+                    const int r = cell / kCols, c = cell % kCols;
+                    cell = findCell(board, 0, [&](int nr, int nc) {
+                        return std::abs(nr - r) <= 1 && std::abs(nc - c) <= 1 && cellAt(nr, nc).isMine
+                               && !cellAt(nr, nc).isFlagged;
+                    });
+                    command.kind = Command::Flag;
+                }
+            }
+        } else if (k % 4 == 0) {
+            //在一颗还没插旗的地雷上插旗
+            cell = findCell(board, start, [&](int r, int c) { return cellAt(r, c).isMine && !cellAt(r, c).isFlagged; });
+            command.kind = Command::Flag;
+        }
+        if (cell < 0) {
+            cell = findCell(board, start, isHiddenSafe);
+            command.kind = Command::Reveal;
+        }
+        if (cell < 0) break;
+        command.row = cell / kCols;
+        command.col = cell % kCols;
+        switch (command.kind) {
+        case Command::Reveal: board.revealCell(command.row, command.col); break;
+        case Command::Flag: board.flagCell(command.row, command.col); break;
+        case Command::Chord: board.chordCell(command.row, command.col); break;
+        }
+        script.push_back(command);
+    }
+    return script;
+}
+}
+
+//写出JSON结果的实现
+void BenchSessionHost::cleanupTestCase() {
+    writeBenchReport("BenchSessionHost", m_results);
+}
+
+void BenchSessionHost::benchThroughput_data() {
+    QTest::addColumn<int>("threads");
+    QTest::addColumn<int>("sessions");
+
+    //线程数从1开始翻倍，直到硬件线程数
+    const int hardwareThreads = int(std::max(1u, std::thread::hardware_concurrency()));
+    std::vector<int> threadCounts;
+    for (int threads = 1; threads < hardwareThreads; threads *= 2) threadCounts.push_back(threads);
+    threadCounts.push_back(hardwareThreads);
+
+    for (const int threads : threadCounts) {
+        for (const int sessions : kSessionCounts) {
+            QTest::addRow("%dt/%ds", threads, sessions) << threads << sessions;
+        }
+    }
+}
+
+//每次迭代中每个会话开始新的一局，首次点击中央，之后按预先生成的脚本（见makeScript）在棋盘上跳着翻开、插旗和双击
+//命令从本线程交替地提交给所有会话，测量从开始提交到全部执行完毕的时间；除了开始新的一局，每条命令都是一次落子
+void BenchSessionHost::benchThroughput() {
+    QFETCH(int, threads);
+    QFETCH(int, sessions);
+
+    SessionHost host(threads);
+    std::vector<GameSession *> games;
+    for (int i = 0; i < sessions; ++i) games.push_back(&host.openSession());
+
+    //脚本在计时之外生成，每个会话一份
+    std::vector<std::vector<Command>> scripts;
+    for (int i = 0; i < sessions; ++i) scripts.push_back(makeScript(kSeed + quint64(i)));
+    qint64 scriptCommands = 0;
+    for (const std::vector<Command> &script : scripts) scriptCommands += qint64(script.size());
+
+    qint64 nanoseconds = 0;
+    qint64 iterations = 0;
+    qint64 commands = 0;
+    QElapsedTimer timer;
+    QBENCHMARK {
+        timer.start();
+        for (int i = 0; i < sessions; ++i) {
+            games[i]->startNewGame(kRows, kCols, kMines, kSeed + quint64(i));
+            games[i]->revealCellRequest(kRows / 2, kCols / 2);
+        }
+        for (int k = 0; k < kScriptCommands; ++k) {
+            for (int i = 0; i < sessions; ++i) {
+                if (k >= int(scripts[i].size())) continue;
+                const Command &command = scripts[i][k];
+                switch (command.kind) {
+                case Command::Reveal: games[i]->revealCellRequest(command.row, command.col); break;
+                case Command::Flag: games[i]->toggleFlagRequest(command.row, command.col); break;
+                case Command::Chord: games[i]->chordCellRequest(command.row, command.col); break;
+                }
+            }
+        }
+        host.waitForIdle();
+        nanoseconds += timer.nsecsElapsed();
+        ++iterations;
+        commands += qint64(sessions) * 2 + scriptCommands;
+    }
+
+    //落子数取自每局的记录，只统计真正改变了棋盘的操作；在计时之外读取
+    std::atomic<qint64> moves{0};
+    for (GameSession *game : games) {
+        game->post([&moves](GameModel &model) { moves.fetch_add(model.journal().getMoveCount()); });
+    }
+    host.waitForIdle();
+    QCOMPARE(moves.load(), qint64(sessions) + scriptCommands);  //首次点击和脚本中的每条命令都改变了棋盘
+
+    const double seconds = double(nanoseconds) / 1e9;
+    const WorkStealingPool::Stats stats = host.poolStats();
+    QJsonObject result;
+    result["benchmark"] = QStringLiteral("throughput");
+    result["tag"] = QString::fromLatin1(QTest::currentDataTag());
+    result["threads"] = threads;
+    result["sessions"] = sessions;
+    result["rows"] = kRows;
+    result["cols"] = kCols;
+    result["mines"] = kMines;
+    result["iterations"] = iterations;
+    result["nsPerIteration"] = double(nanoseconds) / double(iterations);
+    result["commandsPerSecond"] = double(commands) / seconds;
+    result["movesPerSecond"] = double(moves.load()) * double(iterations) / seconds;  //每次迭代下的是同样的棋，落子数相同
+    result["stolenRatio"] = stats.executed > 0 ? double(stats.stolen) / double(stats.executed) : 0.0;
+    m_results.append(result);
+}
+
+QTEST_MAIN(BenchSessionHost)  //这个宏为基准测试类自动生成一个main函数，使其可以独立运行
+#include "BenchSessionHost.moc"  //必须包含由MOC（元对象编译器）为该文件生成的代码
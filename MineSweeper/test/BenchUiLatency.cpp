@@ -0,0 +1,326 @@
+#include <QApplication>  //包含Qt应用程序类，界面基准测试需要真正的窗口和事件循环
+#include <QTest>  //包含Qt测试框架
+#include <QElapsedTimer>  //包含高精度计时器，测量每个操作从发出命令到重绘完成的时间
+#include <QTimer>  //包含定时器，用作等待界面更新时的超时保护
+#include <algorithm>  //包含std::sort
+#include <iterator>  //包含std::size
+#include <vector>  //包含std::vector
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#include <psapi.h>  //包含GetProcessMemoryInfo，用于读取峰值内存
+#elif defined(Q_OS_UNIX)
+#include <sys/resource.h>  //包含getrusage，用于读取峰值内存
+#endif
+#include "BenchReport.h"  //包含基准测试共用的JSON结果输出
+#include "../src/Model/GameModel.h"
+#include "../src/ViewModel/GameViewModel.h"
+#include "../src/View/MainWindow.h"
+#include "../src/View/BoardWidget.h"
+
+/*
+界面延迟基准测试：测量从View发出一条命令到界面重绘完成的端到端延迟
+与BenchModel只测量Model不同，这里组装与main.cpp相同的Model、ViewModel和真正的MainWindow，在offscreen平台上运行，
+按固定的脚本通过IGameCommands发出命令（开局、首次点击、翻开、插旗、双击、提示、滚动），
+每个操作的延迟包括ViewModel翻译格子、View应用更新以及随后的重绘，异步模式下还包括工作线程执行命令和等待下一帧的时间
+
+运行方式：直接执行BenchUi，没有设置QT_QPA_PLATFORM时自动使用offscreen平台，不需要显示器
+每个数据行结束时打印每种操作的延迟分布（p50/p99/最大值）、窗口中的控件数和进程的峰值内存；
+设置环境变量MINESWEEPER_BENCH_JSON时结果还会写入JSON文件（见BenchReport.h）
+峰值内存是整个进程到目前为止的最大值，数据行按棋盘从小到大排列，所以每一行的数值反映的是到这一规模为止的峰值
+*/
+
+namespace {
+//脚本中的操作类型
+enum class Action { NewGame, FirstClick, Reveal, Flag, Chord, Hint, Scroll };
+constexpr int kActionCount = int(Action::Scroll) + 1;
+constexpr const char *kActionNames[kActionCount] = {"newGame", "firstClick", "reveal", "flag", "chord", "hint", "scroll"};
+
+//每个数据行执行的操作序列：按顺序循环，直到达到kScriptLength步
+constexpr Action kScript[] = {Action::Reveal, Action::Flag, Action::Reveal, Action::Chord, Action::Reveal,
+                              Action::Hint, Action::Reveal, Action::Scroll, Action::Flag, Action::Chord};
+constexpr int kScriptLength = 400;
+//每隔这么多步重新开一局，保证每个数据行都有多个开局和首次点击的样本
+constexpr int kStepsPerGame = 100;
+
+//脚本选择格子使用的随机数种子，同样的棋盘下每次运行的操作序列都相同
+constexpr quint64 kSeed = 20240101;
+
+//测量时窗口的大小（像素），决定了视口内能看到多少个格子
+constexpr int kWindowWidth = 1024;
+constexpr int kWindowHeight = 768;
+
+//等待界面更新的最长时间（毫秒），超过时说明命令没有产生任何更新，测量失败
+constexpr int kWaitTimeoutMs = 10000;
+
+//返回进程到目前为止的峰值常驻内存（KB），不支持的平台返回0
+qint64 peakRssKb() {
+#if defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0;
+    return qint64(counters.PeakWorkingSetSize / 1024);
+#elif defined(Q_OS_UNIX)
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#if defined(Q_OS_MACOS)
+    return qint64(usage.ru_maxrss / 1024);  //macOS以字节为单位
+#else
+    return qint64(usage.ru_maxrss);  //Linux以KB为单位
+#endif
+#else
+    return 0;
+#endif
+}
+
+//返回已排序的样本中第p（0~1）分位的值（最近秩法）
+qint64 percentile(const std::vector<qint64> &sorted, double p) {
+    const std::size_t rank = std::size_t(p * double(sorted.size()) + 0.999999);
+    return sorted[std::min(sorted.size() - 1, rank > 0 ? rank - 1 : 0)];
+}
+}
+
+//测量用的窗口：与真正的MainWindow完全相同，只是游戏结束时不弹出模态对话框（否则脚本会停在对话框上），
+//并统计收到的会改变棋盘显示的UI指令数，用来判断一条命令的结果是否已经到达View
+class BenchWindow : public MainWindow {
+public:
+    void onBoardSizeChanged(const QSize &newSize) override {
+        MainWindow::onBoardSizeChanged(newSize);
+        ++updates;
+    }
+    void onCellUpdated(const CellUpdateInfo &info) override {
+        MainWindow::onCellUpdated(info);
+        ++updates;
+    }
+    void onCellsUpdated(std::span<const CellUpdateInfo> cells) override {
+        MainWindow::onCellsUpdated(cells);
+        ++updates;
+    }
+    void onShowGameOverDialog(const QString &) override { ++updates; }
+    void onShowHint(int row, int col, const QString &message) override {
+        MainWindow::onShowHint(row, col, message);
+        ++updates;
+    }
+
+    int updates = 0;  //收到的UI指令数
+};
+
+//界面延迟基准测试类
+class BenchUiLatency : public QObject {
+    Q_OBJECT
+
+private slots:
+    void cleanupTestCase();  //所有测量完成后写出JSON结果
+
+    void benchScriptedSession_data();  //提供不同规模的棋盘，以及同步/异步两种ViewModel模式
+    void benchScriptedSession();       //按脚本执行一系列操作，统计每种操作的延迟分布
+
+private:
+    QJsonArray m_results;  //全部测量结果，在cleanupTestCase中写出
+};
+
+//写出JSON结果的实现
+void BenchUiLatency::cleanupTestCase() {
+    writeBenchReport("BenchUi", m_results);
+}
+
+//数据行：棋盘规模从初级到超大，地雷密度约15%；每种规模分别在同步和异步模式下测量
+void BenchUiLatency::benchScriptedSession_data() {
+    QTest::addColumn<int>("rows");
+    QTest::addColumn<int>("cols");
+    QTest::addColumn<int>("mines");
+    QTest::addColumn<bool>("async");
+
+    const int boards[][3] = {{9, 9, 10}, {16, 30, 99}, {128, 128, 2458}, {1024, 1024, 157286}, {4096, 4096, 2516582}};
+    for (const auto &board : boards) {
+        QTest::addRow("%dx%d sync", board[0], board[1]) << board[0] << board[1] << board[2] << false;
+        QTest::addRow("%dx%d async", board[0], board[1]) << board[0] << board[1] << board[2] << true;
+    }
+}
+
+//按脚本执行操作并统计延迟的实现
+void BenchUiLatency::benchScriptedSession() {
+    QFETCH(int, rows);
+    QFETCH(int, cols);
+    QFETCH(int, mines);
+    QFETCH(bool, async);
+
+    //与main.cpp相同的组装方式（不使用布局池，首次点击总是当场布雷）
+    GameModel model;
+    GameViewModel viewModel(model);
+    viewModel.setAsynchronous(async);
+    BenchWindow window;
+    viewModel.setUI(&window);
+    window.setCommands(&viewModel);
+    window.resize(kWindowWidth, kWindowHeight);
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+    BoardWidget *boardWidget = window.findChild<BoardWidget *>();
+    QVERIFY(boardWidget);
+
+    std::vector<qint64> samples[kActionCount];
+
+    //执行一个操作：发出命令，等待它的结果到达View，再处理掉待处理的重绘请求，把整个过程的耗时记入samples
+    //异步模式下命令的结果在之后的某一帧才到达，这里在事件循环中等待；waitForUpdate为false的操作（滚动）不一定产生UI指令，只等重绘
+    auto perform = [&](Action action, const auto &command, bool waitForUpdate = true) {
+        const int before = window.updates;
+        QElapsedTimer timer;
+        timer.start();
+        command();
+        if (waitForUpdate) {
+            QTimer watchdog;  //超时后唤醒事件循环，避免命令没有产生更新时永远等待下去
+            watchdog.setSingleShot(true);
+            watchdog.start(kWaitTimeoutMs);
+            while (window.updates == before && watchdog.isActive()) {
+                QCoreApplication::processEvents(QEventLoop::AllEvents | QEventLoop::WaitForMoreEvents);
+            }
+            if (window.updates == before) return false;
+        }
+        QCoreApplication::processEvents();  //处理View在更新时提交的重绘请求，重绘在这里完成
+        samples[int(action)].push_back(timer.nsecsElapsed());
+        return true;
+    };
+
+    //在当前可见的格子中随机选一个满足条件的格子，返回行优先编号，没有时返回-1
+    Board::RandomEngine rng(kSeed);
+    std::vector<int> candidates;
+    auto pickVisible = [&](const auto &accept) {
+        const QRect visible = boardWidget->visibleCells().intersected(QRect(0, 0, cols, rows));
+        candidates.clear();
+        for (int r = visible.top(); r <= visible.bottom(); ++r) {
+            for (int c = visible.left(); c <= visible.right(); ++c) {
+                if (accept(r, c, model.getCell(r, c))) candidates.push_back(r * cols + c);
+            }
+        }
+        if (candidates.empty()) return -1;
+        return candidates[boundedRandom(rng, std::uint32_t(candidates.size()))];
+    };
+
+    //未翻开的安全格子：可以放心翻开
+    auto isHiddenSafe = [](int, int, const Cell &cell) { return !cell.isRevealed && !cell.isFlagged && !cell.isMine; };
+
+    //脚本扮演一个知道答案的玩家，只翻开安全的格子、只在地雷上插旗，游戏不会失败，只会在翻开所有安全格子后胜利
+    //（在异步模式下，命令的结果到达View时工作线程已经执行完这条命令并交出了Model，此时读取Model是安全的）
+    for (int step = 0; step < kScriptLength; ++step) {
+        if (step % kStepsPerGame == 0 || model.getGameState() != GameState::Playing) {
+            QVERIFY2(perform(Action::NewGame, [&]() { viewModel.startNewGame(rows, cols, mines); }), "new game timed out");
+            //首次点击可见区域的中央（大棋盘开局时只显示左上角的一部分）
+            const QPoint first = boardWidget->visibleCells().intersected(QRect(0, 0, cols, rows)).center();
+            QVERIFY2(perform(Action::FirstClick, [&]() { viewModel.revealCellRequest(first.y(), first.x()); }),
+                     "first click timed out");
+            continue;
+        }
+
+        switch (kScript[step % std::size(kScript)]) {
+        case Action::Reveal: {
+            int cell = pickVisible(isHiddenSafe);
+            if (cell < 0) {
+                //视口内已经没有可以翻开的格子，先滚动到棋盘上另一个安全的格子（滚动也作为一次操作计入）
+                const int start = int(boundedRandom(rng, std::uint32_t(rows * cols)));
+                for (int i = 0; i < rows * cols && cell < 0; ++i) {
+                    const int candidate = (start + i) % (rows * cols);
+                    if (isHiddenSafe(0, 0, model.getCell(candidate / cols, candidate % cols))) cell = candidate;
+                }
+                if (cell < 0) break;
+                perform(Action::Scroll, [&]() { boardWidget->centerOnCell(cell / cols, cell % cols); }, false);
+            }
+            QVERIFY2(perform(Action::Reveal, [&]() { viewModel.revealCellRequest(cell / cols, cell % cols); }),
+                     "reveal timed out");
+            break;
+        }
+        case Action::Flag: {
+            //在一颗地雷上插旗或取消插旗
+            const int cell = pickVisible([](int, int, const Cell &cell) { return !cell.isRevealed && cell.isMine; });
+            if (cell < 0) break;
+            QVERIFY2(perform(Action::Flag, [&]() { viewModel.toggleFlagRequest(cell / cols, cell % cols); }),
+                     "flag timed out");
+            break;
+        }
+        case Action::Chord: {
+            //找一个周围还有未翻开的安全格子的数字格，先在它周围的地雷上插满旗（每次插旗作为一次插旗操作计入），再双击它
+            auto chordable = [&](int r, int c, const Cell &cell) {
+                if (!cell.isRevealed || cell.adjacentMines == 0) return false;
+                for (int nr = std::max(0, r - 1); nr <= std::min(rows - 1, r + 1); ++nr) {
+                    for (int nc = std::max(0, c - 1); nc <= std::min(cols - 1, c + 1); ++nc) {
+                        if (isHiddenSafe(nr, nc, model.getCell(nr, nc))) return true;
+                    }
+                }
+                return false;
+            };
+            const int cell = pickVisible(chordable);
+            if (cell < 0) break;
+            const int r = cell / cols;
+            const int c = cell % cols;
+            for (int nr = std::max(0, r - 1); nr <= std::min(rows - 1, r + 1); ++nr) {
+                for (int nc = std::max(0, c - 1); nc <= std::min(cols - 1, c + 1); ++nc) {
+                    const Cell neighbor = model.getCell(nr, nc);
+                    if (neighbor.isMine && !neighbor.isFlagged) {
+                        QVERIFY2(perform(Action::Flag, [&]() { viewModel.toggleFlagRequest(nr, nc); }), "flag timed out");
+                    }
+                }
+            }
+            QVERIFY2(perform(Action::Chord, [&]() { viewModel.chordCellRequest(r, c); }), "chord timed out");
+            break;
+        }
+        case Action::Hint:
+            QVERIFY2(perform(Action::Hint, [&]() { viewModel.hintRequest(); }), "hint timed out");
+            break;
+        case Action::Scroll: {
+            //滚动到棋盘上的随机位置；棋盘能完整显示时滚动没有意义，跳过
+            const QRect visible = boardWidget->visibleCells();
+            if (visible.width() >= cols && visible.height() >= rows) break;
+            const int row = int(boundedRandom(rng, std::uint32_t(rows)));
+            const int col = int(boundedRandom(rng, std::uint32_t(cols)));
+            perform(Action::Scroll, [&]() { boardWidget->centerOnCell(row, col); }, false);
+            break;
+        }
+        case Action::NewGame:
+        case Action::FirstClick:
+            break;
+        }
+    }
+
+    //统计并报告每种操作的延迟分布
+    const int widgets = int(window.findChildren<QWidget *>().size()) + 1;
+    const qint64 rssKb = peakRssKb();
+    for (int action = 0; action < kActionCount; ++action) {
+        std::vector<qint64> &latencies = samples[action];
+        if (latencies.empty()) continue;
+        std::sort(latencies.begin(), latencies.end());
+        qint64 total = 0;
+        for (qint64 latency : latencies) total += latency;
+        const double p50 = double(percentile(latencies, 0.50)) / 1000.0;
+        const double p99 = double(percentile(latencies, 0.99)) / 1000.0;
+        const double max = double(latencies.back()) / 1000.0;
+        const double mean = double(total) / double(latencies.size()) / 1000.0;
+        qInfo("%-10s n=%-4d p50=%10.1fus p99=%10.1fus max=%10.1fus widgets=%d peakRss=%lldKB", kActionNames[action],
+              int(latencies.size()), p50, p99, max, widgets, rssKb);
+
+        QJsonObject result;
+        result["benchmark"] = QString::fromLatin1(kActionNames[action]);
+        result["tag"] = QString::fromLatin1(QTest::currentDataTag());
+        result["rows"] = rows;
+        result["cols"] = cols;
+        result["mines"] = mines;
+        result["mode"] = async ? QStringLiteral("async") : QStringLiteral("sync");
+        result["count"] = int(latencies.size());
+        result["p50Us"] = p50;
+        result["p99Us"] = p99;
+        result["maxUs"] = max;
+        result["meanUs"] = mean;
+        result["widgets"] = widgets;
+        result["peakRssKb"] = rssKb;
+        m_results.append(result);
+    }
+}
+
+//自定义的main函数：在创建QApplication之前选择offscreen平台插件，使基准测试可以在没有显示器的机器上运行
+int main(int argc, char *argv[]) {
+    //已经通过环境变量指定了平台（例如想在真正的屏幕上观察）时不覆盖
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication application(argc, argv);
+    BenchUiLatency bench;
+    return QTest::qExec(&bench, argc, argv);
+}
+
+#include "BenchUiLatency.moc"
@@ -1,5 +1,84 @@
 #include <QTest>  //包含Qt测试框架的核心头文件
+#include <QFile>  //读取导出的跟踪文件和存档文件
+#include <QTemporaryDir>  //跟踪文件和存档文件写在临时目录里
 #include "../src/Model/GameModel.h"  //包含被测试的GameModel类
+#include "../src/Core/BitPlanes.h"  //包含棋盘的位平面表示
+#include "../src/Core/BoardPool.h"  //包含预先生成布局的后台服务
+#include "../src/Core/Profiler.h"  //包含热点路径的计时器和计数器
+
+namespace {
+//比较两个棋盘的全部格子、计数器和游戏状态是否完全相同
+bool sameBoard(const Board &a, const Board &b) {
+    if (a.getRows() != b.getRows() || a.getCols() != b.getCols() || a.getGameState() != b.getGameState()
+        || a.getFlagCount() != b.getFlagCount() || a.getRevealedCount() != b.getRevealedCount()) {
+        return false;
+    }
+    for (int r = 0; r < a.getRows(); ++r) {
+        for (int c = 0; c < a.getCols(); ++c) {
+            const Cell x = a.getCell(r, c), y = b.getCell(r, c);
+            if (x.isMine != y.isMine || x.isRevealed != y.isRevealed || x.isFlagged != y.isFlagged
+                || x.adjacentMines != y.adjacentMines) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+//用逐个格子的朴素方法检查位平面的每一个查询结果是否都与棋盘一致
+bool planesMatch(const Board &board, const BitPlanes &planes) {
+    const int rows = board.getRows(), cols = board.getCols();
+    if (planes.getRows() != rows || planes.getCols() != cols) return false;
+    std::vector<std::uint8_t> adjacent;
+    planes.neighborCounts(BitPlanes::Plane::Mine, adjacent);
+    std::vector<int> frontier, hiddenMines, untouched, expectedFrontier, expectedHidden, expectedUntouched;
+    planes.frontier(frontier);
+    planes.hiddenMines(hiddenMines);
+    planes.untouchedSafeCells(untouched);
+    int mines = 0, revealed = 0, flags = 0, flagsOnMines = 0;
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < cols; ++c) {
+            const Cell cell = board.getCell(r, c);
+            if (planes.test(BitPlanes::Plane::Mine, r, c) != cell.isMine
+                || planes.test(BitPlanes::Plane::Revealed, r, c) != cell.isRevealed
+                || planes.test(BitPlanes::Plane::Flagged, r, c) != cell.isFlagged
+                || adjacent[r * cols + c] != cell.adjacentMines) {
+                return false;
+            }
+            mines += cell.isMine;
+            revealed += cell.isRevealed;
+            flags += cell.isFlagged;
+            flagsOnMines += cell.isMine && cell.isFlagged;
+            if (cell.isMine && !cell.isRevealed) expectedHidden.push_back(r * cols + c);
+            if (!cell.isMine && !cell.isRevealed) {
+                bool touched = false;
+                for (int nr = std::max(0, r - 1); nr <= std::min(rows - 1, r + 1); ++nr) {
+                    for (int nc = std::max(0, c - 1); nc <= std::min(cols - 1, c + 1); ++nc) {
+                        touched |= board.getCell(nr, nc).isRevealed;
+                    }
+                }
+                if (!touched) expectedUntouched.push_back(r * cols + c);
+            }
+            if (cell.isRevealed || cell.isFlagged) continue;
+            bool nearNumber = false;
+            for (int dr = -1; dr <= 1; ++dr) {
+                for (int dc = -1; dc <= 1; ++dc) {
+                    const int nr = r + dr, nc = c + dc;
+                    if ((dr || dc) && nr >= 0 && nr < rows && nc >= 0 && nc < cols) {
+                        const Cell neighbor = board.getCell(nr, nc);
+                        nearNumber |= neighbor.isRevealed && !neighbor.isMine;
+                    }
+                }
+            }
+            if (nearNumber) expectedFrontier.push_back(r * cols + c);
+        }
+    }
+    return planes.count(BitPlanes::Plane::Mine) == mines && planes.count(BitPlanes::Plane::Revealed) == revealed
+           && planes.count(BitPlanes::Plane::Flagged) == flags && planes.countFlagsOnMines() == flagsOnMines
+           && planes.allSafeRevealed() == (board.getRemainingSafeCount() == 0) && frontier == expectedFrontier
+           && hiddenMines == expectedHidden && untouched == expectedUntouched;
+}
+}
 
 //测试类必须继承自QObject以使用QTest的特性
 class TestGameModel : public QObject {
@@ -14,6 +93,29 @@ private slots:
     void testWinCondition();              //测试胜利条件的触发
     void testLoseCondition();             //测试失败条件的触发
     void testFlaggingDoesNotStartGame();  //测试右键点击不应更改游戏状态
+    void testAdjacentMineCounts();        //测试稀疏与密集两种计算方式下，每个格子的周围地雷数是否都正确（包括棋盘边缘和角落）
+    void testCascadeMatchesReference();   //测试连锁翻开的结果与朴素的递归定义完全一致
+    void testLargeCascadeDoesNotOverflow();  //测试超大空白区域的连锁翻开不会导致栈溢出
+    void testSafeAreaFirstClick();        //测试SafeArea策略下首次点击周围3x3区域内没有地雷
+    void testHighDensityPlacement();      //测试极高密度（99%以上）的布雷也能正确完成
+    void testSeedReproducesBoard();       //测试相同的种子和首次点击总是生成完全相同的棋盘
+    void testCellsChangedReportsTouchedCells();  //测试每次操作只发出一次cellsChanged，且恰好包含被改变的格子
+    void testChordRevealsNeighbors();     //测试双击在旗帜数正确时一次性翻开周围格子，且只发出一次cellsChanged
+    void testStatisticsTrackOperations();  //测试增量维护的旗帜数、已翻开数等统计信息始终与棋盘内容一致
+    void testBoardPoolServesFirstClick();  //测试随机的一局在首次翻开时从池中取用布局，设置改变时池丢弃旧布局
+    void testBoardPoolCancelsOnSettingsChange();  //测试新游戏对话框改变设置时，池取消正在生成的耗时布局并立即为新设置生成
+    void testSeededGameBypassesPool();    //测试指定种子的一局不使用池，保证可复现
+    void testProfilerRecordsReveal();     //测试首次翻开会记录布雷和连锁翻开的耗时以及翻开的格子数，并能导出跟踪文件
+    void testJournalReplaysGame();        //测试操作日志能逐位精确地重放每一步（包括来自池的布局），并能以任意顺序跳转
+    void testJournalRejectsCorruptData(); //测试不完整或被篡改的日志被识别为不合法
+    void testSaveAndLoadGame();           //测试存档后读档得到完全相同的一局，并且只有明确保存时才会修改存档文件
+    void testSaveOverLoadedFile();        //测试用同一个文件的另一种写法保存读档的那一局时，正在使用的棋盘和存档都保持完整
+    void testLoadRechecksCounters();      //测试文件头中的计数器与格子不符时，第一次操作之前以格子为准重新统计
+    void testLoadRejectsInvalidFile();    //测试不存在、不完整或格式不对的存档不会被读入，当前这一局保持不变
+    void testLoadRejectsBrokenGuardRing();  //测试外围哨兵格子被破坏的存档不会被读入（否则连锁翻开会越过映射）
+    void testUndoRedoRestoresBoard();     //测试逐步撤销和重做每次都恰好回到对应那一步的棋盘，撤销结束游戏的一步会让游戏继续，并且能被日志重放
+    void testUndoHistoryIsBounded();      //测试撤销记录的内存只随改变的格子数增长，写满后丢弃最早的记录
+    void testBitPlanesMatchBoard();       //测试位平面的全部查询与逐格计算的结果一致（包括跨字的列和不满一个字的行），增量更新与全盘构建相同
 };
 
 //测试用例：验证模型在默认构造函数调用后，其内部状态是否符合预期
@@ -163,5 +265,939 @@ void TestGameModel::testFlaggingDoesNotStartGame() {
     QCOMPARE(model.getGameState(), GameState::Playing);
 }
 
+//测试用例：验证每个非雷格子记录的周围地雷数与实际布雷情况一致
+void TestGameModel::testAdjacentMineCounts() {
+    //使用非正方形、且列数不是16整数倍的棋盘，确保行列换算和向量化的尾部处理都没有问题
+    //20颗雷（约8%）走逐颗增量更新的路径，150颗雷（约61%）走整盘批量重算的路径
+    for (int mines : {20, 150}) {
+        GameModel model;
+        model.startGame(7, 35, mines);
+        model.revealCell(3, 4);  //首次点击触发布雷和周围地雷数计算
+
+        for (int r = 0; r < model.getRows(); ++r) {
+            for (int c = 0; c < model.getCols(); ++c) {
+                if (model.getCell(r, c).isMine) continue;
+                //用最朴素的方式（带边界检查）重新数一遍周围的地雷，作为期望值
+                int expected = 0;
+                for (int dr = -1; dr <= 1; ++dr) {
+                    for (int dc = -1; dc <= 1; ++dc) {
+                        const int nr = r + dr, nc = c + dc;
+                        if ((dr != 0 || dc != 0) && nr >= 0 && nr < model.getRows() && nc >= 0 && nc < model.getCols()
+                            && model.getCell(nr, nc).isMine) {
+                            expected++;
+                        }
+                    }
+                }
+                QCOMPARE(model.getCell(r, c).adjacentMines, expected);
+            }
+        }
+    }
+}
+
+//测试用例：验证连锁翻开得到的已翻开集合与按定义朴素计算出的集合完全相同
+void TestGameModel::testCascadeMatchesReference() {
+    GameModel model;
+    const int rows = 40, cols = 50;
+    model.startGame(rows, cols, 120);
+    model.revealCell(rows / 2, cols / 2);  //首次点击，触发布雷和连锁翻开
+
+    //按定义重新计算期望的翻开集合：从首次点击的格子出发，只有空白格会继续向周围扩展
+    QVector<bool> expected(rows * cols, false);
+    QVector<int> pending{(rows / 2) * cols + cols / 2};
+    expected[pending.first()] = true;
+    while (!pending.isEmpty()) {
+        const int index = pending.takeLast();
+        const int r = index / cols, c = index % cols;
+        if (model.getCell(r, c).adjacentMines != 0) continue;
+        for (int dr = -1; dr <= 1; ++dr) {
+            for (int dc = -1; dc <= 1; ++dc) {
+                const int nr = r + dr, nc = c + dc;
+                if (nr < 0 || nr >= rows || nc < 0 || nc >= cols) continue;
+                const int neighbor = nr * cols + nc;
+                if (expected[neighbor] || model.getCell(nr, nc).isMine) continue;
+                expected[neighbor] = true;
+                pending.append(neighbor);
+            }
+        }
+    }
+
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < cols; ++c) {
+            QCOMPARE(model.getCell(r, c).isRevealed, expected[r * cols + c]);
+        }
+    }
+}
+
+//测试用例：验证一次点击就翻开数百万个格子时不会栈溢出，且胜负判断依然正确
+void TestGameModel::testLargeCascadeDoesNotOverflow() {
+    GameModel model;
+    model.startGame(2000, 2000, 0);  //没有地雷的超大棋盘，首次点击会连锁翻开全部400万个格子
+
+    model.revealCell(1000, 1000);
+
+    //所有格子都被翻开，游戏直接胜利
+    QCOMPARE(model.getGameState(), GameState::Won);
+    QVERIFY(model.getCell(0, 0).isRevealed);
+    QVERIFY(model.getCell(1999, 1999).isRevealed);
+}
+
+//测试用例：验证SafeArea策略会让首次点击的格子及其周围一圈都没有雷，并且地雷总数依然正确
+void TestGameModel::testSafeAreaFirstClick() {
+    //分别在棋盘中部和角落（3x3区域被边界截断，只剩4个格子）进行首次点击
+    const QVector<QPair<int, int>> clicks{{4, 5}, {0, 0}};
+    for (const auto &click : clicks) {
+        GameModel model;
+        model.startGame(9, 11, 80, FirstClickPolicy::SafeArea);  //99个格子放80颗雷，排除9个格子后仍然放得下
+        model.revealCell(click.first, click.second);
+
+        int mineCount = 0;
+        for (int r = 0; r < model.getRows(); ++r) {
+            for (int c = 0; c < model.getCols(); ++c) {
+                const bool nearClick = qAbs(r - click.first) <= 1 && qAbs(c - click.second) <= 1;
+                if (nearClick) {
+                    QVERIFY(!model.getCell(r, c).isMine);
+                }
+                mineCount += model.getCell(r, c).isMine;
+            }
+        }
+        QCOMPARE(mineCount, 80);
+        QCOMPARE(model.getCell(click.first, click.second).adjacentMines, 0);  //首次点击的格子必然是空白格
+    }
+}
+
+//测试用例：验证只留一个安全格子的极端密度下，布雷能立即完成且结果正确
+void TestGameModel::testHighDensityPlacement() {
+    GameModel model;
+    model.startGame(30, 30, 1000, FirstClickPolicy::SafeArea);  //地雷数超过格子数，应被限制为899颗，SafeArea也放不下而退回SafeCell
+    QCOMPARE(model.getMineCount(), 899);
+
+    model.revealCell(12, 17);
+    QVERIFY(!model.getCell(12, 17).isMine);
+    QCOMPARE(model.getGameState(), GameState::Won);  //唯一的安全格子被翻开，游戏直接胜利
+}
+
+//测试用例：验证指定种子后棋盘可以被精确复现
+void TestGameModel::testSeedReproducesBoard() {
+    //把整个棋盘的地雷分布拼成一个字符串，方便整体比较
+    auto layoutOf = [](const GameModel &model) {
+        QString layout;
+        for (int r = 0; r < model.getRows(); ++r) {
+            for (int c = 0; c < model.getCols(); ++c) {
+                layout += model.getCell(r, c).isMine ? "*" : ".";
+            }
+        }
+        return layout;
+    };
+    //用指定种子开一局高级难度的游戏，在同一位置首次点击后返回地雷分布
+    auto seededLayout = [&](quint64 seed) {
+        GameModel model;
+        model.startGame(16, 30, 99, seed);
+        model.revealCell(7, 11);
+        return layoutOf(model);
+    };
+
+    QCOMPARE(seededLayout(42), seededLayout(42));  //相同种子：棋盘逐格相同
+    QVERIFY(seededLayout(42) != seededLayout(43));  //不同种子：棋盘不同
+
+    //不指定种子时，getSeed()返回的种子同样能复现这一局
+    GameModel model;
+    model.startGame(16, 30, 99);
+    model.revealCell(7, 11);
+    QCOMPARE(seededLayout(model.getSeed()), layoutOf(model));
+}
+
+//测试用例：验证cellsChanged信号报告的格子集合
+void TestGameModel::testCellsChangedReportsTouchedCells() {
+    GameModel model;
+    model.startGame(20, 20, 30, quint64(7));
+
+    int signalCount = 0;
+    QVector<int> lastCells;
+    QObject::connect(&model, &GameModel::cellsChanged, [&](const QVector<int> &cells) {
+        signalCount++;
+        lastCells = cells;
+    });
+
+    //首次点击：报告的格子恰好是所有被翻开的格子，且没有重复
+    model.revealCell(10, 10);
+    QCOMPARE(signalCount, 1);
+    int revealed = 0;
+    for (int r = 0; r < 20; ++r) {
+        for (int c = 0; c < 20; ++c) {
+            if (model.getCell(r, c).isRevealed) {
+                revealed++;
+                QVERIFY(lastCells.contains(r * 20 + c));
+            }
+        }
+    }
+    QCOMPARE(int(lastCells.size()), revealed);
+
+    //插旗：只报告被插旗的那一个格子
+    int target = -1;
+    for (int i = 0; i < 400 && target < 0; ++i) {
+        if (!model.getCell(i / 20, i % 20).isRevealed) target = i;
+    }
+    model.flagCell(target / 20, target % 20);
+    QCOMPARE(signalCount, 2);
+    QCOMPARE(lastCells, QVector<int>{target});
+}
+
+//测试用例：验证双击的翻开规则
+void TestGameModel::testChordRevealsNeighbors() {
+    GameModel model;
+    model.startGame(16, 16, 40, quint64(3));
+    model.revealCell(8, 8);
+
+    //找一个周围还有未翻开的非地雷格子的已翻开数字格
+    int row = -1, col = -1;
+    auto hasHiddenSafeNeighbor = [&](int r, int c) {
+        for (int dr = -1; dr <= 1; ++dr) {
+            for (int dc = -1; dc <= 1; ++dc) {
+                const int nr = r + dr, nc = c + dc;
+                if (nr < 0 || nr >= 16 || nc < 0 || nc >= 16) continue;
+                const Cell n = model.getCell(nr, nc);
+                if (!n.isRevealed && !n.isMine) return true;
+            }
+        }
+        return false;
+    };
+    for (int r = 0; r < 16 && row < 0; ++r) {
+        for (int c = 0; c < 16 && row < 0; ++c) {
+            const Cell cell = model.getCell(r, c);
+            if (cell.isRevealed && cell.adjacentMines > 0 && hasHiddenSafeNeighbor(r, c)) {
+                row = r;
+                col = c;
+            }
+        }
+    }
+    QVERIFY(row >= 0);
+
+    int signalCount = 0;
+    QObject::connect(&model, &GameModel::cellsChanged, [&](const QVector<int> &) { signalCount++; });
+
+    //旗帜数不够时双击不做任何事
+    model.chordCell(row, col);
+    QCOMPARE(signalCount, 0);
+
+    //在周围的地雷上插旗后双击，周围所有非地雷格子都被翻开，整个操作只发出一次信号
+    for (int dr = -1; dr <= 1; ++dr) {
+        for (int dc = -1; dc <= 1; ++dc) {
+            const int nr = row + dr, nc = col + dc;
+            if (nr >= 0 && nr < 16 && nc >= 0 && nc < 16 && model.getCell(nr, nc).isMine) model.flagCell(nr, nc);
+        }
+    }
+    signalCount = 0;
+    model.chordCell(row, col);
+    QCOMPARE(signalCount, 1);
+    QVERIFY(!hasHiddenSafeNeighbor(row, col));
+    QVERIFY(model.getGameState() != GameState::Lost);
+}
+
+//测试用例：验证统计信息在各种操作后都与全盘重新统计的结果一致
+void TestGameModel::testStatisticsTrackOperations() {
+    GameModel model;
+    model.startGame(30, 30, 90, quint64(42));
+    QCOMPARE(model.getRemainingSafeCount(), 810);
+    QCOMPARE(model.getPercentCleared(), 0.0);
+
+    //全盘统计旗帜数和已翻开的非地雷格子数，与计数器对比
+    auto verifyCounters = [&]() {
+        int flags = 0, revealed = 0;
+        for (int r = 0; r < 30; ++r) {
+            for (int c = 0; c < 30; ++c) {
+                const Cell cell = model.getCell(r, c);
+                flags += cell.isFlagged;
+                revealed += cell.isRevealed && !cell.isMine;
+            }
+        }
+        QCOMPARE(model.getFlagCount(), flags);
+        QCOMPARE(model.getRevealedCount(), revealed);
+        QCOMPARE(model.getRemainingSafeCount(), 810 - revealed);
+        QCOMPARE(model.getPercentCleared(), 100.0 * revealed / 810);
+    };
+
+    model.revealCell(15, 15);
+    verifyCounters();
+
+    //在一部分未翻开的格子上插旗，再取消其中一半，然后继续翻开其余的非地雷格子
+    for (int i = 0; i < 900; i += 7) {
+        model.flagCell(i / 30, i % 30);
+    }
+    verifyCounters();
+    for (int i = 0; i < 900; i += 14) {
+        model.flagCell(i / 30, i % 30);
+    }
+    verifyCounters();
+    for (int i = 0; i < 900 && model.getGameState() == GameState::Playing; i += 3) {
+        if (!model.getCell(i / 30, i % 30).isMine) model.revealCell(i / 30, i % 30);
+    }
+    verifyCounters();
+
+    //新的一局重置所有计数
+    model.startGame(10, 10, 10);
+    QCOMPARE(model.getFlagCount(), 0);
+    QCOMPARE(model.getRevealedCount(), 0);
+    QCOMPARE(model.getRemainingSafeCount(), 90);
+}
+
+//测试用例：池在后台填满后，首次翻开直接取用其中的布局，并且布局满足首次点击策略
+void TestGameModel::testBoardPoolServesFirstClick() {
+    BoardPool pool(1, 1, 2);
+    GameModel model;
+    model.setBoardPool(&pool);
+
+    model.startGame(16, 30, 99, FirstClickPolicy::SafeArea);
+    QTRY_COMPARE(pool.size(), 2);  //背压：队列满了以后不再继续生成
+    QCOMPARE(pool.stats().generated, quint64(2));
+
+    model.revealCell(0, 0);  //不在中央的点击通过翻转布局同样可以命中
+    QCOMPARE(pool.stats().hits, quint64(1));
+    QCOMPARE(pool.stats().misses, quint64(0));
+    QVERIFY(model.getGameState() == GameState::Playing || model.getGameState() == GameState::Won);
+    int mines = 0;
+    for (int r = 0; r < 16; ++r) {
+        for (int c = 0; c < 30; ++c) {
+            mines += model.getCell(r, c).isMine;
+            if (r <= 1 && c <= 1) QVERIFY(!model.getCell(r, c).isMine);
+        }
+    }
+    QCOMPARE(mines, 99);
+
+    //设置相同的下一局继续使用池中剩下的布局，池在后台补满
+    model.startGame(16, 30, 99, FirstClickPolicy::SafeArea);
+    QTRY_COMPARE(pool.size(), 2);
+    QCOMPARE(pool.stats().discarded, quint64(0));
+
+    //设置改变时丢弃全部旧布局，并为新设置重新生成
+    model.startGame(9, 9, 10, FirstClickPolicy::SafeArea);
+    QCOMPARE(pool.stats().discarded, quint64(2));
+    QTRY_COMPARE(pool.size(), 2);
+    model.revealCell(4, 4);
+    QCOMPARE(pool.stats().hits, quint64(2));
+}
+
+//测试用例：验证从超大的不需要猜的棋盘切换到初级时，池放弃正在进行的生成，而不是等它完成
+void TestGameModel::testBoardPoolCancelsOnSettingsChange() {
+    BoardPool pool(1, 1, 1);
+    GameModel model;
+    model.setBoardPool(&pool);
+
+    //接近NoGuessGenerator::canGenerate上限的不需要猜的棋盘，生成一个经过求解器验证的布局通常要零点几秒
+    model.startGame(36, 36, 285, FirstClickPolicy::NoGuess);
+    QCOMPARE(model.getFirstClickPolicy(), FirstClickPolicy::NoGuess);
+    QTest::qWait(50);
+
+    model.startGame(9, 9, 10, FirstClickPolicy::SafeArea);
+    QTRY_COMPARE(pool.stats().discarded, quint64(1));  //生成到一半的布局被取消（已经生成完的话从队列中丢弃）
+    QTRY_COMPARE(pool.size(), 1);
+
+    model.revealCell(4, 4);
+    QCOMPARE(pool.stats().hits, quint64(1));
+    QCOMPARE(pool.stats().misses, quint64(0));
+}
+
+//测试用例：指定种子的一局总是自己布雷，不会取走池中的布局
+void TestGameModel::testSeededGameBypassesPool() {
+    BoardPool pool(1, 1, 2);
+    GameModel model;
+    model.setBoardPool(&pool);
+    model.startGame(9, 9, 10, FirstClickPolicy::SafeArea);
+    QTRY_COMPARE(pool.size(), 2);
+
+    GameModel reference;
+    reference.startGame(9, 9, 10, 42, FirstClickPolicy::SafeArea);
+    reference.revealCell(4, 4);
+    model.startGame(9, 9, 10, 42, FirstClickPolicy::SafeArea);
+    model.revealCell(4, 4);
+
+    QCOMPARE(pool.stats().hits, quint64(0));
+    QCOMPARE(pool.stats().misses, quint64(0));
+    QCOMPARE(pool.size(), 2);
+    for (int r = 0; r < 9; ++r) {
+        for (int c = 0; c < 9; ++c) {
+            QCOMPARE(model.getCell(r, c).isMine, reference.getCell(r, c).isMine);
+        }
+    }
+}
+
+//测试用例：验证首次翻开在Profiler中留下了布雷、连锁翻开的区段和翻开格子数的计数，跟踪事件能导出为Chrome的JSON
+void TestGameModel::testProfilerRecordsReveal() {
+#if !MINESWEEPER_PROFILING
+    QSKIP("Profiling is disabled in this build");
+#else
+    Profiler &profiler = Profiler::instance();
+    profiler.reset();
+    profiler.setTracing(true);
+
+    GameModel model;
+    model.startGame(30, 30, 10, 7, FirstClickPolicy::SafeArea);  //地雷很少，首次翻开必然连锁
+    model.revealCell(15, 15);
+    const int revealed = model.getRevealedCount();
+    QVERIFY(revealed > 9);
+
+    const Profiler::Snapshot snapshot = profiler.snapshot();
+    QCOMPARE(snapshot.zones[static_cast<int>(ProfileZone::PlaceMines)].calls, quint64(1));
+    QVERIFY(snapshot.zones[static_cast<int>(ProfileZone::FloodReveal)].calls >= 1);
+    const Profiler::Stats &cells = snapshot.counters[static_cast<int>(ProfileCounter::CellsRevealed)];
+    QCOMPARE(cells.calls, quint64(1));
+    QCOMPARE(cells.last, quint64(revealed));
+
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    const QString path = directory.filePath("trace.json");
+    QVERIFY(profiler.writeChromeTrace(path.toStdString()));
+    profiler.setTracing(false);
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QByteArray trace = file.readAll();
+    QVERIFY(trace.contains("\"traceEvents\""));
+    QVERIFY(trace.contains("\"name\":\"floodReveal\""));
+    QVERIFY(trace.contains("\"name\":\"cellsRevealed\""));
+#endif
+}
+
+//测试用例：按固定的顺序翻开、插旗、双击，保存每一步之后的棋盘，再用日志重放并以各种顺序跳转，每一步的棋盘都必须完全相同
+void TestGameModel::testJournalReplaysGame() {
+    //model已经开始了一局：按固定的步长遍历格子，混合插旗、双击和翻开，直到游戏结束，最后一局以踩雷结束
+    auto playAndVerify = [&](GameModel &model) {
+        std::vector<Board> snapshots{model.board()};
+        const int cells = model.getRows() * model.getCols();
+        auto afterMove = [&]() {
+            if (model.journal().getMoveCount() == int(snapshots.size())) snapshots.push_back(model.board());
+        };
+        model.flagCell(0, 1);  //首次翻开之前也可以插旗
+        afterMove();
+        model.revealCell(model.getRows() / 2, model.getCols() / 2);
+        afterMove();
+        for (int k = 1; k < 4 * cells && model.getGameState() == GameState::Playing; ++k) {
+            const int cell = int(qint64(k) * 37 % cells);
+            const int row = cell / model.getCols(), col = cell % model.getCols();
+            const Cell state = model.getCell(row, col);
+            if (state.isRevealed) {
+                model.chordCell(row, col);
+            } else if (k % 7 == 0 || (state.isMine && !state.isFlagged)) {
+                model.flagCell(row, col);
+            } else if (!state.isMine && !state.isFlagged) {
+                model.revealCell(row, col);
+            }
+            afterMove();
+        }
+        QCOMPARE(model.journal().getMoveCount() + 1, int(snapshots.size()));
+
+        JournalReplayer replayer(model.journal().getBytes(), 8);
+        QVERIFY(replayer.isValid());
+        QCOMPARE(replayer.getMoveCount(), model.journal().getMoveCount());
+        QVERIFY(sameBoard(replayer.seek(replayer.getMoveCount()), model.board()));
+        //倒序、顺序和跳跃的跳转都要得到同样的结果
+        for (int move = replayer.getMoveCount(); move >= 0; --move) {
+            QVERIFY2(sameBoard(replayer.seek(move), snapshots[move]), qPrintable(QString::number(move)));
+        }
+        for (int move = 0; move <= replayer.getMoveCount(); ++move) {
+            QVERIFY(sameBoard(replayer.seek(move), snapshots[move]));
+        }
+        for (int i = 0; i <= replayer.getMoveCount(); ++i) {
+            const int move = int(qint64(i) * 101 % (replayer.getMoveCount() + 1));
+            QVERIFY(sameBoard(replayer.seek(move), snapshots[move]));
+        }
+    };
+
+    //指定种子的一局：布局由种子和首次点击位置决定，每步只需要几个字节
+    GameModel model;
+    model.startGame(16, 30, 99, 2024, FirstClickPolicy::SafeArea);
+    playAndVerify(model);
+    QVERIFY(model.journal().getMoveCount() > 50);
+    QVERIFY(model.journal().getBytes().size() < std::size_t(20 + 3 * model.journal().getMoveCount()));
+
+    //NoGuess的布局同样由种子决定
+    model.startGame(16, 16, 40, 7, FirstClickPolicy::NoGuess);
+    playAndVerify(model);
+
+    //首次翻开取用了池中的布局：日志中带有完整的布局
+    BoardPool pool(3, 1, 1);
+    model.setBoardPool(&pool);
+    model.startGame(16, 30, 99, FirstClickPolicy::SafeArea);
+    QTRY_COMPARE(pool.size(), 1);
+    playAndVerify(model);
+    QCOMPARE(pool.stats().hits, quint64(1));
+
+    //踩雷结束的一局
+    model.setBoardPool(nullptr);
+    model.startGame(9, 9, 10, 11, FirstClickPolicy::SafeCell);
+    model.revealCell(4, 4);
+    for (int cell = 0; cell < 81 && model.getGameState() == GameState::Playing; ++cell) {
+        if (model.getCell(cell / 9, cell % 9).isMine) model.revealCell(cell / 9, cell % 9);
+    }
+    QCOMPARE(model.getGameState(), GameState::Lost);
+    JournalReplayer replayer(model.journal().getBytes());
+    QVERIFY(sameBoard(replayer.seek(replayer.getMoveCount()), model.board()));
+}
+
+//测试用例：截断、改坏魔数或写入越界格子的日志都不合法
+void TestGameModel::testJournalRejectsCorruptData() {
+    GameModel model;
+    model.startGame(9, 9, 10, 5, FirstClickPolicy::SafeCell);
+    model.flagCell(0, 0);
+    model.revealCell(4, 4);
+    const std::vector<std::uint8_t> bytes = model.journal().getBytes();
+    QVERIFY(JournalReplayer(bytes).isValid());
+    QCOMPARE(JournalReplayer(bytes).getMoveCount(), 2);
+
+    QVERIFY(!JournalReplayer({}).isValid());
+    std::vector<std::uint8_t> corrupt = bytes;
+    corrupt[0] = 'X';
+    QVERIFY(!JournalReplayer(corrupt).isValid());
+    corrupt = bytes;
+    corrupt.back() |= 0x80;  //最后一个varint没有结尾
+    QVERIFY(!JournalReplayer(corrupt).isValid());
+    corrupt = bytes;
+    corrupt.push_back(0xFC);  //差值远远超出棋盘范围的翻开
+    corrupt.push_back(0x7F);
+    QVERIFY(!JournalReplayer(corrupt).isValid());
+}
+
+//测试用例：存档、继续操作、再次保存，读档得到的每个格子、计数器和状态都与原来的一局相同，读出的一局可以继续玩下去
+void TestGameModel::testSaveAndLoadGame() {
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    const QString path = directory.filePath("game.msb");
+
+    auto verifySame = [](const GameModel &a, const GameModel &b) {
+        QCOMPARE(a.getRows(), b.getRows());
+        QCOMPARE(a.getCols(), b.getCols());
+        QCOMPARE(a.getMineCount(), b.getMineCount());
+        QCOMPARE(a.getFlagCount(), b.getFlagCount());
+        QCOMPARE(a.getRevealedCount(), b.getRevealedCount());
+        QCOMPARE(a.getGameState(), b.getGameState());
+        QCOMPARE(a.getFirstClickPolicy(), b.getFirstClickPolicy());
+        QCOMPARE(a.getSeed(), b.getSeed());
+        for (int r = 0; r < a.getRows(); ++r) {
+            for (int c = 0; c < a.getCols(); ++c) {
+                const Cell x = a.getCell(r, c), y = b.getCell(r, c);
+                QCOMPARE(x.isMine, y.isMine);
+                QCOMPARE(x.isRevealed, y.isRevealed);
+                QCOMPARE(x.isFlagged, y.isFlagged);
+                QCOMPARE(x.adjacentMines, y.adjacentMines);
+            }
+        }
+    };
+
+    //reference只在内存中，model在中途保存，两者执行同样的操作
+    GameModel reference;
+    GameModel model;
+    reference.startGame(40, 60, 300, 99, FirstClickPolicy::SafeArea);
+    model.startGame(40, 60, 300, 99, FirstClickPolicy::SafeArea);
+    reference.revealCell(20, 30);
+    model.revealCell(20, 30);
+    QVERIFY(model.saveGame(path));
+    QVERIFY(!model.board().isFileBacked());  //保存不会让棋盘改用文件作为存储
+    GameModel firstSave;
+    QVERIFY(firstSave.loadGame(path));
+    verifySame(firstSave, reference);
+    for (int cell = 0; cell < 2400; cell += 7) {
+        const int row = cell / 60, col = cell % 60;
+        if (reference.getCell(row, col).isMine) {
+            reference.flagCell(row, col);
+            model.flagCell(row, col);
+        } else if (cell % 3 == 0) {
+            reference.revealCell(row, col);
+            model.revealCell(row, col);
+        }
+    }
+    //保存之后的操作不会写进文件，再次保存时才会
+    GameModel unsaved;
+    QVERIFY(unsaved.loadGame(path));
+    verifySame(unsaved, firstSave);
+    QVERIFY(model.saveGame(path));
+    verifySame(model, reference);
+    verifySame(firstSave, unsaved);  //替换存档文件不影响仍然映射着旧文件的那一局
+    const int savedRevealed = reference.getRevealedCount();
+
+    //读档：新的Model读出的一局与原来的完全相同，日志为空
+    GameModel loaded;
+    int resetCount = 0;
+    QObject::connect(&loaded, &GameModel::modelChanged, [&]() { resetCount++; });
+    QVERIFY(loaded.loadGame(path));
+    QCOMPARE(resetCount, 1);
+    QVERIFY(loaded.board().isFileBacked());
+    QCOMPARE(loaded.journal().getMoveCount(), 0);
+    verifySame(loaded, reference);
+
+    //读出的一局可以继续玩到结束，结果与一直在内存中的那一局相同
+    for (int cell = 0; cell < 2400 && reference.getGameState() == GameState::Playing; ++cell) {
+        const int row = cell / 60, col = cell % 60;
+        if (!reference.getCell(row, col).isMine) {
+            reference.revealCell(row, col);
+            loaded.revealCell(row, col);
+        }
+    }
+    QCOMPARE(reference.getGameState(), GameState::Won);
+    verifySame(loaded, reference);
+
+    //继续玩读出的一局不会修改存档：另一个Model读到的仍然是保存时的那一局
+    GameModel again;
+    QVERIFY(again.loadGame(path));
+    QCOMPARE(again.getGameState(), GameState::Playing);
+    QCOMPARE(again.getRevealedCount(), savedRevealed);
+
+    //还没有首次点击的一局：读档之后的布雷与用同样的种子开始的新游戏相同
+    model.startGame(9, 9, 10, 5, FirstClickPolicy::SafeCell);
+    QVERIFY(!model.board().isFileBacked());  //开始新的一局不再使用原来的文件
+    QVERIFY(model.saveGame(directory.filePath("ready.msb")));
+    QVERIFY(loaded.loadGame(directory.filePath("ready.msb")));
+    QCOMPARE(loaded.getGameState(), GameState::Ready);
+    reference.startGame(9, 9, 10, 5, FirstClickPolicy::SafeCell);
+    reference.revealCell(4, 4);
+    loaded.revealCell(4, 4);
+    verifySame(loaded, reference);
+}
+
+//测试用例：读档之后用同一个文件的另一种写法保存，不能先把正在映射的文件清空再从映射中复制格子
+void TestGameModel::testSaveOverLoadedFile() {
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    const QString path = directory.filePath("game.msb");
+    const QString alias = directory.path() + "/./game.msb";
+
+    GameModel reference;
+    reference.startGame(30, 30, 120, 7, FirstClickPolicy::SafeArea);
+    reference.revealCell(15, 15);
+    QVERIFY(reference.saveGame(path));
+
+    GameModel loaded;
+    QVERIFY(loaded.loadGame(path));
+    QVERIFY(loaded.board().isFileBacked());
+    QVERIFY(loaded.saveGame(alias));
+
+    //正在使用的棋盘完整无缺：地雷、数字和哨兵都还在，可以和reference一样玩到结束
+    auto verifyCells = [&](const GameModel &model) {
+        QCOMPARE(model.getMineCount(), reference.getMineCount());
+        QCOMPARE(model.getRevealedCount(), reference.getRevealedCount());
+        QCOMPARE(model.getGameState(), reference.getGameState());
+        for (int r = 0; r < 30; ++r) {
+            for (int c = 0; c < 30; ++c) {
+                const Cell x = model.getCell(r, c), y = reference.getCell(r, c);
+                QCOMPARE(x.isMine, y.isMine);
+                QCOMPARE(x.isRevealed, y.isRevealed);
+                QCOMPARE(x.adjacentMines, y.adjacentMines);
+            }
+        }
+    };
+    verifyCells(loaded);
+
+    //保存下来的文件同样完整
+    GameModel reloaded;
+    QVERIFY(reloaded.loadGame(path));
+    verifyCells(reloaded);
+
+    for (int cell = 0; cell < 900 && reference.getGameState() == GameState::Playing; ++cell) {
+        if (!reference.getCell(cell / 30, cell % 30).isMine) {
+            reference.revealCell(cell / 30, cell % 30);
+            loaded.revealCell(cell / 30, cell % 30);
+        }
+    }
+    QCOMPARE(reference.getGameState(), GameState::Won);
+    verifyCells(loaded);
+}
+
+//测试用例：文件头中的计数器被改动过的存档，第一次操作之后计数器与格子一致，胜利判断照常进行
+void TestGameModel::testLoadRechecksCounters() {
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    const QString path = directory.filePath("game.msb");
+
+    GameModel reference;
+    reference.startGame(20, 20, 40, 3, FirstClickPolicy::SafeArea);
+    reference.revealCell(10, 10);
+    reference.flagCell(0, 0);
+    QVERIFY(reference.saveGame(path));
+
+    //文件头中已翻开数和旗帜数的位置（见Board.cpp中的FileHeader）
+    constexpr int revealedOffset = 36, flagsOffset = 40;
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    const qint32 revealed = 0, flags = 17;
+    QVERIFY(file.seek(revealedOffset));
+    QCOMPARE(file.write(reinterpret_cast<const char *>(&revealed), sizeof revealed), qint64(sizeof revealed));
+    QVERIFY(file.seek(flagsOffset));
+    QCOMPARE(file.write(reinterpret_cast<const char *>(&flags), sizeof flags), qint64(sizeof flags));
+    file.close();
+
+    GameModel loaded;
+    QVERIFY(loaded.loadGame(path));
+    loaded.flagCell(0, 0);
+    reference.flagCell(0, 0);
+    QCOMPARE(loaded.getFlagCount(), reference.getFlagCount());
+    QCOMPARE(loaded.getRevealedCount(), reference.getRevealedCount());
+
+    for (int cell = 0; cell < 400 && reference.getGameState() == GameState::Playing; ++cell) {
+        if (!reference.getCell(cell / 20, cell % 20).isMine) {
+            reference.revealCell(cell / 20, cell % 20);
+            loaded.revealCell(cell / 20, cell % 20);
+            QCOMPARE(loaded.getGameState(), reference.getGameState());
+        }
+    }
+    QCOMPARE(loaded.getGameState(), GameState::Won);
+}
+
+//测试用例：读档失败时当前这一局不受影响
+void TestGameModel::testLoadRejectsInvalidFile() {
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    const QString path = directory.filePath("game.msb");
+
+    GameModel model;
+    model.startGame(9, 9, 10, 5, FirstClickPolicy::SafeCell);
+    model.revealCell(4, 4);
+    QVERIFY(model.saveGame(path));
+    model.startGame(5, 5, 3, 6, FirstClickPolicy::SafeCell);  //读档失败时应当保持不变的一局
+
+    int resetCount = 0;
+    QObject::connect(&model, &GameModel::modelChanged, [&]() { resetCount++; });
+    QVERIFY(!model.loadGame(directory.filePath("missing.msb")));
+
+    //截断：文件头完整但格子不完整
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QByteArray bytes = file.readAll();
+    file.close();
+    auto writeFile = [&](const QByteArray &content) {
+        QFile out(path);
+        QVERIFY(out.open(QIODevice::WriteOnly | QIODevice::Truncate));
+        out.write(content);
+    };
+    writeFile(bytes.left(bytes.size() - 1));
+    QVERIFY(!model.loadGame(path));
+
+    //魔数不对
+    QByteArray corrupt = bytes;
+    corrupt[0] = 'X';
+    writeFile(corrupt);
+    QVERIFY(!model.loadGame(path));
+
+    QCOMPARE(resetCount, 0);
+    QCOMPARE(model.getRows(), 5);
+    QCOMPARE(model.getGameState(), GameState::Ready);
+
+    writeFile(bytes);
+    QVERIFY(model.loadGame(path));
+    QCOMPARE(model.getRows(), 9);
+    QCOMPARE(model.getGameState(), GameState::Playing);
+}
+
+//测试用例：外围一圈哨兵格子被破坏的存档不会被读入
+void TestGameModel::testLoadRejectsBrokenGuardRing() {
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    const QString path = directory.filePath("game.msb");
+
+    //还没有首次点击的空棋盘：第一次翻开会连锁翻开整个棋盘，一直走到哨兵处才停下
+    constexpr int rows = 9, cols = 9;
+    GameModel model;
+    model.startGame(rows, cols, 0, 5, FirstClickPolicy::SafeCell);
+    QVERIFY(model.saveGame(path));
+    model.startGame(5, 5, 3, 6, FirstClickPolicy::SafeCell);
+
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QByteArray bytes = file.readAll();
+    file.close();
+    auto writeFile = [&](const QByteArray &content) {
+        QFile out(path);
+        QVERIFY(out.open(QIODevice::WriteOnly | QIODevice::Truncate));
+        out.write(content);
+    };
+
+    //格子字节从第4096个字节开始，每行cols+2个，第0行和最后一行、每行的第0列和最后一列是哨兵
+    constexpr int offset = 4096, stride = cols + 2;
+    const int guard = quint8(bytes.at(offset));
+    const int damaged[][2] = {
+        {offset, guard & ~CellBits::Revealed},  //左上角不再是“已翻开”
+        {offset + 4 * stride, 0},  //第4行（真实棋盘的第3行）左边的哨兵被清零
+        {offset + (rows + 1) * stride + 5, guard & ~CellBits::Guard},  //最下面一行中间不再是哨兵
+        {offset + 6 * stride + cols + 1, guard | (4 << CellBits::CountShift)},  //右边的哨兵周围不可能有4颗雷
+    };
+    for (const auto &[position, value] : damaged) {
+        QByteArray corrupt = bytes;
+        corrupt[position] = char(value);
+        writeFile(corrupt);
+        QVERIFY(!model.loadGame(path));
+        QCOMPARE(model.getRows(), 5);
+    }
+
+    //完好的文件仍然可以读入，第一次翻开连锁翻开整个棋盘直接获胜
+    writeFile(bytes);
+    QVERIFY(model.loadGame(path));
+    model.revealCell(0, 0);
+    QCOMPARE(model.getGameState(), GameState::Won);
+}
+
+//测试用例：验证撤销和重做
+void TestGameModel::testUndoRedoRestoresBoard() {
+    GameModel model;
+    model.startGame(16, 30, 99, 99, FirstClickPolicy::SafeArea);
+    QVERIFY(!model.canUndo());
+    QVERIFY(!model.undo());
+
+    //按固定的步长混合插旗、双击和翻开，直到踩雷，并保存每一步之后的棋盘
+    std::vector<Board> snapshots{model.board()};
+    model.flagCell(0, 0);
+    snapshots.push_back(model.board());
+    model.revealCell(8, 15);
+    snapshots.push_back(model.board());
+    const int cells = model.getRows() * model.getCols();
+    for (int k = 1; model.getGameState() == GameState::Playing; ++k) {
+        const int cell = int(qint64(k) * 37 % cells);
+        const int row = cell / model.getCols(), col = cell % model.getCols();
+        const Cell state = model.getCell(row, col);
+        const int moves = model.journal().getMoveCount();
+        if (state.isRevealed) {
+            model.chordCell(row, col);
+        } else if (k % 5 == 0) {
+            model.flagCell(row, col);
+        } else if (!state.isFlagged && (!state.isMine || k > 3 * cells)) {
+            model.revealCell(row, col);  //一直避开地雷，所有格子都试过之后才踩雷
+        }
+        if (model.journal().getMoveCount() > moves) snapshots.push_back(model.board());
+    }
+    QCOMPARE(model.getGameState(), GameState::Lost);
+    const int moveCount = int(snapshots.size()) - 1;
+
+    int resumed = 0, over = 0, changedSignals = 0;
+    QVector<int> lastChanged;
+    QObject::connect(&model, &GameModel::gameResumed, [&]() { ++resumed; });
+    QObject::connect(&model, &GameModel::gameOver, [&](bool) { ++over; });
+    QObject::connect(&model, &GameModel::cellsChanged, [&](const QVector<int> &changed) {
+        ++changedSignals;
+        lastChanged = changed;
+    });
+
+    //撤销踩雷的一步：游戏回到进行中，其余地雷也随之重新隐藏，所以全部地雷都在被改变的格子中
+    QVERIFY(model.undo());
+    QCOMPARE(resumed, 1);
+    QCOMPARE(changedSignals, 1);
+    int minesChanged = 0;
+    for (int cell : lastChanged) minesChanged += model.getCell(cell / model.getCols(), cell % model.getCols()).isMine;
+    QCOMPARE(minesChanged, model.getMineCount());
+    QVERIFY(sameBoard(model.board(), snapshots[moveCount - 1]));
+
+    //一直撤销到开局：首次翻开布下的地雷保留下来，所以只在格子和计数器上与开局相同，游戏保持在进行中
+    for (int move = moveCount - 2; move >= 0; --move) {
+        QVERIFY(model.undo());
+        if (move >= 2) QVERIFY2(sameBoard(model.board(), snapshots[move]), qPrintable(QString::number(move)));
+    }
+    QVERIFY(!model.undo());
+    QCOMPARE(model.getGameState(), GameState::Playing);
+    QCOMPARE(model.getRevealedCount(), 0);
+    QCOMPARE(model.getFlagCount(), 0);
+
+    //再逐步重做到最后：最后一步重新踩雷，发出gameOver
+    for (int move = 1; move <= moveCount; ++move) {
+        QVERIFY(model.redo());
+        if (move >= 2) QVERIFY2(sameBoard(model.board(), snapshots[move]), qPrintable(QString::number(move)));
+    }
+    QVERIFY(!model.redo());
+    QCOMPARE(over, 1);
+    QCOMPARE(model.getGameState(), GameState::Lost);
+
+    //撤销之后进行新的操作，被撤销的操作不能再重做
+    QVERIFY(model.undo());
+    QVERIFY(model.undo());
+    QVERIFY(model.canRedo());
+    const int flagged = model.getCell(0, 0).isFlagged ? 1 : 0;
+    model.flagCell(0, 0);
+    QVERIFY(!model.canRedo());
+    QVERIFY(!model.redo());
+    QCOMPARE(model.getCell(0, 0).isFlagged, flagged == 0);
+
+    //日志中的撤销和重做也能被重放
+    JournalReplayer replayer(model.journal().getBytes(), 16);
+    QVERIFY(replayer.isValid());
+    QCOMPARE(replayer.getMoveCount(), model.journal().getMoveCount());
+    QVERIFY(sameBoard(replayer.seek(replayer.getMoveCount()), model.board()));
+    QVERIFY(sameBoard(replayer.seek(moveCount), snapshots[moveCount]));
+    QVERIFY(sameBoard(replayer.seek(moveCount + 1), snapshots[moveCount - 1]));
+
+    //开始新的一局后没有可以撤销的操作
+    model.startGame(9, 9, 10, 1);
+    QVERIFY(!model.canUndo());
+    QVERIFY(!model.canRedo());
+}
+
+//测试用例：验证撤销记录的容量
+void TestGameModel::testUndoHistoryIsBounded() {
+    //在大棋盘上插旗1000次，每一步只占一个格子编号，与棋盘大小无关
+    Board board;
+    board.startGame(1000, 1000, 1000, 5);
+    UndoHistory history(100);
+    for (int i = 0; i < 1000; ++i) {
+        const GameState before = board.getGameState();
+        QVERIFY(board.flagCell(i / 1000, i % 1000));
+        history.record(board, CellBits::Flagged, before);
+        QVERIFY(history.getCellCount() <= 100);
+    }
+    QCOMPARE(history.getCellCount(), std::size_t(100));
+
+    //只能撤销最近的100步，最早的记录已被覆盖
+    int undone = 0;
+    while (history.undo(board)) ++undone;
+    QCOMPARE(undone, 100);
+    QCOMPARE(board.getFlagCount(), 900);
+    QVERIFY(board.getCell(0, 899).isFlagged);
+    QVERIFY(!board.getCell(0, 900).isFlagged);
+    int redone = 0;
+    while (history.redo(board)) ++redone;
+    QCOMPARE(redone, 100);
+    QCOMPARE(board.getFlagCount(), 1000);
+
+    //一次改变的格子比整个缓冲区还多时，这一步和之前的操作都无法撤销
+    board.startGame(100, 100, 1, 5);
+    history.clear();
+    QVERIFY(board.flagCell(99, 99));
+    history.record(board, CellBits::Flagged, GameState::Ready);
+    const GameState before = board.getGameState();
+    QVERIFY(board.revealCell(0, 0));
+    QVERIFY(board.getRevealedCount() > 100);
+    history.record(board, CellBits::Revealed, before);
+    QVERIFY(!history.canUndo());
+    QCOMPARE(history.getCellCount(), std::size_t(0));
+}
+
+//测试用例：各种列数（不满一个字、恰好一个字、跨多个字）的棋盘上，位平面的查询结果都与棋盘一致
+void TestGameModel::testBitPlanesMatchBoard() {
+    const int sizes[][3] = {{1, 1, 0}, {9, 9, 10}, {16, 30, 99}, {5, 64, 60}, {70, 130, 1800}, {33, 200, 2500}};
+    for (const auto &size : sizes) {
+        const int rows = size[0], cols = size[1];
+        for (quint64 seed = 1; seed <= 5; ++seed) {
+            Board board;
+            board.startGame(rows, cols, size[2], seed);
+            BitPlanes planes;
+            planes.capture(board);
+            QVERIFY(planesMatch(board, planes));
+
+            //按固定的步长插旗和翻开，每一步之后增量更新，直到游戏结束，结束时（包括失败时显示的地雷）也要一致
+            board.revealCell(rows / 2, cols / 2);
+            planes.update(board, board.getChangedCells());
+            QVERIFY(planesMatch(board, planes));
+            for (int k = 1; k < 400 && board.getGameState() == GameState::Playing; ++k) {
+                const int cell = int((k * 7919 + seed * 31) % quint64(rows * cols));
+                const bool changed = (k % 3 == 0) ? board.flagCell(cell / cols, cell % cols)
+                                                  : board.revealCell(cell / cols, cell % cols);
+                if (changed) planes.update(board, board.getChangedCells());
+            }
+            QVERIFY(planesMatch(board, planes));
+
+            //增量维护的位平面与重新全盘构建的逐字相同
+            BitPlanes fresh;
+            fresh.capture(board);
+            for (int r = 0; r < rows; ++r) {
+                for (const BitPlanes::Plane plane : {BitPlanes::Plane::Mine, BitPlanes::Plane::Revealed, BitPlanes::Plane::Flagged}) {
+                    QVERIFY(std::equal(fresh.rowWords(plane, r), fresh.rowWords(plane, r) + fresh.getWordsPerRow(),
+                                       planes.rowWords(plane, r)));
+                }
+            }
+        }
+    }
+}
+
 QTEST_MAIN(TestGameModel)  //这个宏为测试类自动生成一个main函数，使其可以独立运行
 #include "TestGameModel.moc"  //必须包含由MOC（元对象编译器）为该文件生成的代码，以实现信号/槽和QTest的内部机制
\ No newline at end of file
@@ -2,6 +2,24 @@
 #include "../src/Model/GameModel.h"
 #include "../src/ViewModel/GameViewModel.h"
 #include "../src/common/IGameUI.h"  //包含UI接口，因为需要Mock它
+#include <atomic>  //包含原子计数器，用于统计内存分配次数
+#include <cstdlib>  //包含malloc/free，用于实现替换后的全局operator new/delete
+#include <new>  //包含std::bad_alloc
+
+//--- 内存分配计数 ---
+//替换全局的operator new/delete，统计整个测试程序中通过new进行的内存分配次数
+//用于验证ViewModel在稳定状态下的格子更新不会产生任何内存分配
+namespace {
+std::atomic<long long> g_allocationCount{0};
+}
+
+void *operator new(std::size_t size) {
+    g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
 
 //Mock（模拟）对象：一个IGameUI接口的模拟实现
 //它不执行任何真正的UI操作，而是记录ViewModel调用了它的哪些方法、以及传入了什么参数
@@ -18,6 +36,10 @@ public:
     int lastFlagCount = 0;
     int statusLabelCount = 0;
     QString lastStatusText;
+    int hintCount = 0;
+    int lastHintRow = -1;
+    int lastHintCol = -1;
+    QString lastHintText;
 
     //重写接口中的所有纯虚函数
     void onBoardSizeChanged(const QSize& newSize) override { boardSizeChangedCount++; lastBoardSize = newSize; }
@@ -25,6 +47,7 @@ public:
     void onShowGameOverDialog(const QString& message) override { gameOverDialogCount++; lastGameOverMessage = message; }
     void updateFlagsLabel(int flags) override { flagsLabelCount++; lastFlagCount = flags; }
     void updateStatusLabel(const QString& text) override { statusLabelCount++; lastStatusText = text; }
+    void onShowHint(int row, int col, const QString& text) override { hintCount++; lastHintRow = row; lastHintCol = col; lastHintText = text; }
 
     //一个辅助函数，用于在每个测试用例开始前清空所有记录，确保测试的独立性
     void reset() {
@@ -33,6 +56,19 @@ public:
         gameOverDialogCount = 0;
         flagsLabelCount = 0;
         statusLabelCount = 0;
+        hintCount = 0;
+    }
+};
+
+//在MockGameUI的基础上重写批量接口，用于验证ViewModel每次操作只发出一批更新
+class BatchingMockGameUI : public MockGameUI {
+public:
+    int batchCount = 0;  //onCellsUpdated被调用的次数
+    int lastBatchSize = 0;  //最后一批更新包含的格子数
+
+    void onCellsUpdated(std::span<const CellUpdateInfo> updates) override {
+        batchCount++;
+        lastBatchSize = static_cast<int>(updates.size());
     }
 };
 
@@ -44,8 +80,18 @@ private slots:
     //每个测试用例都完全自包含，在函数内部创建所需的所有对象，以保证100%的隔离性
     void testStartGameCommand();        //测试startNewGame命令是否正确驱动了UI
     void testRevealTranslatesToUIUpdate();  //测试当Model数据变化时，ViewModel是否正确地将其翻译为UI更新
+    void testFlagUpdatesSingleCell();     //测试插旗时ViewModel只更新被改变的那一个格子
+    void testCascadeSentAsSingleBatch();  //测试一次连锁翻开的所有格子更新被打包成一批发送
+    void testViewportLimitsUpdates();     //测试设置显示区域后，ViewModel只发送区域内格子的更新
+    void testHintPointsToSafeCell();      //测试提示命令总是指向一个确定安全的未翻开格子（在能确定时）
+    void testVisualStatesAreInterned();   //测试每个格子更新中的文字和样式都直接共享外观表中的字符串
+    void testSteadyStateUpdatesDoNotAllocate();  //测试稳定状态下的格子更新不产生任何内存分配
     void testGameOverWinTranslation();    //测试游戏胜利时，ViewModel是否发送了正确的UI指令
     void testGameOverLoseTranslation();   //测试游戏失败时，ViewModel是否发送了正确的UI指令
+    void testUncertifiedLayoutReported(); //测试要求不需要猜、却没能生成这样的布局时，状态栏告诉玩家
+    void testUndoRequestRestoresView();   //测试撤销命令只更新被撤销的格子，撤销踩雷后状态文字回到进行中，重做后再次结束
+    void testHintAfterUndo();             //测试撤销按提示翻开的格子之后，提示仍然能确定地指向重新盖上的安全格子
+    void testAsynchronousModelKeepsOrder();  //测试异步模式下命令按顺序执行，结果按帧合并后交给UI，新的一局丢弃过期的命令
 };
 
 //测试用例：验证startNewGame命令
@@ -67,6 +113,12 @@ void TestGameViewModel::testStartGameCommand() {
     QCOMPARE(mockUI.lastBoardSize, QSize(12, 8));
     QCOMPARE(mockUI.statusLabelCount, 1);
     QCOMPARE(mockUI.lastStatusText, "Game in progress...");
+    QCOMPARE(model.board().getFirstClickPolicy(), FirstClickPolicy::SafeCell);
+
+    //新游戏对话框中选择的首次点击策略随命令一起传给Model
+    viewModel.startNewGame(16, 30, 99, FirstClickPolicy::NoGuess);
+    QCOMPARE(model.board().getFirstClickPolicy(), FirstClickPolicy::NoGuess);
+    QCOMPARE(mockUI.lastBoardSize, QSize(30, 16));
 }
 
 //测试用例：验证翻开格子后UI的更新
@@ -81,12 +133,194 @@ void TestGameViewModel::testRevealTranslatesToUIUpdate() {
 
     model.revealCell(2, 2);  //直接操作model来触发信号，模拟玩家点击
 
-    //onModelChanged会被触发，它会为所有25个格子调用onCellUpdated
-    QCOMPARE(mockUI.cellUpdatedCount, 25);
-    //同时，onModelChanged也会更新一次旗帜数量
+    //onCellsChanged会被触发，它只为本次被翻开的格子调用onCellUpdated
+    int revealed = 0;
+    for (int r = 0; r < 5; ++r) {
+        for (int c = 0; c < 5; ++c) {
+            revealed += model.getCell(r, c).isRevealed;
+        }
+    }
+    QCOMPARE(mockUI.cellUpdatedCount, revealed);
+    //同时，onCellsChanged也会更新一次旗帜数量
     QCOMPARE(mockUI.flagsLabelCount, 1);
 }
 
+//测试用例：验证插旗只会产生一次格子更新，与棋盘大小无关
+void TestGameViewModel::testFlagUpdatesSingleCell() {
+    GameModel model;
+    GameViewModel viewModel(model);
+    MockGameUI mockUI;
+    viewModel.setUI(&mockUI);
+
+    model.startGame(300, 300, 100);
+    mockUI.reset();
+
+    model.flagCell(10, 20);
+
+    QCOMPARE(mockUI.cellUpdatedCount, 1);  //9万个格子的棋盘上，只有被插旗的那一个格子被更新
+    QCOMPARE(mockUI.flagsLabelCount, 1);
+    QCOMPARE(mockUI.lastFlagCount, 99);
+}
+
+//测试用例：验证批量接口被调用且每次操作只调用一次
+void TestGameViewModel::testCascadeSentAsSingleBatch() {
+    GameModel model;
+    GameViewModel viewModel(model);
+    BatchingMockGameUI mockUI;
+    viewModel.setUI(&mockUI);
+
+    model.startGame(50, 50, 0);  //没有地雷，首次点击会翻开全部2500个格子
+    mockUI.batchCount = 0;
+
+    model.revealCell(25, 25);
+
+    QCOMPARE(mockUI.batchCount, 1);
+    QCOMPARE(mockUI.lastBatchSize, 2500);
+    QCOMPARE(mockUI.cellUpdatedCount, 0);  //重写了批量接口后，单格接口不再被逐个调用
+}
+
+//测试用例：验证设置显示区域后，ViewModel只翻译和发送区域内的格子
+void TestGameViewModel::testViewportLimitsUpdates() {
+    GameModel model;
+    GameViewModel viewModel(model);
+    BatchingMockGameUI mockUI;
+    viewModel.setUI(&mockUI);
+
+    model.startGame(100, 100, 0);
+    mockUI.batchCount = 0;
+
+    //设置显示区域时，区域内的全部格子被发送一次
+    viewModel.setViewport(QRect(0, 0, 10, 10));
+    QCOMPARE(mockUI.batchCount, 1);
+    QCOMPARE(mockUI.lastBatchSize, 100);
+
+    //一次翻开全部1万个格子，只有区域内的100个格子被发送
+    model.revealCell(50, 50);
+    QCOMPARE(mockUI.batchCount, 2);
+    QCOMPARE(mockUI.lastBatchSize, 100);
+
+    //超出棋盘的部分被裁掉
+    viewModel.setViewport(QRect(95, 90, 20, 20));
+    QCOMPARE(mockUI.lastBatchSize, 50);
+}
+
+//测试用例：验证提示命令的结果
+void TestGameViewModel::testHintPointsToSafeCell() {
+    GameModel model;
+    GameViewModel viewModel(model);
+    MockGameUI mockUI;
+    viewModel.setUI(&mockUI);
+
+    //首次点击之前，提示棋盘中央（首次点击必然安全）
+    model.startGame(9, 9, 10, quint64(11), FirstClickPolicy::SafeArea);
+    viewModel.hintRequest();
+    QCOMPARE(mockUI.hintCount, 1);
+    QCOMPARE(mockUI.lastHintRow, 4);
+    QCOMPARE(mockUI.lastHintCol, 4);
+
+    //之后一直按提示翻开格子，提示的格子总是尚未翻开的格子
+    model.revealCell(4, 4);
+    for (int step = 0; step < 81 && model.getGameState() == GameState::Playing; ++step) {
+        viewModel.hintRequest();
+        QVERIFY(mockUI.lastHintRow >= 0);
+        QVERIFY(!model.getCell(mockUI.lastHintRow, mockUI.lastHintCol).isRevealed);
+        model.revealCell(mockUI.lastHintRow, mockUI.lastHintCol);
+    }
+
+    //游戏结束后没有可提示的格子
+    viewModel.hintRequest();
+    QCOMPARE(mockUI.lastHintRow, -1);
+}
+
+//测试用例：按提示翻开、再次提示（已翻开的候选被取走）、撤销，之后的提示指向被撤销重新盖上的安全格子
+void TestGameViewModel::testHintAfterUndo() {
+    GameModel model;
+    GameViewModel viewModel(model);
+    MockGameUI mockUI;
+    viewModel.setUI(&mockUI);
+
+    model.startGame(16, 30, 99, quint64(11), FirstClickPolicy::SafeArea);
+    viewModel.revealCellRequest(8, 15);
+    viewModel.hintRequest();
+    QVERIFY(mockUI.lastHintText.endsWith("is safe."));
+    const int row = mockUI.lastHintRow, col = mockUI.lastHintCol;
+
+    //记下按提示翻开的这一步翻开了哪些格子
+    std::vector<std::uint8_t> before(16 * 30);
+    for (int cell = 0; cell < 16 * 30; ++cell) before[cell] = model.getCell(cell / 30, cell % 30).isRevealed;
+    viewModel.revealCellRequest(row, col);
+    QCOMPARE(model.getGameState(), GameState::Playing);
+    viewModel.hintRequest();  //取走已经翻开的候选，提示另一个格子
+
+    viewModel.undoRequest();
+    QVERIFY(!model.getCell(row, col).isRevealed);
+    viewModel.hintRequest();
+    QVERIFY(mockUI.lastHintText.endsWith("is safe."));
+    QVERIFY(mockUI.lastHintRow >= 0);
+    QVERIFY(!before[mockUI.lastHintRow * 30 + mockUI.lastHintCol]);
+    QVERIFY(!model.getCell(mockUI.lastHintRow, mockUI.lastHintCol).isRevealed);
+    QVERIFY(!model.getCell(mockUI.lastHintRow, mockUI.lastHintCol).isMine);
+
+    //提示的是这次撤销重新盖上的格子：重做之后它是翻开的
+    viewModel.redoRequest();
+    QVERIFY(model.getCell(mockUI.lastHintRow, mockUI.lastHintCol).isRevealed);
+}
+
+//记录每一个格子更新的Mock，用于检查更新内容
+class RecordingMockGameUI : public MockGameUI {
+public:
+    QVector<CellUpdateInfo> updates;
+    void onCellUpdated(const CellUpdateInfo& info) override { updates.append(info); }
+};
+
+//测试用例：验证CellUpdateInfo中的字符串与外观表共享同一份数据，而不是为每个格子新建字符串
+void TestGameViewModel::testVisualStatesAreInterned() {
+    GameModel model;
+    GameViewModel viewModel(model);
+    RecordingMockGameUI mockUI;
+    viewModel.setUI(&mockUI);
+
+    model.startGame(30, 30, 120, quint64(3));
+    model.flagCell(0, 0);
+    model.revealCell(15, 15);  //首次点击会翻开一片区域，包含多种数字格
+
+    QVERIFY(!mockUI.updates.isEmpty());
+    for (const CellUpdateInfo &info : mockUI.updates) {
+        const CellVisualStyle &style = GameViewModel::visualStyle(info.visual);
+        QVERIFY(info.text.constData() == style.text.constData());
+        QVERIFY(info.styleSheet.constData() == style.styleSheet.constData());
+        QCOMPARE(info.enabled, style.enabled);
+    }
+    //抽查几种外观状态的内容，确保表的内容与原先逐格拼接的结果一致
+    QCOMPARE(GameViewModel::visualStyle(CellVisual::Flagged).text, QString("🚩"));
+    QCOMPARE(GameViewModel::visualStyle(CellVisual::Revealed2).text, QString("2"));
+    QCOMPARE(GameViewModel::visualStyle(CellVisual::Revealed2).styleSheet,
+             QString("background-color: #e0e0e0; border: 1px solid #808080;color: green;"));
+}
+
+//测试用例：验证稳定状态下（缓冲区容量已经足够之后）反复插旗、取消插旗不会产生任何内存分配
+void TestGameViewModel::testSteadyStateUpdatesDoNotAllocate() {
+    GameModel model;
+    GameViewModel viewModel(model);
+    MockGameUI mockUI;
+    viewModel.setUI(&mockUI);
+
+    model.startGame(100, 100, 50);
+    mockUI.reset();
+    //预热：让外观表完成构建，让Model和ViewModel内部的缓冲区达到所需的容量
+    model.flagCell(5, 5);
+    model.flagCell(5, 5);
+
+    const long long before = g_allocationCount.load();
+    for (int i = 0; i < 1000; ++i) {
+        model.flagCell(5, 5);
+    }
+    const long long allocations = g_allocationCount.load() - before;
+
+    QCOMPARE(mockUI.cellUpdatedCount, 1002);  //每次插旗都确实产生了一次格子更新
+    QCOMPARE(allocations, 0LL);
+}
+
 //测试用例：验证胜利场景的翻译
 void TestGameViewModel::testGameOverWinTranslation() {
     GameModel model;
@@ -151,6 +385,122 @@ void TestGameViewModel::testGameOverLoseTranslation() {
     QCOMPARE(mockUI.lastStatusText, "You Lost! :(");
 }
 
+//测试用例：验证NoGuess布局没有经过验证时，首次翻开之后状态栏提示可能需要猜，经过验证时不提示
+void TestGameViewModel::testUncertifiedLayoutReported() {
+    GameModel model;
+    GameViewModel viewModel(model);
+    MockGameUI mockUI;
+    viewModel.setUI(&mockUI);
+
+    //3x3的棋盘点击中央时，首次点击周围3x3之外没有格子，生成器只能退回普通布局
+    viewModel.startNewGame(3, 3, 1, FirstClickPolicy::NoGuess);
+    mockUI.reset();
+    viewModel.revealCellRequest(1, 1);
+    QCOMPARE(mockUI.statusLabelCount, 1);
+    QVERIFY(mockUI.lastStatusText.contains("may need guessing"));
+
+    //之后的操作不再重复提示
+    mockUI.reset();
+    viewModel.toggleFlagRequest(0, 0);
+    QCOMPARE(mockUI.statusLabelCount, 0);
+
+    viewModel.startNewGame(16, 30, 99, FirstClickPolicy::NoGuess);
+    mockUI.reset();
+    viewModel.revealCellRequest(8, 15);
+    QVERIFY(model.board().isLayoutCertified());
+    QCOMPARE(mockUI.statusLabelCount, 0);
+}
+
+//测试用例：验证撤销和重做命令
+void TestGameViewModel::testUndoRequestRestoresView() {
+    GameModel model;
+    GameViewModel viewModel(model);
+    BatchingMockGameUI mockUI;
+    viewModel.setUI(&mockUI);
+
+    model.startGame(10, 10, 10, 3);
+    viewModel.revealCellRequest(0, 0);
+    int mineRow = -1, mineCol = -1;
+    for (int cell = 0; cell < 100 && mineRow < 0; ++cell) {
+        if (model.getCell(cell / 10, cell % 10).isMine) {
+            mineRow = cell / 10;
+            mineCol = cell % 10;
+        }
+    }
+    QVERIFY(mineRow >= 0);
+
+    //插旗后撤销：只有这一个格子被更新，旗帜数回到原来的值
+    viewModel.toggleFlagRequest(mineRow, mineCol);
+    QCOMPARE(mockUI.lastFlagCount, 9);
+    const int batches = mockUI.batchCount;
+    viewModel.undoRequest();
+    QCOMPARE(mockUI.batchCount, batches + 1);
+    QCOMPARE(mockUI.lastBatchSize, 1);
+    QCOMPARE(mockUI.lastFlagCount, 10);
+    QVERIFY(!model.getCell(mineRow, mineCol).isFlagged);
+
+    //踩雷后撤销：游戏回到进行中，全部地雷重新隐藏
+    viewModel.revealCellRequest(mineRow, mineCol);
+    QCOMPARE(mockUI.lastStatusText, "You Lost! :(");
+    mockUI.reset();
+    viewModel.undoRequest();
+    QCOMPARE(model.getGameState(), GameState::Playing);
+    QCOMPARE(mockUI.lastStatusText, "Game in progress...");
+    QCOMPARE(mockUI.lastBatchSize, 10);
+    QCOMPARE(mockUI.gameOverDialogCount, 0);
+
+    //重做：再次踩雷，和原来的操作一样弹出游戏结束对话框
+    viewModel.redoRequest();
+    QCOMPARE(model.getGameState(), GameState::Lost);
+    QCOMPARE(mockUI.gameOverDialogCount, 1);
+    QCOMPARE(mockUI.lastStatusText, "You Lost! :(");
+}
+
+//测试用例：异步模式
+void TestGameViewModel::testAsynchronousModelKeepsOrder() {
+    GameModel model;
+    GameViewModel viewModel(model);
+    BatchingMockGameUI mockUI;
+    viewModel.setUI(&mockUI);
+    viewModel.setAsynchronous(true);
+
+    //新的一局在工作线程中开始，UI在之后的某一帧才收到新的棋盘尺寸
+    viewModel.startNewGame(9, 9, 10);
+    QCOMPARE(mockUI.boardSizeChangedCount, 0);
+    QTRY_COMPARE(mockUI.boardSizeChangedCount, 1);
+    QCOMPARE(mockUI.lastBoardSize, QSize(9, 9));
+
+    //一连串插旗命令按顺序执行，结果被合并成远少于命令数的几批
+    mockUI.batchCount = 0;
+    for (int c = 0; c < 9; ++c) {
+        for (int r = 0; r < 5; ++r) viewModel.toggleFlagRequest(r, c);
+    }
+    QTRY_COMPARE(mockUI.lastFlagCount, 10 - 45);
+    QVERIFY(mockUI.batchCount < 45);
+
+    //先插旗再翻开同一个格子：按顺序执行时插了旗的格子不会被翻开
+    viewModel.startNewGame(9, 9, 10);
+    viewModel.toggleFlagRequest(8, 8);
+    viewModel.revealCellRequest(8, 8);
+    //紧接着开始的新一局丢弃上一局中还没有执行的命令，新棋盘上不会留下它们的痕迹
+    viewModel.startNewGame(6, 7, 5);
+    viewModel.toggleFlagRequest(0, 0);
+    viewModel.revealCellRequest(0, 0);
+    QTRY_COMPARE(mockUI.lastBoardSize, QSize(7, 6));
+
+    //恢复同步模式：已提交的命令全部执行完，最后一批改变交给UI，之后可以直接读取Model
+    viewModel.setAsynchronous(false);
+    QCOMPARE(model.getRows(), 6);
+    QCOMPARE(model.getFlagCount(), 1);
+    QVERIFY(model.getCell(0, 0).isFlagged);
+    QCOMPARE(model.getRevealedCount(), 0);
+    QCOMPARE(model.getGameState(), GameState::Ready);
+    QCOMPARE(mockUI.lastFlagCount, 4);
+
+    //同步模式下命令立即生效
+    viewModel.revealCellRequest(3, 3);
+    QVERIFY(model.getCell(3, 3).isRevealed);
+}
 
 QTEST_MAIN(TestGameViewModel)  //为该测试文件生成独立的main函数
 #include "TestGameViewModel.moc"  //包含MOC生成的代码
\ No newline at end of file
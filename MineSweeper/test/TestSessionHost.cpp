@@ -0,0 +1,337 @@
+#include <QTest>  //包含Qt测试框架的核心头文件
+#include <QByteArray>
+#include <QCoreApplication>  //包含应用程序类，用于生成每次运行都不同的套接字名字
+#include <QLocalSocket>  //套接字测试中扮演客户端
+#include <QMutex>
+#include <QMutexLocker>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "../src/Server/SessionHost.h"  //包含被测试的SessionHost和GameSession
+#include "../src/Server/SessionServer.h"  //包含被测试的本地套接字服务器
+
+//会话服务器的测试类：线程池、Strand、会话和套接字协议
+class TestSessionHost : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testPoolRunsEveryTask();          //测试线程池执行了全部任务（包括任务中提交的任务），并且waitForIdle等到了它们
+    void testStrandRunsTasksInOrder();     //测试同一个Strand的任务按提交顺序执行，并且从不同时执行
+    void testStrandDestructionSkipsBacklog();  //测试析构Strand时，已经取出准备执行但还没有开始的任务不会再执行
+    void testSessionsMatchDirectModel();   //测试许多会话并行执行后，每一局都与直接在本线程中执行同样命令的GameModel相同
+    void testObserverReceivesResults();    //测试观察者按顺序收到新的一局、每次改变的格子和提示
+    void testCloseSessionDiscardsPending();  //测试关闭会话时丢弃还没有执行的命令，且不影响其他会话
+    void testSocketRoundTrip();            //测试通过本地套接字开局、翻开、请求提示和处理错误的命令
+};
+
+namespace {
+//会话测试使用的棋盘：高级难度
+constexpr int kRows = 16;
+constexpr int kCols = 30;
+constexpr int kMines = 99;
+
+//两个棋盘的状态和每个格子是否完全相同
+bool sameBoard(const Board &a, const Board &b) {
+    if (a.getRows() != b.getRows() || a.getCols() != b.getCols() || a.getGameState() != b.getGameState()
+        || a.getFlagCount() != b.getFlagCount() || a.getRevealedCount() != b.getRevealedCount()) {
+        return false;
+    }
+    for (int row = 0; row < a.getRows(); ++row) {
+        for (int col = 0; col < a.getCols(); ++col) {
+            const Cell x = a.getCell(row, col);
+            const Cell y = b.getCell(row, col);
+            if (x.isMine != y.isMine || x.isRevealed != y.isRevealed || x.isFlagged != y.isFlagged) return false;
+        }
+    }
+    return true;
+}
+
+//第index局的脚本：首次点击中央，之后按固定的步长在棋盘上跳着翻开、插旗、撤销和重做，会话和直接执行的模型使用同一份脚本
+template <typename Commands>
+void playScript(Commands &commands, int index) {
+    commands.startNewGame(kRows, kCols, kMines, quint64(1000 + index));
+    commands.revealCellRequest(kRows / 2, kCols / 2);
+    for (int k = 1; k <= 40; ++k) {
+        const int cell = (k * 37 + index) % (kRows * kCols);
+        if (k % 5 == 0) commands.toggleFlagRequest(cell / kCols, cell % kCols);
+        else if (k % 7 == 0) commands.undoRequest();
+        else if (k % 11 == 0) commands.redoRequest();
+        else commands.revealCellRequest(cell / kCols, cell % kCols);
+    }
+}
+
+//把GameModel包装成与GameSession相同的命令接口，供playScript直接执行
+struct DirectCommands {
+    GameModel &model;
+    void startNewGame(int rows, int cols, int mines, quint64 seed) { model.startGame(rows, cols, mines, seed); }
+    void revealCellRequest(int row, int col) { model.revealCell(row, col); }
+    void toggleFlagRequest(int row, int col) { model.flagCell(row, col); }
+    void undoRequest() { model.undo(); }
+    void redoRequest() { model.redo(); }
+};
+
+//记录观察者收到的全部结果
+class RecordingObserver : public ISessionObserver {
+public:
+    struct Event {
+        char kind = 0;  //'g'新的一局，'c'格子改变，'h'提示
+        std::vector<int> cells;
+        GameState state = GameState::Ready;
+        int row = -1;
+        int col = -1;
+    };
+
+    void onNewGame(GameSession &, const Board &board) override {
+        QMutexLocker locker(&m_mutex);
+        m_events.push_back({'g', {}, board.getGameState()});
+    }
+
+    void onCellsChanged(GameSession &, const Board &board, const std::vector<int> &cells) override {
+        QMutexLocker locker(&m_mutex);
+        m_events.push_back({'c', cells, board.getGameState()});
+    }
+
+    void onHint(GameSession &, int row, int col, bool) override {
+        QMutexLocker locker(&m_mutex);
+        m_events.push_back({'h', {}, GameState::Ready, row, col});
+    }
+
+    std::vector<Event> events() {
+        QMutexLocker locker(&m_mutex);
+        return m_events;
+    }
+
+private:
+    QMutex m_mutex;
+    std::vector<Event> m_events;
+};
+}
+
+//测试用例：外部线程和工作线程提交的任务都被执行，waitForIdle返回时一个不少
+void TestSessionHost::testPoolRunsEveryTask() {
+    std::atomic<int> executed{0};
+    {
+        WorkStealingPool pool(4);
+        QCOMPARE(pool.getThreadCount(), 4);
+        for (int i = 0; i < 1000; ++i) {
+            pool.submit([&pool, &executed]() {
+                //每个任务再提交几个子任务，它们进入当前工作线程自己的队列，空闲的线程会来窃取
+                for (int k = 0; k < 4; ++k) pool.submit([&executed]() { executed.fetch_add(1); });
+                executed.fetch_add(1);
+            });
+        }
+        pool.waitForIdle();
+        QCOMPARE(executed.load(), 5000);
+        QCOMPARE(pool.stats().executed, std::uint64_t(5000));
+
+        //析构时执行完剩下的任务
+        for (int i = 0; i < 100; ++i) pool.submit([&executed]() { executed.fetch_add(1); });
+    }
+    QCOMPARE(executed.load(), 5100);
+}
+
+//测试用例：多个线程同时向各自的Strand提交任务，每个Strand的任务按顺序执行且从不重叠
+void TestSessionHost::testStrandRunsTasksInOrder() {
+    constexpr int kStrands = 8;
+    constexpr int kTasks = 2000;
+    WorkStealingPool pool(4);
+    std::vector<std::unique_ptr<Strand>> strands;
+    std::vector<std::vector<int>> order(kStrands);
+    std::vector<std::unique_ptr<std::atomic<bool>>> running;
+    std::atomic<bool> overlapped{false};
+    for (int s = 0; s < kStrands; ++s) {
+        strands.push_back(std::make_unique<Strand>(pool));
+        running.push_back(std::make_unique<std::atomic<bool>>(false));
+    }
+
+    std::vector<std::thread> posters;
+    for (int s = 0; s < kStrands; ++s) {
+        posters.emplace_back([&, s]() {
+            for (int i = 0; i < kTasks; ++i) {
+                strands[s]->post([&, s, i]() {
+                    if (running[s]->exchange(true)) overlapped = true;
+                    order[s].push_back(i);  //不加锁：同一个Strand的任务从不同时执行
+                    running[s]->store(false);
+                });
+            }
+        });
+    }
+    for (std::thread &poster : posters) poster.join();
+    pool.waitForIdle();
+
+    QVERIFY(!overlapped.load());
+    for (int s = 0; s < kStrands; ++s) {
+        QCOMPARE(int(order[s].size()), kTasks);
+        for (int i = 0; i < kTasks; ++i) QCOMPARE(order[s][i], i);
+    }
+}
+
+//测试用例：一批任务中的第一个还在执行时析构Strand，这一批中剩下的任务和之后提交的任务都不会执行
+void TestSessionHost::testStrandDestructionSkipsBacklog() {
+    WorkStealingPool pool(1);
+    auto strand = std::make_unique<Strand>(pool);
+    std::atomic<bool> posted{false};
+    std::atomic<bool> started{false};
+    std::atomic<bool> release{false};
+    std::atomic<int> executed{0};
+
+    //先占住唯一的工作线程，保证下面所有任务提交完之后drain才开始，它们会被同一次drain全部取走
+    pool.submit([&posted]() {
+        while (!posted) std::this_thread::yield();
+    });
+    strand->post([&]() {
+        started = true;
+        while (!release) std::this_thread::yield();
+    });
+    for (int i = 0; i < 3 * int(Strand::kBatchSize); ++i) {
+        strand->post([&executed]() { executed.fetch_add(1); });
+    }
+    posted = true;
+    while (!started) std::this_thread::yield();
+
+    //第一个任务还在执行时开始析构，析构函数等待它结束；稍后再放行它
+    std::thread releaser([&release]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        release = true;
+    });
+    strand.reset();
+    releaser.join();
+    pool.waitForIdle();
+    QCOMPARE(executed.load(), 0);
+}
+
+//测试用例：256局同时在4个线程上执行，每一局的结果都与在本线程中直接执行同一份脚本的结果相同
+void TestSessionHost::testSessionsMatchDirectModel() {
+    constexpr int kSessions = 256;
+    SessionHost host(4);
+    std::vector<GameSession *> sessions;
+    for (int i = 0; i < kSessions; ++i) sessions.push_back(&host.openSession());
+    QCOMPARE(host.getSessionCount(), kSessions);
+
+    //逐个会话提交整局的命令：前面的会话已经在工作线程中执行时，后面的会话还在提交
+    for (int i = 0; i < kSessions; ++i) playScript(*sessions[i], i);
+    host.waitForIdle();
+
+    for (int i = 0; i < kSessions; ++i) {
+        GameModel expected;
+        DirectCommands direct{expected};
+        playScript(direct, i);
+
+        bool same = false;
+        sessions[i]->post([&](GameModel &model) { same = sameBoard(model.board(), expected.board()); });
+        host.waitForIdle();
+        QVERIFY(same);
+        QCOMPARE(sessions[i]->getCommandCount(), quint64(43));  //开局、首次点击、40步脚本和上面的比较
+    }
+    QVERIFY(host.poolStats().executed > 0);
+}
+
+//测试用例：观察者收到的结果与命令一一对应
+void TestSessionHost::testObserverReceivesResults() {
+    SessionHost host(2);
+    RecordingObserver observer;
+    GameSession &session = host.openSession(&observer);
+    session.startNewGame(9, 9, 10, 42);
+    session.revealCellRequest(4, 4);
+    session.toggleFlagRequest(4, 4);  //已经翻开的格子不能插旗，没有结果
+    session.hintRequest();
+    host.waitForIdle();
+
+    GameModel expected;
+    expected.startGame(9, 9, 10, 42);
+    expected.revealCell(4, 4);
+    const std::vector<int> revealed = expected.board().getChangedCells();
+
+    const std::vector<RecordingObserver::Event> events = observer.events();
+    QCOMPARE(int(events.size()), 3);
+    QCOMPARE(events[0].kind, 'g');
+    QCOMPARE(events[1].kind, 'c');
+    QCOMPARE(events[1].cells, revealed);
+    QCOMPARE(events[1].state, expected.getGameState());
+    QCOMPARE(events[2].kind, 'h');
+    if (expected.getGameState() == GameState::Playing) {
+        QVERIFY(events[2].row >= 0);
+        QVERIFY(!expected.getCell(events[2].row, events[2].col).isRevealed);
+    }
+}
+
+//测试用例：关闭一个命令很多的会话时，后面的命令被丢弃，其他会话照常执行完
+void TestSessionHost::testCloseSessionDiscardsPending() {
+    SessionHost host(1);
+    std::atomic<int> executed{0};
+    GameSession &busy = host.openSession();
+    GameSession &other = host.openSession();
+    const int busyId = busy.getId();
+    for (int i = 0; i < 10000; ++i) {
+        busy.post([&executed](GameModel &) {
+            executed.fetch_add(1);
+            std::this_thread::yield();
+        });
+    }
+    other.startNewGame(9, 9, 10, 7);
+    other.revealCellRequest(0, 0);
+
+    host.closeSession(busyId);
+    QCOMPARE(host.getSessionCount(), 1);
+    QVERIFY(host.findSession(busyId) == nullptr);
+    host.waitForIdle();
+    QVERIFY(executed.load() < 10000);
+    QCOMPARE(other.getCommandCount(), quint64(2));
+    host.closeSession(busyId);  //再次关闭不存在的会话什么也不做
+}
+
+//测试用例：客户端通过本地套接字发送命令，收到对应的回复
+void TestSessionHost::testSocketRoundTrip() {
+    SessionHost host(2);
+    SessionServer server(host);
+    const QString name = QStringLiteral("minesweeper-test-%1").arg(QCoreApplication::applicationPid());
+    QVERIFY(server.listen(name));
+
+    QLocalSocket client;
+    client.connectToServer(name);
+    QVERIFY(client.waitForConnected());
+    QTRY_COMPARE(server.getConnectionCount(), 1);
+
+    client.write("new 9 9 10 42\nr 4 4\nh\nbogus 1\nnew 0 9 10\n");
+    //三条命令各有一行回复，两条错误的命令各有一行错误
+    QList<QByteArray> lines;
+    const auto receive = [&]() {
+        while (client.canReadLine()) lines.append(client.readLine().trimmed());
+        return lines.size();
+    };
+    QTRY_COMPARE(receive(), 5);
+
+    GameModel expected;
+    expected.startGame(9, 9, 10, 42);
+    expected.revealCell(4, 4);
+    const QByteArray state = expected.getGameState() == GameState::Won ? "won" : "playing";
+
+    bool game = false, cells = false, hint = false;
+    int errors = 0;
+    for (const QByteArray &line : lines) {
+        const QList<QByteArray> fields = line.split(' ');
+        if (line == "game 9 9 10") game = true;
+        if (fields[0] == "cells") {
+            //回复中的格子与直接执行时改变的格子一一对应，每个格子三个字段
+            cells = fields[1] == state && fields[2] == "10"
+                    && fields[3].toInt() == int(expected.board().getChangedCells().size())
+                    && fields.size() == 4 + 3 * fields[3].toInt();
+        }
+        if (fields[0] == "hint") hint = fields.size() == 4;
+        if (fields[0] == "error") ++errors;
+    }
+    QVERIFY(game);
+    QVERIFY(cells);
+    QVERIFY(hint);
+    QCOMPARE(errors, 2);
+
+    //断开后服务器关闭这个连接的会话
+    client.disconnectFromServer();
+    QTRY_COMPARE(server.getConnectionCount(), 0);
+    QTRY_COMPARE(host.getSessionCount(), 0);
+}
+
+QTEST_GUILESS_MAIN(TestSessionHost)  //这个宏为测试类自动生成一个main函数，使其可以独立运行
+#include "TestSessionHost.moc"  //必须包含由MOC（元对象编译器）为该文件生成的代码
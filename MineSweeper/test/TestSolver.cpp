@@ -0,0 +1,187 @@
+#include <QTest>  //包含Qt测试框架的核心头文件
+#include "../src/Core/Solver.h"  //包含被测试的Solver类
+#include "../src/Core/NoGuessGenerator.h"  //包含使用求解器验证布局的不需要猜的棋盘生成器
+
+//Solver的测试类
+//求解器不读取地雷位置，所以可以用Board中真实的地雷位置检查它的每一个结论
+class TestSolver : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testDeductionsAreSound();          //测试推理出的安全格子和地雷格子都与真实棋盘一致
+    void testIncrementalMatchesReset();     //测试增量推理的结果与从头推理的结果完全相同
+    void testProbabilitiesSumToMineCount(); //测试所有格子的地雷概率之和等于地雷总数
+    void testSolvesExpertBoards();          //测试按提示玩高级棋盘时能赢下相当一部分对局（耗时见BenchModel的benchSolveWithHints）
+    void testNoGuessBoardsNeedNoGuessing(); //测试NoGuess策略生成的棋盘只靠确定的推理就能赢
+    void testNoGuessIsDeterministic();      //测试不需要猜的布局只由种子决定，与生成时使用的线程数无关
+    void testNoGuessFallsBackOnHugeBoards(); //测试生成器应付不了的棋盘上NoGuess退回SafeArea
+    void testNoGuessReportsUncertified();   //测试找不到不需要猜的布局时，Board报告布局没有经过验证
+    void testNoGuessCancel();               //测试布雷被取消时首次翻开什么也不做，棋盘仍处于准备状态
+};
+
+//按提示走一局，每走一步调用一次check；返回对局结果
+template <typename Check>
+static GameState playWithHints(Board &board, Solver &solver, Check &&check) {
+    solver.reset(board);
+    while (board.getGameState() == GameState::Ready || board.getGameState() == GameState::Playing) {
+        const Solver::Hint hint = solver.hint(board);
+        if (hint.row < 0) break;
+        check(hint);
+        board.revealCell(hint.row, hint.col);
+        solver.update(board, board.getChangedCells());
+    }
+    return board.getGameState();
+}
+
+//测试用例：求解器得出的每一个确定结论都必须正确
+void TestSolver::testDeductionsAreSound() {
+    for (quint64 seed = 0; seed < 50; ++seed) {
+        Board board;
+        Solver solver;
+        board.startGame(16, 16, 40, seed);
+        playWithHints(board, solver, [&](const Solver::Hint &hint) {
+            if (hint.certain && board.getGameState() == GameState::Playing) {
+                QVERIFY(!board.getCell(hint.row, hint.col).isMine);
+            }
+            for (int r = 0; r < 16; ++r) {
+                for (int c = 0; c < 16; ++c) {
+                    const Solver::Knowledge knowledge = solver.knowledge(r, c);
+                    if (knowledge == Solver::Knowledge::Mine) QVERIFY(board.getCell(r, c).isMine);
+                    if (knowledge == Solver::Knowledge::Safe) QVERIFY(!board.getCell(r, c).isMine);
+                }
+            }
+        });
+    }
+}
+
+//测试用例：每一步之后，增量维护的结论都不少于从头推理的结论
+void TestSolver::testIncrementalMatchesReset() {
+    for (quint64 seed = 100; seed < 120; ++seed) {
+        Board board;
+        Solver solver;
+        board.startGame(16, 30, 99, seed, FirstClickPolicy::SafeArea);
+        playWithHints(board, solver, [&](const Solver::Hint &) {
+            Solver fresh;
+            fresh.reset(board);
+            for (int r = 0; r < 16; ++r) {
+                for (int c = 0; c < 30; ++c) {
+                    //增量求解器还可能保留了精确枚举得到的结论，所以只要求从头推理得到的结论它都有
+                    if (fresh.knowledge(r, c) != Solver::Knowledge::Unknown) {
+                        QCOMPARE(solver.knowledge(r, c), fresh.knowledge(r, c));
+                    }
+                }
+            }
+        });
+    }
+}
+
+//测试用例：概率是精确的，所以所有格子的地雷概率之和（期望地雷数）一定等于地雷总数
+void TestSolver::testProbabilitiesSumToMineCount() {
+    for (quint64 seed = 200; seed < 220; ++seed) {
+        Board board;
+        Solver solver;
+        board.startGame(16, 30, 99, seed, FirstClickPolicy::SafeArea);
+        board.revealCell(8, 15);
+        solver.reset(board);
+
+        std::vector<double> probabilities;
+        solver.computeProbabilities(board, probabilities);
+        double sum = 0.0;
+        for (double probability : probabilities) {
+            QVERIFY(probability >= 0.0 && probability <= 1.0);
+            sum += probability;
+        }
+        QVERIFY(qAbs(sum - 99.0) < 1e-6);
+    }
+}
+
+//测试用例：高级棋盘（16x30，99颗雷）上按提示玩100局
+void TestSolver::testSolvesExpertBoards() {
+    int wins = 0;
+    for (quint64 seed = 0; seed < 100; ++seed) {
+        Board board;
+        Solver solver;
+        board.startGame(16, 30, 99, seed, FirstClickPolicy::SafeArea);
+        wins += playWithHints(board, solver, [](const Solver::Hint &) {}) == GameState::Won;
+    }
+    //按概率最优的方式猜雷，高级棋盘的胜率大约在一半左右，远高于随机乱点
+    QVERIFY(wins >= 30);
+}
+
+//测试用例：NoGuess策略下从首次点击开始，求解器的每一步提示都是确定安全的，并且最终获胜
+void TestSolver::testNoGuessBoardsNeedNoGuessing() {
+    for (quint64 seed = 0; seed < 20; ++seed) {
+        Board board;
+        Solver solver;
+        board.startGame(16, 30, 99, seed, FirstClickPolicy::NoGuess);
+        //QVERIFY在lambda中失败只会从lambda返回，所以先记下来，走完这一局再检查
+        bool allCertain = true;
+        const GameState result = playWithHints(board, solver, [&](const Solver::Hint &hint) {
+            allCertain = allCertain && hint.certain;
+        });
+        QVERIFY(allCertain);
+        QCOMPARE(result, GameState::Won);
+        QCOMPARE(board.getFirstClickPolicy(), FirstClickPolicy::NoGuess);
+        QCOMPARE(board.getSeed(), seed);
+    }
+}
+
+//测试用例：同样的参数和种子，单线程和多线程生成的布局逐位相同
+void TestSolver::testNoGuessIsDeterministic() {
+    for (quint64 seed = 0; seed < 10; ++seed) {
+        NoGuessGenerator serial(16, 30, 99, 8, 15, seed);
+        serial.setThreadCount(1);
+        NoGuessGenerator parallel(16, 30, 99, 8, 15, seed);
+        parallel.setThreadCount(4);
+        const NoGuessGenerator::Result expected = serial.generate();
+        QVERIFY(expected.certified);
+        QVERIFY(expected.isMine == parallel.generate().isMine);
+    }
+}
+
+//测试用例：新游戏对话框中Huge预设那样的棋盘上，NoGuess直接退回SafeArea，首次翻开不会长时间生成
+void TestSolver::testNoGuessFallsBackOnHugeBoards() {
+    QVERIFY(NoGuessGenerator::canGenerate(16, 30, 99));
+    QVERIFY(!NoGuessGenerator::canGenerate(1000, 1000, 200000));
+    QVERIFY(!NoGuessGenerator::canGenerate(45, 45, 1035));  //格子不多但地雷很密
+
+    Board board;
+    board.startGame(1000, 1000, 200000, 3, FirstClickPolicy::NoGuess);
+    QCOMPARE(board.getFirstClickPolicy(), FirstClickPolicy::SafeArea);
+    QVERIFY(board.revealCell(500, 500));
+    QCOMPARE(board.getCell(500, 500).adjacentMines, 0);  //SafeArea的首次点击周围3x3没有雷
+    QVERIFY(!board.isLayoutCertified());
+}
+
+//测试用例：3x3的棋盘点击中央时放不下任何雷，生成器只能退回普通布局，并如实报告
+void TestSolver::testNoGuessReportsUncertified() {
+    Board board;
+    board.startGame(3, 3, 1, 5, FirstClickPolicy::NoGuess);
+    QVERIFY(board.revealCell(1, 1));
+    QCOMPARE(board.getGameState(), GameState::Playing);
+    QCOMPARE(board.getFirstClickPolicy(), FirstClickPolicy::NoGuess);
+    QVERIFY(!board.isLayoutCertified());
+
+    board.startGame(16, 30, 99, 5, FirstClickPolicy::NoGuess);
+    QVERIFY(board.revealCell(8, 15));
+    QVERIFY(board.isLayoutCertified());
+}
+
+//测试用例：取消标志已经置位时，NoGuess的首次翻开不布雷也不翻开；清除之后照常进行
+void TestSolver::testNoGuessCancel() {
+    std::atomic<bool> cancel{true};
+    Board board;
+    board.setGeneratorCancelFlag(&cancel);
+    board.startGame(16, 30, 99, 5, FirstClickPolicy::NoGuess);
+    QVERIFY(!board.revealCell(8, 15));
+    QCOMPARE(board.getGameState(), GameState::Ready);
+    QVERIFY(!board.getCell(8, 15).isRevealed);
+
+    cancel = false;
+    QVERIFY(board.revealCell(8, 15));
+    QCOMPARE(board.getGameState(), GameState::Playing);
+    QVERIFY(board.isLayoutCertified());
+}
+
+QTEST_MAIN(TestSolver)  //这个宏为测试类自动生成一个main函数，使其可以独立运行
+#include "TestSolver.moc"  //必须包含由MOC（元对象编译器）为该文件生成的代码